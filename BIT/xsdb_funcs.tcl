@@ -179,6 +179,15 @@ proc read_clock {reg} {
     return $float_clock
 }
 
+# Read a list of clock counters and return their frequency values
+proc read_clocks {regs} {
+    set clocks {}
+    foreach reg $regs {
+        lappend clocks [format "%.3f" [read_clock $reg]]
+    }
+    return $clocks
+}
+
 # Print a message on the console
 proc print_console {uart0 message} {
     foreach char [split $message ""] {
@@ -1 +0,0 @@
-SIT95211.py
\ No newline at end of file
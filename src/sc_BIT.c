@@ -58,9 +58,10 @@ Clocks_Check(void *Arg1, void *Arg2)
 {
 	BIT_t *BIT_p = Arg1;
 	__attribute__((unused)) void *Ignore = Arg2;
-	int FD;
 	Clocks_t *Clocks;
-	char ReadBuffer[STRLEN_MAX];
+	Sysfs_Attr_t Attrs[ITEMS_MAX];
+	int Numbers = 0;
+	char ReadBuffer[ITEMS_MAX][STRLEN_MAX];
 	char Result[STRLEN_MAX];
 	double Freq, Lower, Upper, Delta;
 
@@ -72,26 +73,34 @@ Clocks_Check(void *Arg1, void *Arg2)
 		return -1;
 	}
 
+	/* Read the frequencies of all clocks in one batch */
 	for (int i = 0; i < Clocks->Numbers; i++) {
+		if (!Clocks->Clock[i].Vendor_Managed) {
+			Attrs[Numbers].Path = Clocks->Clock[i].Sysfs_Path;
+			Attrs[Numbers].Buffer = ReadBuffer[Numbers];
+			Attrs[Numbers].Length = STRLEN_MAX;
+			Numbers++;
+		}
+	}
+
+	(void) Sysfs_Read(Attrs, Numbers);
+	for (int i = 0, j = 0; i < Clocks->Numbers; i++) {
 		if (Clocks->Clock[i].Vendor_Managed) {
 			continue;
 		}
 
 		SC_INFO("Clock: %s", Clocks->Clock[i].Name);
-		FD = open(Clocks->Clock[i].Sysfs_Path, O_RDONLY);
-		ReadBuffer[0] = '\0';
-		if (read(FD, ReadBuffer, sizeof(ReadBuffer)-1) == -1) {
+		if (Attrs[j++].Count < 0) {
 			SC_ERR("failed to access clock %s",
 			       Clocks->Clock[i].Name);
 			(void) sprintf(Result, "%s: FAIL", BIT_p->Name);
 			Record_BIT_Log(Result);
-			(void) close(FD);
 			return -1;
 		}
-		(void) close(FD);
+
 		/* Allow up to 1000 Hz delta */
 		Delta = 0.001;
-		Freq = strtod(ReadBuffer, NULL) / 1000000.0;	// In MHz
+		Freq = strtod(ReadBuffer[j - 1], NULL) / 1000000.0;	// In MHz
 		Lower = Clocks->Clock[i].Default_Freq - Delta;
 		Upper = Clocks->Clock[i].Default_Freq + Delta;
 		if (Freq < Lower || Freq > Upper) {
@@ -216,7 +225,7 @@ EBM_EEPROM_Check(void *Arg1, __attribute__((unused)) void *Arg2)
 		return -1;
 	}
 
-	FD = open(Daughter_Card->I2C_Bus, O_RDWR);
+	FD = I2C_Open(Daughter_Card->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("unable to open I2C bus %s: %m", Daughter_Card->I2C_Bus);
 		(void) sprintf(Result, "%s: FAIL", BIT_p->Name);
@@ -224,7 +233,7 @@ EBM_EEPROM_Check(void *Arg1, __attribute__((unused)) void *Arg2)
 		return -1;
 	}
 
-	if (ioctl(FD, I2C_SLAVE_FORCE, Daughter_Card->I2C_Address) < 0) {
+	if (I2C_Set_Address(FD, Daughter_Card->I2C_Address) < 0) {
 		SC_ERR("failed to configure I2C bus for access to "
 		       "device address %#x: %m", Daughter_Card->I2C_Address);
 		(void) sprintf(Result, "%s: FAIL", BIT_p->Name);
@@ -233,7 +242,7 @@ EBM_EEPROM_Check(void *Arg1, __attribute__((unused)) void *Arg2)
 		return -1;
 	}
 
-	if (read(FD, Buffer, 1) != 1) {
+	if (I2C_Raw_Read(FD, Buffer, 1) != 1) {
 		SC_ERR("unable to access EEPROM device %#x",
 		       Daughter_Card->I2C_Address);
 		(void) sprintf(Result, "%s: FAIL", BIT_p->Name);
@@ -275,7 +284,7 @@ DIMM_EEPROM_Check(void *Arg1, __attribute__((unused)) void *Arg2)
 	for (int i = 0; i < DIMMs->Numbers; i++) {
 		DIMM = &DIMMs->DIMM[i];
 		SC_INFO("DIMM: %s", DIMM->Name);
-		FD = open(DIMM->I2C_Bus, O_RDWR);
+		FD = I2C_Open(DIMM->I2C_Bus);
 		if (FD < 0) {
 			SC_ERR("unable to open I2C bus %s: %m", DIMM->I2C_Bus);
 			(void) sprintf(Result, "%s: FAIL", BIT_p->Name);
@@ -26,7 +26,7 @@
 #define XLSTRLEN_MAX	256
 #define XXLSTRLEN_MAX	512
 #define SYSCMD_MAX	1024
-#define SOCKBUF_MAX	(4 * SYSCMD_MAX)
+#define SOCKBUF_MAX	(8 * SYSCMD_MAX)
 
 #define INSTALLDIR	"/usr/share/system-controller-app"
 #define SOCKFILE	Appfile("socket")
@@ -38,6 +38,8 @@
 #define IDT8A34001FILE	Appfile("8A34001")
 #define PDIFILE		Appfile("PDI")
 #define BITLOGFILE	Appfile("BIT.log")
+#define CAPTUREFILE	Appfile("capture.bin")
+#define PROFILEFILE	Appfile("profile")
 #define VENDORCLOCKDIR	Appfile("vendor_clock")
 
 #define BIT_PATH	INSTALLDIR"/BIT/"
@@ -53,7 +55,7 @@
 
 #define SC_INFO(msg, ...) fprintf(stdout, msg "\n", ##__VA_ARGS__);
 #define SC_ERR(msg, ...) do { \
-		extern int Client_FD; \
+		extern __thread int Client_FD; \
 		extern char Sock_OutBuffer[]; \
 		fprintf(stderr, "ERROR: " msg "\n", ##__VA_ARGS__); \
 		if (Client_FD) { \
@@ -62,7 +64,7 @@
 		} \
 	} while (0)
 #define SC_PRINT(msg, ...) do { \
-		extern int Client_FD; \
+		extern __thread int Client_FD; \
 		extern char Sock_OutBuffer[]; \
 		fprintf(stdout, msg "\n", ##__VA_ARGS__); \
 		if (Client_FD) { \
@@ -71,7 +73,7 @@
 		} \
 	} while (0)
 #define SC_PRINT_N(msg, ...) do { \
-		extern int Client_FD; \
+		extern __thread int Client_FD; \
 		extern char Sock_OutBuffer[]; \
 		fprintf(stdout, msg, ##__VA_ARGS__); \
 		if (Client_FD) { \
@@ -158,6 +160,12 @@ typedef struct {
 	int	Shunt_Resistor;
 	int	Maximum_Current;
 	int	Phase_Multiplier;
+	int	Averages;		/* 0 for the power-on default */
+	int	Bus_Conversion_Time;	/* in micro-seconds, 0 for default */
+	int	Shunt_Conversion_Time;	/* in micro-seconds, 0 for default */
+	char	*Alert_Line;		/* GPIO line of the alert pin, if any */
+	int	Alert_Mask;		/* 'Mask/Enable' register, 0 if unused */
+	int	Alert_Limit;		/* 'Alert Limit' register */
 } INA226_t;
 
 typedef struct INA226s {
@@ -182,6 +190,33 @@ typedef struct Power_Domains {
 /*
  * Voltages
  */
+
+/* VOUT data format, from bits [6:5] of VOUT_MODE */
+typedef enum {
+	PMBUS_FORMAT_LINEAR16,
+	PMBUS_FORMAT_VID,
+	PMBUS_FORMAT_DIRECT,
+	PMBUS_FORMAT_IEEE_HALF,
+} PMBus_Format;
+
+/* Capabilities of a PMBus regulator page, probed once */
+typedef struct {
+	bool		Probed;
+	PMBus_Format	Format;
+	bool		Relative;	/* limits are relative to VOUT */
+	bool		Fixed_Limits;	/* limits are not adjusted with VOUT */
+	int		Exponent;	/* of LINEAR16 */
+	float		VID_Base;	/* voltage of VID code 1 */
+	float		VID_Step;	/* of VID, Step is 0 if unknown */
+	int		M;		/* coefficients of DIRECT, M is 0 if unknown */
+	int		B;
+	int		R;
+	int		Revision;	/* PMBUS_REVISION, or -1 */
+	char		MFR_ID[STRLEN_MAX];
+	char		MFR_Model[STRLEN_MAX];
+	unsigned int	Telemetry;	/* mask of supported PMBus_Telemetry_Id */
+} PMBus_Caps_t;
+
 typedef struct {
 	char	*Name;
 	char	*Part_Name;
@@ -193,6 +228,9 @@ typedef struct {
 	int	Voltage_Multiplier;
 	char	*I2C_Bus;
 	int	I2C_Address;
+	char	*SMBALERT_Line;
+	int	Phases;		/* of a multi-phase controller, or 0 */
+	PMBus_Caps_t	PMBus_Caps;
 } Voltage_t;
 
 typedef struct Voltages {
@@ -416,6 +454,86 @@ typedef struct Constraints {
 	Constraint_t	Constraint[LITEMS_MAX];
 } Constraints_t;
 
+/*
+ * I2C Buses
+ */
+typedef struct {
+	char	*I2C_Bus;
+	char	*Recovery;
+	char	*Recovery_Target;
+} I2C_Bus_t;
+
+typedef struct I2C_Buses {
+	int	Numbers;
+	I2C_Bus_t	Bus[ITEMS_MAX];
+} I2C_Buses_t;
+
+/*
+ * Derived Sensors
+ */
+typedef struct Derived_Program Derived_Program_t;
+
+typedef struct {
+	char	*Name;
+	char	*Expression;
+	Derived_Program_t *Program;
+} Derived_t;
+
+typedef struct Deriveds {
+	int	Numbers;
+	Derived_t	Derived[ITEMS_MAX];
+} Deriveds_t;
+
+/*
+ * Operating Profiles
+ */
+typedef struct {
+	char	*Target;	// clock or voltage
+	double	Value;		// MHz or V
+} Setting_t;
+
+typedef struct {
+	char	*Name;
+	int	Numbers;
+	Setting_t	Setting[LITEMS_MAX];
+} Profile_t;
+
+typedef struct Profiles {
+	int	Numbers;
+	Profile_t	Profile[ITEMS_MAX];
+} Profiles_t;
+
+/*
+ * Power Sequences
+ */
+typedef enum {
+	SEQUENCE_ENABLE,	// drive GPIO line high
+	SEQUENCE_DISABLE,	// drive GPIO line low
+	SEQUENCE_SETVOLTAGE,	// set and enable regulator
+	SEQUENCE_WAITGPIO,	// poll GPIO line for a level
+	SEQUENCE_WAITPGOOD,	// poll POWER_GOOD# of regulator
+	SEQUENCE_DELAY,
+	SEQUENCE_ACTIONS,
+} Sequence_Action;
+
+typedef struct {
+	Sequence_Action	Action;
+	char	*Target;	// GPIO line or regulator
+	double	Value;		// V, or level of GPIO line
+	int	Timeout;	// ms of a wait or a delay
+} Sequence_Step_t;
+
+typedef struct {
+	char	*Name;
+	int	Numbers;
+	Sequence_Step_t	Step[LITEMS_MAX];
+} Power_Sequence_t;
+
+typedef struct Power_Sequences {
+	int	Numbers;
+	Power_Sequence_t	Power_Sequence[ITEMS_MAX];
+} Power_Sequences_t;
+
 /*
  * Board-specific Devices
  */
@@ -440,8 +558,113 @@ typedef struct {
 	BITs_t		*BITs;
 	Constraints_t	*Constraints;
 	Default_PDI_t	*Default_PDI;
+	I2C_Buses_t	*I2C_Buses;
+	Deriveds_t	*Deriveds;
+	Profiles_t	*Profiles;
+	Power_Sequences_t	*Power_Sequences;
 } Plat_Devs_t;
 
+/*
+ * I2C Transaction Sequences
+ */
+#define I2C_OP_DATA_MAX	STRLEN_MAX
+
+typedef enum {
+	I2C_PRIORITY_INTERACTIVE,
+	I2C_PRIORITY_BACKGROUND,
+	I2C_PRIORITIES,
+} I2C_Priority;
+
+typedef enum {
+	I2C_OP_READ,
+	I2C_OP_WRITE,
+} I2C_Op_Type;
+
+typedef struct {
+	I2C_Op_Type	Type;
+	int		Address;
+	int		Out_Length;
+	int		In_Length;
+	unsigned char	Out[I2C_OP_DATA_MAX];
+	unsigned char	In[I2C_OP_DATA_MAX];
+	bool		Skip;
+} I2C_Op_t;
+
+typedef struct I2C_Sequence {
+	char		*I2C_Bus;
+	I2C_Priority	Priority;
+	int		Numbers;
+	I2C_Op_t	Op[ITEMS_MAX];
+	int		(*Op_Done)(struct I2C_Sequence *, int);
+	void		(*Done)(struct I2C_Sequence *);
+	void		*Data;
+	int		Status;
+	int		Errno;
+	int		Failed_Op;
+	bool		Quiet;		/* failures are reported by the caller */
+	bool		Completed;
+	struct I2C_Sequence *Next;
+} I2C_Sequence_t;
+
+/*
+ * I2C Bus Statistics
+ */
+typedef enum {
+	I2C_BUS_HEALTHY,
+	I2C_BUS_DEGRADED,
+	I2C_BUS_FAILED,
+	I2C_BUS_PROBING,
+} I2C_Bus_State;
+
+typedef struct {
+	int		Bus;
+	unsigned long	Transactions;
+	unsigned long	Errors;
+	unsigned long	Busy_Time;	/* us */
+	float		Utilization;	/* % over the last second */
+	float		Background;	/* % over the last second */
+	I2C_Bus_State	State;
+	unsigned long	Recoveries;
+} I2C_Stats_t;
+
+/* Attribute read by Sysfs_Read() */
+typedef struct {
+	const char	*Path;
+	int		FD;
+	char		*Buffer;
+	int		Length;
+	int		Count;
+} Sysfs_Attr_t;
+
+/* Called with the timestamp, in nano-seconds, of an edge on a watched line */
+typedef void (*GPIO_Handler_t)(void *, unsigned long long);
+
+/* Operations of the device driver registry */
+typedef enum {
+	DRIVER_INA226_REGISTERS,
+	DRIVER_INA226_POWER,
+	DRIVER_INA226_SHUNT,
+	DRIVER_INA226_CALIBRATION,
+	DRIVER_PMBUS_VOUT,
+	DRIVER_PMBUS_TELEMETRY,
+	DRIVER_JC42_TEMPERATURE,
+	DRIVER_OPS,
+} Driver_Op_Id;
+
+/* Results of DRIVER_PMBUS_TELEMETRY */
+typedef enum {
+	PMBUS_TELEMETRY_VOUT_MODE,
+	PMBUS_TELEMETRY_VIN,
+	PMBUS_TELEMETRY_VOUT,
+	PMBUS_TELEMETRY_IOUT,
+	PMBUS_TELEMETRY_TEMPERATURE,
+	PMBUS_TELEMETRY_POUT,
+	PMBUS_TELEMETRY_PIN,
+	PMBUS_TELEMETRIES,
+} PMBus_Telemetry_Id;
+
+typedef struct Driver_Plan Driver_Plan_t;
+
 #define I2C_READ_BYTES(FD, Address, OutLen, InLen, Out, In, Return) \
 { \
 	struct i2c_msg Msgs[2]; \
@@ -456,7 +679,7 @@ typedef struct {
 	Msgs[1].buf = (__u8 *)(In); \
 	Msgset[0].msgs = Msgs; \
 	Msgset[0].nmsgs = 2; \
-	if (ioctl((FD), I2C_RDWR, &Msgset) < 0) { \
+	if (I2C_Transfer((FD), Msgset) < 0) { \
 		SC_ERR("unable to read from I2C device %#x: %m", (Address)); \
 		(Return) = -1; \
 	} \
@@ -469,24 +692,38 @@ typedef struct {
 
 #define I2C_WRITE(FD, Address, Len, Out, Return) \
 { \
-	if (ioctl((FD), I2C_SLAVE_FORCE, (Address)) < 0) { \
+	if (I2C_Set_Address((FD), (Address)) < 0) { \
 		SC_ERR("unable to access I2C device %#x: %m", (Address)); \
 		(Return) = -1; \
 	} \
-	if ((Return) == 0 && write((FD), (Out), (Len)) != (Len)) { \
+	if ((Return) == 0 && I2C_Raw_Write((FD), (Out), (Len)) != (Len)) { \
 		SC_ERR("unable to write to I2C device %#x: %m", (Address)); \
 		(Return) = -1; \
 	} \
 }
 
+#define PMBUS_PAGE			0x0
 #define PMBUS_OPERATION			0x1
+#define PMBUS_CLEAR_FAULTS		0x3
+#define PMBUS_PHASE			0x4
+#define PMBUS_QUERY			0x1A
 #define PMBUS_VOUT_MODE			0x20
 #define PMBUS_VOUT_COMMAND		0x21
+#define PMBUS_COEFFICIENTS		0x30
 #define PMBUS_VOUT_OV_FAULT_LIMIT	0x40
 #define PMBUS_VOUT_OV_WARN_LIMIT	0x42
 #define PMBUS_VOUT_UV_WARN_LIMIT	0x43
 #define PMBUS_VOUT_UV_FAULT_LIMIT	0x44
+#define PMBUS_STATUS_WORD		0x79
+#define PMBUS_READ_VIN			0x88
 #define PMBUS_READ_VOUT			0x8B
+#define PMBUS_READ_IOUT			0x8C
+#define PMBUS_READ_TEMPERATURE_1	0x8D
+#define PMBUS_READ_POUT			0x96
+#define PMBUS_READ_PIN			0x97
+#define PMBUS_REVISION			0x98
+#define PMBUS_MFR_ID			0x99
+#define PMBUS_MFR_MODEL			0x9A
 
 /*
  * Definitions for invoking xsdb.
@@ -503,6 +740,7 @@ typedef struct {
 #define DEFAULT_PDI	"system_wrapper.pdi"
 #define PROGRAM_8A34001	"8A34001_eeprom.py"
 #define READ_CLOCK_CMD	"read_clock"
+#define READ_CLOCKS_CMD	"read_clocks"
 #define LOAD_DEFAULT_PDI_CMD	"load_default_pdi"
 
 #define MAX(x, y)	(((x) > (y)) ? (x) : (y))
@@ -519,14 +757,31 @@ int Board_Identification(char *, char *);
 int Check_Config_File(char *, char *, int *);
 int Clocks_Check(void *, void *);
 int DDRMC_Test(void *, void *);
+int Derived_Compile(void);
+int Derived_Evaluate(int *, int, float *);
 int DIMM_EEPROM_Check(void *, void *);
 int Display_Instruction(void *, void *);
+int Driver_Compile(void);
+int Driver_Execute(Driver_Plan_t *, int, unsigned int *, float *);
+Driver_Plan_t *Driver_Plan(Driver_Op_Id, void *);
+PMBus_Caps_t *Driver_PMBus_Caps(Voltage_t *);
+float Driver_PMBus_Decode_Vout(const PMBus_Caps_t *, unsigned int);
+int Driver_PMBus_Encode_Vout(const PMBus_Caps_t *, float, unsigned int *);
+int Driver_PMBus_Phases(Voltage_t *, float *, float *);
+int Driver_PMBus_Probe(void);
+int Driver_PMBus_Read_Limit(Voltage_t *, int, unsigned char, float, float *);
+Driver_Plan_t *Driver_PMBus_Telemetry_Plan(Voltage_t *, int);
+void Driver_Quiet(bool);
+int Driver_Run(Driver_Plan_t *, unsigned int *, float *);
 int EBM_EEPROM_Check(void *, void *);
 int EEPROM_Common(char *);
 int EEPROM_Board(char *, int);
 int EEPROM_MultiRecord(char *, int);
 void FMC_Access(FMC_t *, bool);
 int FMCAutoVadj_Op(void);
+int Fault_Monitor_Start(void);
+int Fault_Print_Log(void);
+int Fault_Print_State(char *);
 int Get_BootMode(int);
 #if !defined (LIBGPIOD_V1)
 int Get_GPIO(char *, int *, enum gpiod_line_direction);
@@ -537,23 +792,64 @@ int Get_IDCODE(char *, int);
 int Get_IDT_8A34001(Clock_t *);
 int Get_Measured_Clock(char *, char *);
 int Get_Measured_Clock_Vendor(Clock_t *);
+int Get_Power(INA226_t *, int, float *, float *, float *);
 int Get_Silicon_Revision(char *);
+int Get_SiTime_Clock(Clock_t *);
 int Get_Temperature(Temperature_t *);
+bool GPIO_Line_Exists(const char *);
+int Hwmon_Get_Power(INA226_t *, float *, float *, float *);
+int Hwmon_Get_Telemetry(Voltage_t *, float *);
+int Hwmon_Get_Temperature(DIMM_t *, float *);
+int Hwmon_Get_Voltage(Voltage_t *, float *);
+int Hwmon_Init(void);
+bool I2C_Absent(const char *, int, const char *);
+int I2C_Background_Interval(const char *, int);
+int I2C_Bus_Generation(const char *);
+int I2C_Bus_Lock(const char *);
+int I2C_Bus_Number(const char *);
+void I2C_Bus_Unlock(const char *);
+int I2C_Get_Stats(I2C_Stats_t *, int);
+int I2C_Init(void);
+int I2C_Open(const char *);
+bool I2C_Op_Failed(const I2C_Sequence_t *, int);
+void I2C_Presence_Invalidate(const char *);
+ssize_t I2C_Raw_Read(int, void *, size_t);
+ssize_t I2C_Raw_Write(int, const void *, size_t);
+int I2C_Run(I2C_Sequence_t *);
+int I2C_Sequence_Add(I2C_Sequence_t *, I2C_Op_Type, int, int, const void *, int);
+int I2C_Set_Address(int, int);
+void I2C_Set_Presence(const char *, int, const char *, bool);
+int I2C_Submit(I2C_Sequence_t *);
+int I2C_Transfer(int, struct i2c_rdwr_ioctl_data *);
+int I2C_Wait(I2C_Sequence_t *);
 int Set_JTAGSelect(char *);
+long long Monotonic_Nanoseconds(void);
+void Monotonic_Sleep(long long);
 int Parse_JSON(const char *, Plat_Devs_t *);
+int Power_Sequence_List(void);
+int Power_Sequence_Run(const char *);
+int Profile_Apply(char *);
+int Profile_List(void);
+int Profile_Save(char *);
 int QSFP_ModuleSelect(SFP_t *, int);
+I2C_Sequence_t *Regulator_Set_Submit(Voltage_t *, float);
 int Reset_IDT_8A34001(void);
 int Reset_Op(void);
 int Restore_IDT_8A34001(Clock_t *);
+int Restore_SiTime_Clock(Clock_t *);
 int Set_AltBootMode(int);
 int Set_BootMode(BootMode_t *, int);
 int Set_GPIO(char *, int);
 int Set_IDT_8A34001(Clock_t *, char *, int);
+int Set_SiTime_Clock(Clock_t *, char *, int);
 int Shell_Execute(char *);
 int Silicon_Identification(char *, int);
+int Start_Watching_GPIOs(void);
+int Sysfs_Read(Sysfs_Attr_t *, int);
 int VCK190_QSFP_ModuleSelect(SFP_t *, int);
-int Vendor_Utility_Clock(Clock_t *, char *, char *, char *);
 int Voltages_Check(void *, void *);
+int Watch_GPIO(char *, bool, GPIO_Handler_t, void *);
+int Watch_Presence_GPIOs(void);
 int XSDB_BIT(void *, void *);
 int XSDB_Op(const char *, const char *, char *, int);
 
@@ -14,8 +14,10 @@
 #include <math.h>
 #include <errno.h>
 #include <signal.h>
+#include <pthread.h>
 #include <sys/utsname.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include "sc_app.h"
 
 /*
@@ -47,11 +49,37 @@
  * 1.23 - Added 'listFMCvoltage' command to list rail info providing power to FMCs.
  * 1.24 - Added 'setinputgpio' command to set the direction of a gpio line to input.
  * 1.25 - Added JTAG select commands to select different JTAG controllers.
+ * 1.26 - Added recording and replaying of I2C transactions.
+ * 1.27 - Added per-bus I2C transaction queues.
+ * 1.28 - Added 'getI2Cstats' command and I2C bandwidth budgeting.
+ * 1.29 - Added I2C bus health tracking and recovery.
+ * 1.30 - Added 'profile' command to measure latency of I2C devices.
+ * 1.31 - Added hwmon fast path for sensors with a bound kernel driver.
+ * 1.32 - Added device driver registry with precompiled transaction plans.
+ * 1.33 - Added batched reader of sysfs attributes using io_uring.
+ * 1.34 - Added presence cache for absent optional devices.
+ * 1.35 - Read INA226 power with one-time calibration
+ * 1.36 - Configure INA226 averaging and conversion times
+ * 1.37 - Capture INA226 alerts on GPIO line events
+ * 1.38 - Accumulate rail and power domain energy
+ * 1.39 - Take synchronized power snapshots
+ * 1.40 - Capture rail power to a memory-mapped ring file
+ * 1.41 - Evaluate derived sensors defined in board JSON
+ * 1.42 - Read a voltage snapshot grouped by I2C bus and page
+ * 1.43 - Read PMBus telemetry of regulators natively
+ * 1.44 - Monitor PMBus status of regulators
+ * 1.45 - Apply clock and voltage profiles as a transaction
+ * 1.46 - Added 'sweepvoltage' command for voltage margining sweeps
+ * 1.47 - Probe and cache the VOUT format and capabilities of PMBus regulators
+ * 1.48 - Added native power sequencer with 'listsequence' and 'runsequence' commands
+ * 1.49 - Native TPS53681 VID handling and per-phase telemetry of multi-phase controllers
+ * 1.50 - Native SiT95211 and SiT95314 clock driver, measured clocks read in one xsdb call
  */
 #define MAJOR	1
-#define MINOR	25
+#define MINOR	50
 
-int Client_FD;
+/* Only the thread serving the client prints to it */
+__thread int Client_FD;
 char Sock_OutBuffer[SOCKBUF_MAX];
 char Board_Name[LSTRLEN_MAX];
 char Board_Revision[LSTRLEN_MAX];
@@ -69,9 +97,20 @@ int EEPROM_Ops(void);
 int Temperature_Ops(void);
 int Clock_Ops(void);
 int Voltage_Ops(void);
+int Voltage_Snapshot_Ops(void);
+int Telemetry_Ops(void);
+int Phase_Ops(void);
+int Fault_Ops(void);
+int Sweep_Ops(void);
+int Profile_Ops(void);
+int Power_Sequence_Ops(void);
 int INA226_Ops(void);
 int Power_Ops(void);
 int Power_Domain_Ops(void);
+int Energy_Ops(void);
+int Derived_Ops(void);
+int Power_Snapshot_Ops(void);
+int Capture_Ops(void);
 int Workaround_Ops(void);
 int BIT_Ops(void);
 int DDR_Ops(void);
@@ -81,10 +120,12 @@ int SFP_Ops(void);
 int EBM_Ops(void);
 int FMC_Ops(void);
 int PDI_Ops(void);
+int I2C_Ops(void);
 int (*Workaround_Op)(void *);
 int FMC_Autodetect_Vadj(void);
 int Boot_Set_Clocks(void);
 int Boot_Set_Voltages(void);
+int Boot_Configure_INA226s(void);
 int Boot_Load_PDI(void);
 int Apply_Workarounds(void);
 int IO_Exp_Initialized(void);
@@ -125,16 +166,48 @@ sc_app -c <command> [-t <target> [-v <value>]]\n\n\
 	setvoltage - set <target> to <value> volts\n\
 	setbootvoltage - set <target> to <value> volts at boot time\n\
 	restorevoltage - restore <target> to default value\n\
+	voltagesnapshot - get the voltage of all regulators, read in parallel by I2C bus\n\
+	gettelemetry - get input and output voltage, current, temperature, and power\n\
+		       of <target> regulator, or of 'all' of them\n\
+	getphases - get output current and temperature of each phase of <target>\n\
+		    multi-phase controller, or of 'all' of them\n\
+	getfaults - get the PMBus status of <target> regulator, or of 'all' of them\n\
+	getfaultlog - get the log of PMBus status changes of all regulators\n\
+	sweepvoltage - step the comma separated <target> regulators through <value> of\n\
+		       '<start> <stop> <step> <settle ms> [<rails and power domains>]',\n\
+		       and restore them at the end\n\
+\n\
+	listprofile - list the supported and saved clock and voltage profiles\n\
+	saveprofile - save the current clock frequencies and voltages as <target> profile\n\
+	applyprofile - apply <target> profile, or restore the previous state on failure\n\
+\n\
+	listsequence - list the supported power sequences\n\
+	runsequence - run <target> power sequence, and report the timing of its steps\n\
 \n\
 	listpower - list the supported power targets\n\
-	getpower - get the voltage, current, and power of <target>\n\
+	getpower - get the voltage, current, and power of <target>, or of all\n\
+		   targets if <target> is 'all'\n\
 	getcalpower - get the voltage, current, and power of custom calibrated <target>\n\
 	getINA226 - get the content of <target> registers\n\
 	setINA226 - set the 'Configuration', 'Calibration', 'Mask/Enable', and \n\
 		    'Alert Limit' registers of <target> to <value>\n\
+	getINA226conv - get the averages, conversion times, and sample period of <target>\n\
+	setINA226conv - set the averages and the bus and shunt conversion times\n\
+			in micro-seconds of <target> to <value>\n\
+	getINA226alerts - get the rail snapshots captured on INA226 alerts\n\
 \n\
 	listpowerdomain - list the supported power domain targets\n\
 	powerdomain - get the power used by <target> power domain\n\
+\n\
+	powersnapshot - get the voltage, current, and power of all rails converted\n\
+			at the same time\n\
+	capture - capture the power of comma separated <target> rails for <value>:\n\
+		  '<rate in Hz> <seconds>'\n\
+	startenergy - start accumulating the energy of all rails in <target> counter\n\
+	stopenergy - stop accumulating energy in <target> counter\n\
+	getenergy - get the energy of each rail and power domain in <target> counter\n\
+	listderived - list the supported derived sensor targets\n\
+	getderived - get the value of <target> derived sensor, or of 'all' of them\n\
 \n\
 	listworkaround - list the applicable workaround targets\n\
 	workaround - apply <target> workaround (may requires <value>)\n\
@@ -174,6 +247,10 @@ sc_app -c <command> [-t <target> [-v <value>]]\n\n\
 	loadPDI - load <target> PDI to Versal\n\
 	setbootPDI - set <target> PDI to be loaded to Versal at boot time\n\
 	resetbootPDI - remove any boot PDI that has been set\n\
+\n\
+	getI2Cstats - get the state, transaction statistics, and utilization of I2C buses\n\
+	profile - profile the latency of I2C devices, or <target> device only, with\n\
+		  optional <value> number of reads per device (default 100)\n\
 ";
 
 typedef enum {
@@ -201,13 +278,34 @@ typedef enum {
 	SETVOLTAGE,
 	SETBOOTVOLTAGE,
 	RESTOREVOLTAGE,
+	VOLTAGESNAPSHOT,
+	GETTELEMETRY,
+	GETPHASES,
+	GETFAULTS,
+	GETFAULTLOG,
+	SWEEPVOLTAGE,
+	LISTPROFILE,
+	SAVEPROFILE,
+	APPLYPROFILE,
+	LISTSEQUENCE,
+	RUNSEQUENCE,
 	LISTPOWER,
 	GETPOWER,
 	GETCALPOWER,
 	GETINA226,
 	SETINA226,
+	GETINA226CONV,
+	SETINA226CONV,
+	GETINA226ALERTS,
 	LISTPOWERDOMAIN,
 	POWERDOMAIN,
+	POWERSNAPSHOT,
+	CAPTURE,
+	STARTENERGY,
+	STOPENERGY,
+	GETENERGY,
+	LISTDERIVED,
+	GETDERIVED,
 	LISTWORKAROUND,
 	WORKAROUND,
 	LISTBIT,
@@ -234,6 +332,8 @@ typedef enum {
 	LOADPDI,
 	SETBOOTPDI,
 	RESETBOOTPDI,
+	GETI2CSTATS,
+	PROFILE,
 	COMMAND_MAX,
 } CmdId_t;
 
@@ -268,13 +368,34 @@ static Command_t Commands[] = {
 	{ .CmdId = SETVOLTAGE, .CmdStr = "setvoltage", .CmdOps = Voltage_Ops, },
 	{ .CmdId = SETBOOTVOLTAGE, .CmdStr = "setbootvoltage", .CmdOps = Voltage_Ops, },
 	{ .CmdId = RESTOREVOLTAGE, .CmdStr = "restorevoltage", .CmdOps = Voltage_Ops, },
+	{ .CmdId = VOLTAGESNAPSHOT, .CmdStr = "voltagesnapshot", .CmdOps = Voltage_Snapshot_Ops, },
+	{ .CmdId = GETTELEMETRY, .CmdStr = "gettelemetry", .CmdOps = Telemetry_Ops, },
+	{ .CmdId = GETPHASES, .CmdStr = "getphases", .CmdOps = Phase_Ops, },
+	{ .CmdId = GETFAULTS, .CmdStr = "getfaults", .CmdOps = Fault_Ops, },
+	{ .CmdId = GETFAULTLOG, .CmdStr = "getfaultlog", .CmdOps = Fault_Ops, },
+	{ .CmdId = SWEEPVOLTAGE, .CmdStr = "sweepvoltage", .CmdOps = Sweep_Ops, },
+	{ .CmdId = LISTPROFILE, .CmdStr = "listprofile", .CmdOps = Profile_Ops, },
+	{ .CmdId = SAVEPROFILE, .CmdStr = "saveprofile", .CmdOps = Profile_Ops, },
+	{ .CmdId = APPLYPROFILE, .CmdStr = "applyprofile", .CmdOps = Profile_Ops, },
+	{ .CmdId = LISTSEQUENCE, .CmdStr = "listsequence", .CmdOps = Power_Sequence_Ops, },
+	{ .CmdId = RUNSEQUENCE, .CmdStr = "runsequence", .CmdOps = Power_Sequence_Ops, },
 	{ .CmdId = LISTPOWER, .CmdStr = "listpower", .CmdOps = Power_Ops, },
 	{ .CmdId = GETPOWER, .CmdStr = "getpower", .CmdOps = Power_Ops, },
 	{ .CmdId = GETCALPOWER, .CmdStr = "getcalpower", .CmdOps = Power_Ops, },
 	{ .CmdId = GETINA226, .CmdStr = "getINA226", .CmdOps = Power_Ops, },
 	{ .CmdId = SETINA226, .CmdStr = "setINA226", .CmdOps = Power_Ops, },
+	{ .CmdId = GETINA226CONV, .CmdStr = "getINA226conv", .CmdOps = Power_Ops, },
+	{ .CmdId = SETINA226CONV, .CmdStr = "setINA226conv", .CmdOps = Power_Ops, },
+	{ .CmdId = GETINA226ALERTS, .CmdStr = "getINA226alerts", .CmdOps = Power_Ops, },
 	{ .CmdId = LISTPOWERDOMAIN, .CmdStr = "listpowerdomain", .CmdOps = Power_Domain_Ops, },
 	{ .CmdId = POWERDOMAIN, .CmdStr = "powerdomain", .CmdOps = Power_Domain_Ops, },
+	{ .CmdId = POWERSNAPSHOT, .CmdStr = "powersnapshot", .CmdOps = Power_Snapshot_Ops, },
+	{ .CmdId = CAPTURE, .CmdStr = "capture", .CmdOps = Capture_Ops, },
+	{ .CmdId = STARTENERGY, .CmdStr = "startenergy", .CmdOps = Energy_Ops, },
+	{ .CmdId = STOPENERGY, .CmdStr = "stopenergy", .CmdOps = Energy_Ops, },
+	{ .CmdId = GETENERGY, .CmdStr = "getenergy", .CmdOps = Energy_Ops, },
+	{ .CmdId = LISTDERIVED, .CmdStr = "listderived", .CmdOps = Derived_Ops, },
+	{ .CmdId = GETDERIVED, .CmdStr = "getderived", .CmdOps = Derived_Ops, },
 	{ .CmdId = LISTWORKAROUND, .CmdStr = "listworkaround", .CmdOps = Workaround_Ops, },
 	{ .CmdId = WORKAROUND, .CmdStr = "workaround", .CmdOps = Workaround_Ops, },
 	{ .CmdId = LISTBIT, .CmdStr = "listBIT", .CmdOps = BIT_Ops, },
@@ -301,6 +422,8 @@ static Command_t Commands[] = {
 	{ .CmdId = LOADPDI, .CmdStr = "loadPDI", .CmdOps = PDI_Ops, },
 	{ .CmdId = SETBOOTPDI, .CmdStr = "setbootPDI", .CmdOps = PDI_Ops, },
 	{ .CmdId = RESETBOOTPDI, .CmdStr = "resetbootPDI", .CmdOps = PDI_Ops, },
+	{ .CmdId = GETI2CSTATS, .CmdStr = "getI2Cstats", .CmdOps = I2C_Ops, },
+	{ .CmdId = PROFILE, .CmdStr = "profile", .CmdOps = I2C_Ops, },
 };
 
 char Command_Arg[STRLEN_MAX];
@@ -332,11 +455,37 @@ main()
 #ifdef GIT_COMMIT
 	SC_INFO("Commit:    %s", GIT_COMMIT);
 #endif
+	/* Set up I2C access, including optional tracing or replaying */
+	if (I2C_Init() != 0) {
+		SC_ERR("failed to initialize I2C access");
+		goto Out;
+	}
+
 	/* Identify the board */
 	if (Board_Identification(Board_Name, Board_Revision) != 0) {
 		goto Out;
 	}
 
+	/* Map the sensors that are served by a kernel hwmon driver */
+	if (Hwmon_Init() != 0) {
+		SC_ERR("failed to discover hwmon devices");
+		goto Out;
+	}
+
+	/* Compile the transaction plans of the board devices */
+	if (Driver_Compile() != 0) {
+		SC_ERR("failed to compile device transaction plans");
+		goto Out;
+	}
+
+	/* Probe the VOUT format and capabilities of the regulators once */
+	(void) Driver_PMBus_Probe();
+
+	if (Derived_Compile() != 0) {
+		SC_ERR("failed to compile derived sensors");
+		goto Out;
+	}
+
 	/*
 	 * Direction of IO Expander ports needs to be initialized
 	 * in order for FMC modules to be detected.
@@ -352,6 +501,12 @@ main()
 		goto Out;
 	}
 
+	/* Forget cached absence of FMC modules as they are plugged */
+	if (Watch_Presence_GPIOs() != 0) {
+		SC_ERR("failed to watch presence lines");
+		goto Out;
+	}
+
 	/* Set custom clock frequency */
 	if (Boot_Set_Clocks() != 0) {
 		SC_ERR("failed to set clock frequency");
@@ -364,6 +519,24 @@ main()
 		goto Out;
 	}
 
+	/* Set averaging, conversion times, and alerts of power monitors */
+	if (Boot_Configure_INA226s() != 0) {
+		SC_ERR("failed to configure INA226");
+		goto Out;
+	}
+
+	/* Monitor the status of regulators */
+	if (Fault_Monitor_Start() != 0) {
+		SC_ERR("failed to start fault monitor");
+		goto Out;
+	}
+
+	/* Watch presence and alert lines */
+	if (Start_Watching_GPIOs() != 0) {
+		SC_ERR("failed to watch GPIO lines");
+		goto Out;
+	}
+
 	/* Load PDI */
 	if (Boot_Load_PDI() != 0) {
 		SC_ERR("failed to load PDI");
@@ -658,6 +831,12 @@ Constraint_Pre_Ops()
 					SC_ERR("failed to FMC autodetect vadj");
 					return -1;
 				}
+			} else if (strcmp(Pre_Phases->Phase[i].Command, "Power_Sequence") == 0) {
+				if (Pre_Phases->Phase[i].Args == NULL ||
+				    Power_Sequence_Run(Pre_Phases->Phase[i].Args) != 0) {
+					SC_ERR("failed to run power sequence");
+					return -1;
+				}
 			}
 
 		} else {
@@ -880,7 +1059,7 @@ EEPROM_Ops(void)
 {
 	EEPROM_Targets Target;
 	OnBoard_EEPROM_t *OnBoard_EEPROM;
-	int FD;
+	Sysfs_Attr_t Attr = { 0 };
 	char In_Buffer[SYSCMD_MAX];
 	char Buffer[STRLEN_MAX];
 	struct tm BuildDate = { 0 };
@@ -929,20 +1108,15 @@ EEPROM_Ops(void)
 		return -1;
 	}
 
-	FD = open(OnBoard_EEPROM->Path, O_RDWR);
-	if (FD < 0) {
-		SC_ERR("unable to open EEPROM '%s': %m", OnBoard_EEPROM->Path);
-		return -1;
-	}
-
 	(void) memset(In_Buffer, 0, SYSCMD_MAX);
-	if (read(FD, In_Buffer, 256) != 256) {
+	Attr.Path = OnBoard_EEPROM->Path;
+	Attr.Buffer = In_Buffer;
+	Attr.Length = 257;
+	if (Sysfs_Read(&Attr, 1) != 0 || Attr.Count != 256) {
 		SC_ERR("unable to read onboard EEPROM");
-		(void) close(FD);
 		return -1;
 	}
 
-	(void) close(FD);
 	switch (Target) {
 	case EEPROM_SUMMARY:
 		SC_PRINT("Language: %d", In_Buffer[0xA]);
@@ -1048,6 +1222,7 @@ Clock_Ops(void)
 	Clocks_t *Clocks;
 	Clock_t *Clock;
 	FILE *FP;
+	Sysfs_Attr_t Attr = { 0 };
 	char System_Cmd[2 * SYSCMD_MAX];
 	char Output[STRLEN_MAX];
 	double Frequency;
@@ -1111,24 +1286,19 @@ Clock_Ops(void)
 			return Get_IDT_8A34001(Clock);
 		}
 
-		if (Clock->Vendor_Managed) {
-			return Vendor_Utility_Clock(Clock, Command_Arg, Target_Arg, Value_Arg);
-		}
-
-		(void) sprintf(System_Cmd, "cat %s", Clock->Sysfs_Path);
-		SC_INFO("Command: %s", System_Cmd);
-		FP = popen(System_Cmd, "r");
-		if (FP == NULL) {
-			SC_ERR("failed to start process %s: %m", System_Cmd);
-			return -1;
+		if (strncmp(Clock->Part_Name, "SIT95", 5) == 0) {
+			return Get_SiTime_Clock(Clock);
 		}
 
-		if (fgets(Output, sizeof(Output), FP) == NULL) {
-			SC_ERR("failed to get clock frequency");
+		if (Clock->Vendor_Managed) {
+			SC_ERR("unsupported vendor-managed clock %s", Clock->Part_Name);
 			return -1;
 		}
 
-		if (pclose(FP) != 0) {
+		Attr.Path = Clock->Sysfs_Path;
+		Attr.Buffer = Output;
+		Attr.Length = sizeof(Output);
+		if (Sysfs_Read(&Attr, 1) != 0) {
 			SC_ERR("failed to get clock frequency");
 			return -1;
 		}
@@ -1167,8 +1337,14 @@ Clock_Ops(void)
 			}
 		}
 
+		if (strncmp(Clock->Part_Name, "SIT95", 5) == 0) {
+			return Set_SiTime_Clock(Clock, Value_Arg,
+						((Command.CmdId == SETCLOCK) ? 0 : 1));
+		}
+
 		if (Clock->Vendor_Managed) {
-			return Vendor_Utility_Clock(Clock, Command_Arg, Target_Arg, Value_Arg);
+			SC_ERR("unsupported vendor-managed clock %s", Clock->Part_Name);
+			return -1;
 		}
 
 		Frequency = strtod(Value_Arg, NULL);
@@ -1219,8 +1395,13 @@ Clock_Ops(void)
 			return Restore_IDT_8A34001(Clock);
 		}
 
+		if (strncmp(Clock->Part_Name, "SIT95", 5) == 0) {
+			return Restore_SiTime_Clock(Clock);
+		}
+
 		if (Clock->Vendor_Managed) {
-			return Vendor_Utility_Clock(Clock, Command_Arg, Target_Arg, Value_Arg);
+			SC_ERR("unsupported vendor-managed clock %s", Clock->Part_Name);
+			return -1;
 		}
 
 		if (Clock->Upper_Freq == -1 && Clock->Lower_Freq == -1) {
@@ -1406,158 +1587,74 @@ typedef enum {
 	INA226_Alert_Limit = 0x8,
 } INA226_RegsMap_t;
 
+/*
+ * The calibration register of each INA226 is programmed once, and verified
+ * again only after a failed read or every INA226_VERIFY_INTERVAL seconds.
+ * The last reading is reused until the INA226 completes its next conversion,
+ * i.e. for 'Sample_Period' micro-seconds.
+ */
+#define INA226_VERIFY_INTERVAL	300
+#define INA226_DEFAULT_CONFIG	0x4127
+
+static struct {
+	bool		Calibrated;
+	unsigned short	Calibration;
+	time_t		Verified;
+	unsigned short	Configuration;
+	long		Sample_Period;
+	struct timespec	Sampled;
+	float		Voltage;
+	float		Current;
+	float		Power;
+} INA226_States[LITEMS_MAX];
+
+/* Serializes the accesses of the commands and threads to the INA226s */
+static pthread_mutex_t INA226_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* AVG, VBUSCT, and VSHCT fields of the 'Configuration' register */
+static const int INA226_Averages[] = { 1, 4, 16, 64, 128, 256, 512, 1024 };
+static const int INA226_Conversion_Times[] = { 140, 204, 332, 588, 1100, 2116,
+					       4156, 8244 };
+
 int
 Read_INA226(INA226_t *INA226, INA226_Regs_t *Regs)
 {
-	int FD;
-	char In_Buffer[STRLEN_MAX];
-	char Out_Buffer[STRLEN_MAX];
-	int Ret = 0;
+	Driver_Plan_t *Plan;
+	unsigned int Raw[9];
+	int Ret;
 
-	FD = open(INA226->I2C_Bus, O_RDWR);
-	if (FD < 0) {
-		SC_ERR("unable to access I2C bus %s: %m", INA226->I2C_Bus);
+	Plan = Driver_Plan(DRIVER_INA226_REGISTERS, INA226);
+	if (Plan == NULL) {
 		return -1;
 	}
 
-	/* Read 'Configuration' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x0;	// Configuration Register(00h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Configuration Register(00h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Configuration = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Shunt Voltage' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x1;	// Shunt Voltage Register(01h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Shunt Voltage Register(01h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Shunt_Voltage = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Bus Voltage' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x2;	// Bus Voltage Register(02h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Bus Voltage Register(02h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Bus_Voltage = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Power' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x3;	// Power Register(03h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Power Register(03h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Power = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Current' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x4;	// Current Register(04h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Current Register(04h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Current = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Calibration' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x5;	// Calibration Register(05h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Calibration Register(05h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Calibration = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Mask/Enable' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x6;	// Mask/Enable Register(06h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Mask/Enable Register(06h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Mask_Enable = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Alert Limit' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0x7;	// Alert Limit Register(07h)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
-
-	SC_INFO("Alert Limit Register(07h): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Alert_Limit = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	/* Read 'Die ID' register */
-	(void) memset(Out_Buffer, 0, STRLEN_MAX);
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	Out_Buffer[0] = 0xFF;	// Die ID Register(FFh)
-	I2C_READ(FD, INA226->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
+	(void) pthread_mutex_lock(&INA226_Lock);
+	Ret = Driver_Run(Plan, Raw, NULL);
+	(void) pthread_mutex_unlock(&INA226_Lock);
 	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
+		return -1;
 	}
 
-	SC_INFO("Die ID Register(FFh): %#x %#x", In_Buffer[0],
-		In_Buffer[1]);
-	Regs->Die_ID = ((In_Buffer[0] << 8) | In_Buffer[1]);
-
-	(void) close(FD);
+	Regs->Configuration = Raw[0];
+	Regs->Shunt_Voltage = Raw[1];
+	Regs->Bus_Voltage = Raw[2];
+	Regs->Power = Raw[3];
+	Regs->Current = Raw[4];
+	Regs->Calibration = Raw[5];
+	Regs->Mask_Enable = Raw[6];
+	Regs->Alert_Limit = Raw[7];
+	Regs->Die_ID = Raw[8];
 	return 0;
 }
 
-int
-Write_INA226(INA226_t *INA226, INA226_Regs_t *Regs)
+static int
+INA226_Write_Registers(INA226_t *INA226, INA226_Regs_t *Regs)
 {
 	int FD;
 	char Out_Buffer[STRLEN_MAX];
 	int Ret = 0;
 
-	FD = open(INA226->I2C_Bus, O_RDWR);
+	FD = I2C_Open(INA226->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("unable to access I2C bus %s: %m", INA226->I2C_Bus);
 		return -1;
@@ -1628,139 +1725,498 @@ Write_INA226(INA226_t *INA226, INA226_Regs_t *Regs)
 }
 
 int
-Get_Power(INA226_t *INA226, int Mode, float *Voltage, float *Current, float *Power)
+Write_INA226(INA226_t *INA226, INA226_Regs_t *Regs)
 {
-	int FD;
-	INA226_Regs_t Regs;
-	char Out_Buffer[STRLEN_MAX];
-	float Current_LSB;
-	float Calibration;
-	int Ret = 0;
-
-	if (Mode != 0 && Mode != 1) {
-		SC_ERR("invalid mode for getting power");
-		return -1;
-	}
-
-	if (Mode == 0) {
-		FD = open(INA226->I2C_Bus, O_RDWR);
-		if (FD < 0) {
-			SC_ERR("unable to access I2C bus %s: %m", INA226->I2C_Bus);
-			return -1;
-		}
-
-		/*
-		 * The per bit value for current is determined by
-		 * following equation.  The 'Maximum Expected Current'
-		 * unit is in Amps:
-		 * 	Current_LSB = Maximum Expected Current / 2^15
-		 * The unit of 'INA226->Maximum_Current' is in milli-Amps.
-		 */
-		Current_LSB = (float)INA226->Maximum_Current / (32768 * 1000);
+	int Ret;
 
-		/*
-		 * The value of Calibration register is determined by:
-		 * 	Calibration = 0.00512 / (Current_LSB * R shunt)
-		 * The unit of 'INA226->Shunt_Resistor' is in micro-Ohms,
-		 * and the unit of 'R shunt' is in Ohms.
-		 */
-		Calibration = (0.00512 * 1000000) /
-			      (Current_LSB * INA226->Shunt_Resistor);
+	(void) pthread_mutex_lock(&INA226_Lock);
+	Ret = INA226_Write_Registers(INA226, Regs);
+	(void) pthread_mutex_unlock(&INA226_Lock);
+	return Ret;
+}
 
-		/* Prevent the overflow of Calibration register[14:0] */
-		if (Calibration > 32767) {
-			Calibration = 32767;
+static int
+INA226_Field(const int *Table, int Value)
+{
+	for (int i = 0; i < 8; i++) {
+		if (Table[i] == Value) {
+			return i;
 		}
+	}
 
-		/* Write 'Calibration' register */
-		(void) memset(Out_Buffer, 0, STRLEN_MAX);
-		Out_Buffer[0] = 0x5;   // Calibration Register(05h)
-		Out_Buffer[1] = ((unsigned short)Calibration >> 8);
-		Out_Buffer[2] = ((unsigned short)Calibration & 0xFF);
-		SC_INFO("Calibration Register(05h): %#x %#x", Out_Buffer[1],
-			 Out_Buffer[2]);
-		I2C_WRITE(FD, INA226->I2C_Address, 3, Out_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
-		}
+	return -1;
+}
 
-		(void) close(FD);
+/*
+ * Derive the time between two conversions from the 'Configuration' register.
+ * In the triggered and power-down modes, every read returns a new result.
+ */
+static void
+INA226_Set_Sample_Period(INA226_t *INA226, unsigned short Configuration)
+{
+	int Index = INA226 - Plat_Devs->INA226s->INA226;
+	long Period = INA226_Averages[(Configuration >> 9) & 0x7];
+	int Bus_CT = INA226_Conversion_Times[(Configuration >> 6) & 0x7];
+	int Shunt_CT = INA226_Conversion_Times[(Configuration >> 3) & 0x7];
+
+	switch (Configuration & 0x7) {
+	case 0x5:	// Shunt voltage, continuous
+		Period *= Shunt_CT;
+		break;
+	case 0x6:	// Bus voltage, continuous
+		Period *= Bus_CT;
+		break;
+	case 0x7:	// Shunt and bus voltage, continuous
+		Period *= (Bus_CT + Shunt_CT);
+		break;
+	default:
+		Period = 0;
+		break;
 	}
 
-	if (Read_INA226(INA226, &Regs) != 0) {
-		SC_ERR("failed to read INA226 registers");
+	SC_INFO("%s: sample period of %ld us", INA226->Name, Period);
+	(void) pthread_mutex_lock(&INA226_Lock);
+	INA226_States[Index].Configuration = Configuration;
+	INA226_States[Index].Sample_Period = Period;
+	INA226_States[Index].Sampled.tv_sec = 0;
+	INA226_States[Index].Sampled.tv_nsec = 0;
+	(void) pthread_mutex_unlock(&INA226_Lock);
+}
+
+/*
+ * Set the number of averages and conversion times, in micro-seconds, of an
+ * INA226 in continuous shunt and bus voltage mode.  A value of 0 selects the
+ * power-on default.
+ */
+int
+Configure_INA226(INA226_t *INA226, int Averages, int Bus_CT, int Shunt_CT)
+{
+	INA226_Regs_t Regs = { 0 };
+	int AVG, VBUSCT, VSHCT;
+
+	AVG = INA226_Field(INA226_Averages, ((Averages == 0) ? 1 : Averages));
+	VBUSCT = INA226_Field(INA226_Conversion_Times,
+			      ((Bus_CT == 0) ? 1100 : Bus_CT));
+	VSHCT = INA226_Field(INA226_Conversion_Times,
+			     ((Shunt_CT == 0) ? 1100 : Shunt_CT));
+	if (AVG == -1 || VBUSCT == -1 || VSHCT == -1) {
+		SC_ERR("invalid averages or conversion time for %s", INA226->Name);
 		return -1;
 	}
 
-	if (Regs.Calibration == 0) {
-		SC_ERR("invalid calibration register value of 0");
+	Regs.Configuration = (0x4000 | (AVG << 9) | (VBUSCT << 6) |
+			      (VSHCT << 3) | 0x7);
+	Regs.Set_Registers = INA226_Configuration;
+	if (Write_INA226(INA226, &Regs) != 0) {
 		return -1;
 	}
 
-	Current_LSB = (0.00512 * 1000000) /
-		      (float)(Regs.Calibration * INA226->Shunt_Resistor);
-	SC_INFO("Calculating Current_LSB = %f", Current_LSB);
+	INA226_Set_Sample_Period(INA226, Regs.Configuration);
+	return 0;
+}
 
-	/* if Current is negative, use its absolute value */
-	*Current = (float)Regs.Current;
-	if (*Current > 0x7FFF) {
-		*Current -= 0x10000;
-		*Current = abs(*Current);
-	}
+/*
+ * Excursions signalled on the alert pins of INA226s are kept in a ring of
+ * the last INA226_ALERTS_MAX alerts.
+ */
+#define INA226_ALERTS_MAX	32
 
-	SC_INFO("Current before LSB scaling %f", *Current);
-	*Current = ((*Current) * Current_LSB);
-	SC_INFO("Current before phase multiplier scaling %f", *Current);
-	*Current *= INA226->Phase_Multiplier;
+static struct {
+	INA226_t	*INA226;
+	struct timespec	Time;
+	unsigned short	Mask_Enable;
+	float		Voltage;
+	float		Current;
+	float		Power;
+} INA226_Alerts[INA226_ALERTS_MAX];
 
-	*Voltage = (float)Regs.Bus_Voltage;
-	SC_INFO("Voltage before LSB scaling %f", *Voltage);
-	*Voltage *= 1.25;       // 1.25 mV per bit
-	*Voltage /= 1000;
+static int INA226_Alert_Numbers;
+static pthread_mutex_t INA226_Alerts_Lock = PTHREAD_MUTEX_INITIALIZER;
 
-	/* The power LSB has a fixed ratio to the Current_LSB of 25 */
-	*Power = ((float)Regs.Power * Current_LSB * 25);
-	SC_INFO("Power before phase multiplier scaling %f", *Power);
-	*Power *= INA226->Phase_Multiplier;
+/*
+ * Snapshot the rail whose alert pin is asserted.  This is called by the GPIO
+ * watcher thread with the time of the falling edge on the pin.
+ */
+static void
+INA226_Alert(void *Arg, unsigned long long Timestamp)
+{
+	INA226_t *INA226 = Arg;
+	INA226_Regs_t Regs;
+	struct timespec Real, Mono;
+	long long Time_ns;
+	int Index;
 
-	return 0;
+	/* Reading 'Mask/Enable' register also clears the latched alert */
+	if (Read_INA226(INA226, &Regs) != 0) {
+		SC_INFO("failed to capture the alert of %s", INA226->Name);
+		return;
+	}
+
+	/* Edge timestamps are in CLOCK_MONOTONIC */
+	(void) clock_gettime(CLOCK_REALTIME, &Real);
+	(void) clock_gettime(CLOCK_MONOTONIC, &Mono);
+	Time_ns = ((long long)Real.tv_sec * 1000000000 + Real.tv_nsec) -
+		  ((long long)Mono.tv_sec * 1000000000 + Mono.tv_nsec -
+		   (long long)Timestamp);
+
+	(void) pthread_mutex_lock(&INA226_Alerts_Lock);
+	Index = INA226_Alert_Numbers++ % INA226_ALERTS_MAX;
+	INA226_Alerts[Index].INA226 = INA226;
+	INA226_Alerts[Index].Time.tv_sec = Time_ns / 1000000000;
+	INA226_Alerts[Index].Time.tv_nsec = Time_ns % 1000000000;
+	INA226_Alerts[Index].Mask_Enable = Regs.Mask_Enable;
+	INA226_Alerts[Index].Voltage = (float)Regs.Bus_Voltage * 1.25 / 1000;
+	INA226_Alerts[Index].Current = fabs((short)Regs.Shunt_Voltage * 2.5 /
+					    INA226->Shunt_Resistor) *
+				       INA226->Phase_Multiplier;
+	INA226_Alerts[Index].Power = INA226_Alerts[Index].Voltage *
+				     INA226_Alerts[Index].Current;
+	SC_INFO("%s: alert %#x, %.4f V, %.4f A", INA226->Name, Regs.Mask_Enable,
+		INA226_Alerts[Index].Voltage, INA226_Alerts[Index].Current);
+	(void) pthread_mutex_unlock(&INA226_Alerts_Lock);
 }
 
 /*
- * Power Operations
+ * Program the alert function and limit of an INA226, latching the alert
+ * pin until the rail is captured.  The alert line is watched first, so that
+ * an excursion that is present already is not missed.
  */
-int Power_Ops(void)
+static int
+Arm_INA226_Alert(INA226_t *INA226)
 {
-	int Target_Index = -1;
-	INA226s_t *INA226s;
-	INA226_t *INA226;
 	INA226_Regs_t Regs = { 0 };
-	unsigned long int Value;
-	char *Next_Token;
-	float Voltage;
-	float Current;
-	float Power;
 
-	INA226s = Plat_Devs->INA226s;
-	if (INA226s == NULL) {
-		SC_ERR("power operation is not supported");
-		return -1;
+	if (INA226->Alert_Line != NULL &&
+	    Watch_GPIO(INA226->Alert_Line, true, INA226_Alert, INA226) != 0) {
+		SC_ERR("failed to watch the alert line of %s", INA226->Name);
 	}
 
-	if (Command.CmdId == LISTPOWER) {
-		for (int i = 0; i < INA226s->Numbers; i++) {
-			SC_PRINT("%s", INA226s->INA226[i].Name);
-		}
+	Regs.Mask_Enable = (INA226->Alert_Mask | 0x1);   // Latch Enable
+	Regs.Alert_Limit = INA226->Alert_Limit;
+	Regs.Set_Registers = (INA226_Mask_Enable | INA226_Alert_Limit);
+	return Write_INA226(INA226, &Regs);
+}
+
+static void
+Print_INA226_Alerts(void)
+{
+	char Time[STRLEN_MAX];
+	struct tm TM;
+	int First;
+	int Index;
+
+	(void) pthread_mutex_lock(&INA226_Alerts_Lock);
+	First = ((INA226_Alert_Numbers > INA226_ALERTS_MAX) ?
+		 (INA226_Alert_Numbers - INA226_ALERTS_MAX) : 0);
+	SC_PRINT("Time\tTarget\tMask/Enable\tVoltage(V)\tCurrent(A)\tPower(W)");
+	for (int i = First; i < INA226_Alert_Numbers; i++) {
+		Index = i % INA226_ALERTS_MAX;
+		(void) localtime_r(&INA226_Alerts[Index].Time.tv_sec, &TM);
+		(void) strftime(Time, sizeof(Time), "%F %T", &TM);
+		SC_PRINT("%s.%06ld\t%s\t%#x\t%.4f\t%.4f\t%.4f", Time,
+			 INA226_Alerts[Index].Time.tv_nsec / 1000,
+			 INA226_Alerts[Index].INA226->Name,
+			 INA226_Alerts[Index].Mask_Enable,
+			 INA226_Alerts[Index].Voltage,
+			 INA226_Alerts[Index].Current,
+			 INA226_Alerts[Index].Power);
+	}
+
+	(void) pthread_mutex_unlock(&INA226_Alerts_Lock);
+}
 
+static int INA226_Shunt_Current = -1;
+
+static int
+INA226_Calibrate(INA226_t *INA226)
+{
+	int Index = INA226 - Plat_Devs->INA226s->INA226;
+	Driver_Plan_t *Plan;
+	unsigned int Raw[1];
+	char Out_Buffer[STRLEN_MAX];
+	float Current_LSB;
+	float Calibration;
+	time_t Now = time(NULL);
+	int FD;
+	int Ret = 0;
+
+	if (INA226_States[Index].Calibrated &&
+	    (Now - INA226_States[Index].Verified) < INA226_VERIFY_INTERVAL) {
 		return 0;
 	}
 
-	/* Validate the power target */
-	if (T_Flag == 0) {
-		SC_ERR("no power target");
-		return -1;
-	}
+	/*
+	 * The per bit value for current is determined by
+	 * following equation.  The 'Maximum Expected Current'
+	 * unit is in Amps:
+	 * 	Current_LSB = Maximum Expected Current / 2^15
+	 * The unit of 'INA226->Maximum_Current' is in milli-Amps.
+	 */
+	Current_LSB = (float)INA226->Maximum_Current / (32768 * 1000);
+
+	/*
+	 * The value of Calibration register is determined by:
+	 * 	Calibration = 0.00512 / (Current_LSB * R shunt)
+	 * The unit of 'INA226->Shunt_Resistor' is in micro-Ohms,
+	 * and the unit of 'R shunt' is in Ohms.
+	 */
+	Calibration = (0.00512 * 1000000) /
+		      (Current_LSB * INA226->Shunt_Resistor);
+
+	/* Prevent the overflow of Calibration register[14:0] */
+	if (Calibration > 32767) {
+		Calibration = 32767;
+	}
+
+	INA226_States[Index].Calibration = (unsigned short)Calibration;
+	if (INA226_States[Index].Calibrated) {
+		Plan = Driver_Plan(DRIVER_INA226_CALIBRATION, INA226);
+		if (Plan != NULL && Driver_Run(Plan, Raw, NULL) == 0 &&
+		    Raw[0] == INA226_States[Index].Calibration) {
+			INA226_States[Index].Verified = Now;
+			return 0;
+		}
+	}
+
+	FD = I2C_Open(INA226->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", INA226->I2C_Bus);
+		return -1;
+	}
+
+	/* Write 'Calibration' register */
+	(void) memset(Out_Buffer, 0, STRLEN_MAX);
+	Out_Buffer[0] = 0x5;   // Calibration Register(05h)
+	Out_Buffer[1] = (INA226_States[Index].Calibration >> 8);
+	Out_Buffer[2] = (INA226_States[Index].Calibration & 0xFF);
+	SC_INFO("Calibration Register(05h): %#x %#x", Out_Buffer[1],
+		 Out_Buffer[2]);
+	I2C_WRITE(FD, INA226->I2C_Address, 3, Out_Buffer, Ret);
+	(void) close(FD);
+	if (Ret != 0) {
+		return Ret;
+	}
+
+	INA226_States[Index].Calibrated = true;
+	INA226_States[Index].Verified = Now;
+	return 0;
+}
+
+/*
+ * Forget the calibration state of an INA226, e.g. after its registers are
+ * written by 'setINA226' command.
+ */
+static void
+INA226_Uncalibrate(INA226_t *INA226)
+{
+	int Index = INA226 - Plat_Devs->INA226s->INA226;
+
+	(void) pthread_mutex_lock(&INA226_Lock);
+	INA226_States[Index].Calibrated = false;
+	INA226_States[Index].Sampled.tv_sec = 0;
+	INA226_States[Index].Sampled.tv_nsec = 0;
+	(void) pthread_mutex_unlock(&INA226_Lock);
+}
+
+/*
+ * Get power with the fewest register reads: bus voltage and current, with
+ * power derived from them.  If 'INA226_Current: shunt' is defined in
+ * CONFIGFILE, current is derived from the shunt voltage and 'Shunt_Resistor'
+ * instead, which needs no calibration at all.
+ */
+static int
+Get_Power_Lean(INA226_t *INA226, float *Voltage, float *Current, float *Power)
+{
+	int Index = INA226 - Plat_Devs->INA226s->INA226;
+	Driver_Plan_t *Plan;
+	unsigned int Raw[2];
+	char Value[LSTRLEN_MAX];
+	int Found = 0;
+	struct timespec Now;
+
+	/* The INA226 has no new result until its next conversion is done */
+	(void) clock_gettime(CLOCK_MONOTONIC, &Now);
+	if (INA226_States[Index].Sample_Period > 0 &&
+	    ((Now.tv_sec - INA226_States[Index].Sampled.tv_sec) * 1000000 +
+	     (Now.tv_nsec - INA226_States[Index].Sampled.tv_nsec) / 1000) <
+	    INA226_States[Index].Sample_Period) {
+		*Voltage = INA226_States[Index].Voltage;
+		*Current = INA226_States[Index].Current;
+		*Power = INA226_States[Index].Power;
+		return 0;
+	}
+
+	if (INA226_Shunt_Current == -1) {
+		if (Check_Config_File("INA226_Current", Value, &Found) != 0) {
+			return -1;
+		}
+
+		INA226_Shunt_Current = (Found && strcmp(Value, "shunt") == 0);
+	}
+
+	if (INA226_Shunt_Current) {
+		Plan = Driver_Plan(DRIVER_INA226_SHUNT, INA226);
+		if (Plan == NULL || Driver_Run(Plan, Raw, NULL) != 0) {
+			return -1;
+		}
+
+		/*
+		 * Shunt voltage LSB is 2.5 uV and the unit of 'Shunt_Resistor'
+		 * is in micro-Ohms.  If Current is negative, use its absolute
+		 * value.
+		 */
+		*Current = fabs((short)Raw[0] * 2.5 / INA226->Shunt_Resistor);
+		*Voltage = (float)Raw[1] * 1.25 / 1000;   // 1.25 mV per bit
+
+	} else {
+		if (INA226_Calibrate(INA226) != 0) {
+			return -1;
+		}
+
+		Plan = Driver_Plan(DRIVER_INA226_POWER, INA226);
+		if (Plan == NULL || Driver_Run(Plan, Raw, NULL) != 0) {
+			INA226_States[Index].Calibrated = false;
+			return -1;
+		}
+
+		/* Current_LSB = 0.00512 / (Calibration * R shunt) */
+		*Voltage = (float)Raw[0] * 1.25 / 1000;   // 1.25 mV per bit
+		*Current = fabs((short)Raw[1] * (0.00512 * 1000000) /
+			   ((float)INA226_States[Index].Calibration *
+			    INA226->Shunt_Resistor));
+	}
+
+	*Current *= INA226->Phase_Multiplier;
+	*Power = *Voltage * *Current;
+	INA226_States[Index].Sampled = Now;
+	INA226_States[Index].Voltage = *Voltage;
+	INA226_States[Index].Current = *Current;
+	INA226_States[Index].Power = *Power;
+	return 0;
+}
+
+int
+Get_Power(INA226_t *INA226, int Mode, float *Voltage, float *Current, float *Power)
+{
+	INA226_Regs_t Regs;
+	float Current_LSB;
+	int Ret;
+
+	if (Mode != 0 && Mode != 1) {
+		SC_ERR("invalid mode for getting power");
+		return -1;
+	}
+
+	if (Mode == 0) {
+		/* Rails are also sampled by the energy accumulator thread */
+		(void) pthread_mutex_lock(&INA226_Lock);
+
+		/* Use the averaged readings of the ina2xx driver, if it is bound */
+		Ret = Hwmon_Get_Power(INA226, Voltage, Current, Power);
+		if (Ret != 0) {
+			Ret = Get_Power_Lean(INA226, Voltage, Current, Power);
+		}
+
+		(void) pthread_mutex_unlock(&INA226_Lock);
+		return Ret;
+	}
+
+	if (Read_INA226(INA226, &Regs) != 0) {
+		SC_ERR("failed to read INA226 registers");
+		return -1;
+	}
+
+	if (Regs.Calibration == 0) {
+		SC_ERR("invalid calibration register value of 0");
+		return -1;
+	}
+
+	Current_LSB = (0.00512 * 1000000) /
+		      (float)(Regs.Calibration * INA226->Shunt_Resistor);
+	SC_INFO("Calculating Current_LSB = %f", Current_LSB);
+
+	/* if Current is negative, use its absolute value */
+	*Current = (float)Regs.Current;
+	if (*Current > 0x7FFF) {
+		*Current -= 0x10000;
+		*Current = abs(*Current);
+	}
+
+	SC_INFO("Current before LSB scaling %f", *Current);
+	*Current = ((*Current) * Current_LSB);
+	SC_INFO("Current before phase multiplier scaling %f", *Current);
+	*Current *= INA226->Phase_Multiplier;
+
+	*Voltage = (float)Regs.Bus_Voltage;
+	SC_INFO("Voltage before LSB scaling %f", *Voltage);
+	*Voltage *= 1.25;       // 1.25 mV per bit
+	*Voltage /= 1000;
+
+	/* The power LSB has a fixed ratio to the Current_LSB of 25 */
+	*Power = ((float)Regs.Power * Current_LSB * 25);
+	SC_INFO("Power before phase multiplier scaling %f", *Power);
+	*Power *= INA226->Phase_Multiplier;
+
+	return 0;
+}
+
+/*
+ * Power Operations
+ */
+int Power_Ops(void)
+{
+	int Target_Index = -1;
+	INA226s_t *INA226s;
+	INA226_t *INA226;
+	INA226_Regs_t Regs = { 0 };
+	unsigned long int Value;
+	char *Next_Token;
+	float Voltage;
+	float Current;
+	float Power;
+	int Averages, Bus_CT, Shunt_CT;
+
+	INA226s = Plat_Devs->INA226s;
+	if (INA226s == NULL) {
+		SC_ERR("power operation is not supported");
+		return -1;
+	}
+
+	if (Command.CmdId == LISTPOWER) {
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			SC_PRINT("%s", INA226s->INA226[i].Name);
+		}
+
+		return 0;
+	}
+
+	if (Command.CmdId == GETINA226ALERTS) {
+		Print_INA226_Alerts();
+		return 0;
+	}
+
+	/* Validate the power target */
+	if (T_Flag == 0) {
+		SC_ERR("no power target");
+		return -1;
+	}
+
+	if (Command.CmdId == GETPOWER && strcmp(Target_Arg, "all") == 0) {
+		SC_PRINT("Target\tVoltage(V)\tCurrent(A)\tPower(W)");
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			if (Get_Power(&INA226s->INA226[i], 0, &Voltage, &Current,
+				      &Power) != 0) {
+				SC_PRINT("%s\tN/A\tN/A\tN/A",
+					 INA226s->INA226[i].Name);
+				continue;
+			}
+
+			SC_PRINT("%s\t%.4f\t%.4f\t%.4f", INA226s->INA226[i].Name,
+				 Voltage, Current, Power);
+		}
+
+		return 0;
+	}
 
 	for (int i = 0; i < INA226s->Numbers; i++) {
 		if (strcmp(Target_Arg, (char *)INA226s->INA226[i].Name) == 0) {
@@ -1912,6 +2368,48 @@ int Power_Ops(void)
 			return -1;
 		}
 
+		INA226_Uncalibrate(INA226);
+		if (Regs.Set_Registers & INA226_Configuration) {
+			INA226_Set_Sample_Period(INA226, Regs.Configuration);
+		}
+
+		break;
+
+	case GETINA226CONV:
+		if (Read_INA226(INA226, &Regs) != 0) {
+			SC_ERR("failed to read INA226");
+			return -1;
+		}
+
+		INA226_Set_Sample_Period(INA226, Regs.Configuration);
+		SC_PRINT("Averages:\t%d",
+			 INA226_Averages[(Regs.Configuration >> 9) & 0x7]);
+		SC_PRINT("Bus Conversion Time(us):\t%d",
+			 INA226_Conversion_Times[(Regs.Configuration >> 6) & 0x7]);
+		SC_PRINT("Shunt Conversion Time(us):\t%d",
+			 INA226_Conversion_Times[(Regs.Configuration >> 3) & 0x7]);
+		SC_PRINT("Sample Period(ms):\t%.3f",
+			 (float)INA226_States[Target_Index].Sample_Period / 1000);
+		break;
+
+	case SETINA226CONV:
+		if (V_Flag == 0) {
+			SC_ERR("no INA226 value");
+			return -1;
+		}
+
+		if (sscanf(Value_Arg, "%d %d %d", &Averages, &Bus_CT,
+			   &Shunt_CT) != 3) {
+			SC_ERR("value should be '<averages> <bus conversion time> "
+			       "<shunt conversion time>'");
+			return -1;
+		}
+
+		if (Configure_INA226(INA226, Averages, Bus_CT, Shunt_CT) != 0) {
+			SC_ERR("failed to configure INA226");
+			return -1;
+		}
+
 		break;
 
 	default:
@@ -1948,50 +2446,1840 @@ int Power_Domain_Ops(void)
 			SC_PRINT("%s", Power_Domains->Power_Domain[i].Name);
 		}
 
-		return 0;
+		return 0;
+	}
+
+	/* Validate the power domain target */
+	if (T_Flag == 0) {
+		SC_ERR("no power domain target");
+		return -1;
+	}
+
+	for (int i = 0; i < Power_Domains->Numbers; i++) {
+		if (strcmp(Target_Arg, (char *)Power_Domains->Power_Domain[i].Name) == 0) {
+			Target_Index = i;
+			Power_Domain = &Power_Domains->Power_Domain[Target_Index];
+			break;
+		}
+	}
+
+	if (Target_Index == -1) {
+		SC_ERR("invalid power domain target");
+		return -1;
+	}
+
+	switch (Command.CmdId) {
+	case POWERDOMAIN:
+		INA226s = Plat_Devs->INA226s;
+		for (int i = 0; i < Power_Domain->Numbers; i++) {
+			INA226 = &INA226s->INA226[Power_Domain->Rails[i]];
+			if (Get_Power(INA226, 0, &Voltage, &Current, &Power) == -1) {
+				SC_ERR("failed to get total power");
+				return -1;
+			}
+
+			Total_Power += Power;
+		}
+
+		SC_PRINT("Power(W):\t%.4f", Total_Power);
+		break;
+
+	default:
+		SC_ERR("invalid power domain command");
+		break;
+	}
+
+	return 0;
+}
+
+/*
+ * Energy Accumulation
+ *
+ * While any energy counter is running, a thread samples the power of every
+ * rail as often as the rail converts, and integrates it over CLOCK_MONOTONIC
+ * time with the trapezoidal rule.  A counter records the accumulated energy
+ * of each rail when it is started, so that any number of counters can
+ * measure overlapping windows.
+ */
+#define ENERGY_COUNTERS_MAX	8
+#define ENERGY_INTERVAL_MIN	0.002	// seconds
+#define ENERGY_INTERVAL_MAX	0.1	// seconds
+
+static struct {
+	pthread_mutex_t	Lock;
+	pthread_cond_t	Cond;
+	bool		Started;
+	int		Running;
+	bool		Valid[LITEMS_MAX];
+	double		Energy[LITEMS_MAX];	// in Joules
+	double		Power[LITEMS_MAX];
+	double		Sampled[LITEMS_MAX];
+} Energy = {
+	.Lock = PTHREAD_MUTEX_INITIALIZER,
+	.Cond = PTHREAD_COND_INITIALIZER,
+};
+
+static struct {
+	char		Name[STRLEN_MAX];
+	bool		Running;
+	double		Start;
+	double		Stop;
+	double		Base[LITEMS_MAX];
+	double		Total[LITEMS_MAX];
+} Energy_Counters[ENERGY_COUNTERS_MAX];
+
+/*
+ * Energy of a rail up to 'Now', extrapolated from its last sample.  Called
+ * with Energy.Lock held.
+ */
+static double
+Energy_Now(int Rail, double Now)
+{
+	if (!Energy.Valid[Rail]) {
+		return Energy.Energy[Rail];
+	}
+
+	return Energy.Energy[Rail] + (Energy.Power[Rail] *
+	       (Now - Energy.Sampled[Rail]));
+}
+
+static void *
+Energy_Sampler(void *Arg)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	double Due[LITEMS_MAX] = { 0 };
+	double Now, Next, Interval;
+	struct timespec Wakeup;
+	float Voltage, Current, Power;
+	long Sample_Period;
+	int Ret;
+
+	(void) Arg;
+	Driver_Quiet(true);
+	while (1) {
+		(void) pthread_mutex_lock(&Energy.Lock);
+		while (Energy.Running == 0) {
+			for (int i = 0; i < INA226s->Numbers; i++) {
+				Energy.Valid[i] = false;
+			}
+
+			(void) pthread_cond_wait(&Energy.Cond, &Energy.Lock);
+		}
+
+		(void) pthread_mutex_unlock(&Energy.Lock);
+		Next = ((double)Monotonic_Nanoseconds() / 1000000000) + ENERGY_INTERVAL_MAX;
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			Now = ((double)Monotonic_Nanoseconds() / 1000000000);
+			if (Now >= Due[i]) {
+				Ret = Get_Power(&INA226s->INA226[i], 0, &Voltage,
+						&Current, &Power);
+				(void) pthread_mutex_lock(&INA226_Lock);
+				Sample_Period = INA226_States[i].Sample_Period;
+				(void) pthread_mutex_unlock(&INA226_Lock);
+				Interval = ((Ret == 0) ? ((double)Sample_Period / 1000000) :
+					    ENERGY_INTERVAL_MAX);
+				Now = ((double)Monotonic_Nanoseconds() / 1000000000);
+				(void) pthread_mutex_lock(&Energy.Lock);
+				if (Ret != 0) {
+					if (Energy.Valid[i]) {
+						SC_INFO("failed to sample %s",
+							INA226s->INA226[i].Name);
+					}
+
+					Energy.Valid[i] = false;
+				} else {
+					if (Energy.Valid[i]) {
+						Energy.Energy[i] += ((Energy.Power[i] + Power) / 2) *
+								    (Now - Energy.Sampled[i]);
+					}
+
+					Energy.Power[i] = Power;
+					Energy.Sampled[i] = Now;
+					Energy.Valid[i] = true;
+				}
+
+				(void) pthread_mutex_unlock(&Energy.Lock);
+				if (Interval < ENERGY_INTERVAL_MIN) {
+					Interval = ENERGY_INTERVAL_MIN;
+				}
+
+				Due[i] = Now + Interval;
+			}
+
+			if (Due[i] < Next) {
+				Next = Due[i];
+			}
+		}
+
+		Wakeup.tv_sec = (time_t)Next;
+		Wakeup.tv_nsec = (long)((Next - Wakeup.tv_sec) * 1000000000);
+		(void) clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Wakeup, NULL);
+	}
+
+	return NULL;
+}
+
+static int
+Energy_Counter(char *Name, bool Create)
+{
+	int Free = -1;
+
+	for (int i = 0; i < ENERGY_COUNTERS_MAX; i++) {
+		if (strcmp(Energy_Counters[i].Name, Name) == 0) {
+			return i;
+		}
+
+		/* Prefer an unused counter to a stopped one */
+		if (!Energy_Counters[i].Running &&
+		    (Free == -1 || Energy_Counters[i].Name[0] == '\0')) {
+			Free = i;
+		}
+	}
+
+	if (!Create) {
+		SC_ERR("invalid energy counter");
+		return -1;
+	}
+
+	if (Free == -1) {
+		SC_ERR("all %d energy counters are running", ENERGY_COUNTERS_MAX);
+		return -1;
+	}
+
+	(void) snprintf(Energy_Counters[Free].Name, STRLEN_MAX, "%s", Name);
+	Energy_Counters[Free].Running = false;
+	return Free;
+}
+
+static void
+Print_Energy(char *Name, double Joules, double Elapsed)
+{
+	SC_PRINT("%s\t%.6f\t%.4f", Name, Joules,
+		 ((Elapsed > 0) ? (Joules / Elapsed) : 0));
+}
+
+/*
+ * Energy Operations
+ */
+int Energy_Ops(void)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	Power_Domains_t *Power_Domains = Plat_Devs->Power_Domains;
+	Power_Domain_t *Power_Domain;
+	pthread_t Thread;
+	double Joules[LITEMS_MAX];
+	double Domain_Joules;
+	double Now, Elapsed;
+	int Counter;
+	int Ret = 0;
+
+	if (INA226s == NULL) {
+		SC_ERR("energy operation is not supported");
+		return -1;
+	}
+
+	/* The target is the name of the counter */
+	if (T_Flag == 0) {
+		SC_ERR("no energy counter target");
+		return -1;
+	}
+
+	(void) pthread_mutex_lock(&Energy.Lock);
+	Counter = Energy_Counter(Target_Arg, (Command.CmdId == STARTENERGY));
+	if (Counter == -1) {
+		(void) pthread_mutex_unlock(&Energy.Lock);
+		return -1;
+	}
+
+	Now = ((double)Monotonic_Nanoseconds() / 1000000000);
+	switch (Command.CmdId) {
+	case STARTENERGY:
+		if (!Energy.Started) {
+			if (pthread_create(&Thread, NULL, Energy_Sampler, NULL) != 0) {
+				SC_ERR("failed to start energy accumulation: %m");
+				Ret = -1;
+				break;
+			}
+
+			(void) pthread_detach(Thread);
+			Energy.Started = true;
+		}
+
+		/* Starting a running counter restarts it */
+		if (!Energy_Counters[Counter].Running) {
+			Energy_Counters[Counter].Running = true;
+			Energy.Running++;
+			(void) pthread_cond_signal(&Energy.Cond);
+		}
+
+		Energy_Counters[Counter].Start = Now;
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			Energy_Counters[Counter].Base[i] = Energy_Now(i, Now);
+		}
+
+		break;
+
+	case STOPENERGY:
+		if (!Energy_Counters[Counter].Running) {
+			SC_ERR("energy counter is not running");
+			Ret = -1;
+			break;
+		}
+
+		Energy_Counters[Counter].Stop = Now;
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			Energy_Counters[Counter].Total[i] = Energy_Now(i, Now) -
+							    Energy_Counters[Counter].Base[i];
+		}
+
+		Energy_Counters[Counter].Running = false;
+		Energy.Running--;
+		break;
+
+	case GETENERGY:
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			Joules[i] = (Energy_Counters[Counter].Running ?
+				     (Energy_Now(i, Now) - Energy_Counters[Counter].Base[i]) :
+				     Energy_Counters[Counter].Total[i]);
+		}
+
+		Elapsed = ((Energy_Counters[Counter].Running ? Now :
+			   Energy_Counters[Counter].Stop) - Energy_Counters[Counter].Start);
+		SC_PRINT("Elapsed Time(s):\t%.3f", Elapsed);
+		SC_PRINT("Target\tEnergy(J)\tAverage Power(W)");
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			Print_Energy(INA226s->INA226[i].Name, Joules[i], Elapsed);
+		}
+
+		for (int i = 0; Power_Domains != NULL && i < Power_Domains->Numbers; i++) {
+			Power_Domain = &Power_Domains->Power_Domain[i];
+			Domain_Joules = 0;
+			for (int j = 0; j < Power_Domain->Numbers; j++) {
+				Domain_Joules += Joules[Power_Domain->Rails[j]];
+			}
+
+			Print_Energy(Power_Domain->Name, Domain_Joules, Elapsed);
+		}
+
+		break;
+
+	default:
+		SC_ERR("invalid energy command");
+		break;
+	}
+
+	(void) pthread_mutex_unlock(&Energy.Lock);
+	return Ret;
+}
+
+int Derived_Ops(void)
+{
+	Deriveds_t *Deriveds = Plat_Devs->Deriveds;
+	int Indexes[ITEMS_MAX];
+	float Values[ITEMS_MAX];
+	int Numbers = 0;
+
+	if (Deriveds == NULL) {
+		SC_ERR("derived sensor operation is not supported");
+		return -1;
+	}
+
+	if (Command.CmdId == LISTDERIVED) {
+		for (int i = 0; i < Deriveds->Numbers; i++) {
+			SC_PRINT("%s", Deriveds->Derived[i].Name);
+		}
+
+		return 0;
+	}
+
+	/* Validate the derived sensor target */
+	if (T_Flag == 0) {
+		SC_ERR("no derived sensor target");
+		return -1;
+	}
+
+	for (int i = 0; i < Deriveds->Numbers; i++) {
+		if (strcmp(Target_Arg, "all") == 0 ||
+		    strcmp(Target_Arg, Deriveds->Derived[i].Name) == 0) {
+			Indexes[Numbers++] = i;
+		}
+	}
+
+	if (Numbers == 0) {
+		SC_ERR("invalid derived sensor target");
+		return -1;
+	}
+
+	/* All the targets are evaluated against the same sensor readings */
+	if (Derived_Evaluate(Indexes, Numbers, Values) != 0) {
+		SC_ERR("failed to evaluate derived sensors");
+		return -1;
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		if (isnan(Values[i])) {
+			SC_PRINT("%s:\tN/A", Deriveds->Derived[Indexes[i]].Name);
+		} else {
+			SC_PRINT("%s:\t%.4f", Deriveds->Derived[Indexes[i]].Name, Values[i]);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Synchronized Power Snapshot
+ *
+ * Every INA226 is switched to triggered mode, which starts a conversion of
+ * shunt and bus voltages as soon as its 'Configuration' register is written.
+ * The triggers of the rails on each I2C bus are issued back to back by the
+ * worker of the bus, and the buses are triggered in parallel.  Once the
+ * longest conversion is done, the results are read and continuous mode is
+ * restored.  The conversion of a rail starts within the time window of its
+ * trigger write, which bounds the skew between the readings.  A rail whose
+ * trigger or read fails is reported as N/A, along with its power domains.
+ */
+typedef struct {
+	I2C_Sequence_t	Sequence;
+	int		Rails[ITEMS_MAX];
+	long long	Submitted;
+	long long	Done[ITEMS_MAX];	// in nano-seconds
+} Snapshot_Trigger_t;
+
+typedef struct {
+	I2C_Sequence_t	Sequence;
+	int		Shunt_Op;
+	int		Bus_Op;
+} Snapshot_Read_t;
+
+static int
+Snapshot_Trigger_Done(I2C_Sequence_t *Sequence, int Index)
+{
+	((Snapshot_Trigger_t *)Sequence)->Done[Index] = Monotonic_Nanoseconds();
+	return 0;
+}
+
+/*
+ * Queue the write of 'Configuration' register with 'Mode' for a rail.
+ * Rails on the same bus share a trigger sequence, as long as it has room.
+ */
+static Snapshot_Trigger_t *
+Snapshot_Trigger_Add(Snapshot_Trigger_t **Triggers, int *Numbers, int Rail,
+		     int Mode)
+{
+	INA226_t *INA226 = &Plat_Devs->INA226s->INA226[Rail];
+	Snapshot_Trigger_t *Trigger = NULL;
+	unsigned short Configuration;
+	unsigned char Buffer[3];
+
+	for (int i = 0; i < *Numbers; i++) {
+		if (strcmp(Triggers[i]->Sequence.I2C_Bus, INA226->I2C_Bus) == 0 &&
+		    Triggers[i]->Sequence.Numbers < ITEMS_MAX) {
+			Trigger = Triggers[i];
+		}
+	}
+
+	if (Trigger == NULL) {
+		Trigger = (Snapshot_Trigger_t *)calloc(1, sizeof(Snapshot_Trigger_t));
+		if (Trigger == NULL) {
+			SC_ERR("failed to allocate snapshot sequence: %m");
+			return NULL;
+		}
+
+		Trigger->Sequence.I2C_Bus = INA226->I2C_Bus;
+		Trigger->Sequence.Op_Done = Snapshot_Trigger_Done;
+		Triggers[(*Numbers)++] = Trigger;
+	}
+
+	Configuration = ((INA226_States[Rail].Configuration & ~0x7) | Mode);
+	Buffer[0] = 0x0;   // Configuration Register(00h)
+	Buffer[1] = (Configuration >> 8);
+	Buffer[2] = (Configuration & 0xFF);
+	Trigger->Rails[Trigger->Sequence.Numbers] = Rail;
+	(void) I2C_Sequence_Add(&Trigger->Sequence, I2C_OP_WRITE,
+				INA226->I2C_Address, 3, Buffer, 0);
+	return Trigger;
+}
+
+static int
+Snapshot_Run(Snapshot_Trigger_t **Triggers, int Numbers)
+{
+	int Ret = 0;
+
+	for (int i = 0; i < Numbers; i++) {
+		Triggers[i]->Submitted = Monotonic_Nanoseconds();
+		if (I2C_Submit(&Triggers[i]->Sequence) != 0) {
+			Triggers[i]->Sequence.Status = -1;
+			Triggers[i]->Sequence.Failed_Op = -1;
+			Triggers[i]->Sequence.Completed = true;
+		}
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		if (I2C_Wait(&Triggers[i]->Sequence) != 0) {
+			Ret = -1;
+		}
+	}
+
+	return Ret;
+}
+
+/*
+ * Power Snapshot Operations
+ */
+int Power_Snapshot_Ops(void)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	Power_Domains_t *Power_Domains = Plat_Devs->Power_Domains;
+	Power_Domain_t *Power_Domain;
+	Snapshot_Trigger_t *Triggers[LITEMS_MAX];
+	Snapshot_Trigger_t *Restores[LITEMS_MAX];
+	Snapshot_Read_t *Reads[LITEMS_MAX] = { NULL };
+	long long Start[LITEMS_MAX], End[LITEMS_MAX];
+	long long First = -1, Last = 0, Wake, Conversion = 0;
+	float Voltage[LITEMS_MAX], Current[LITEMS_MAX];
+	bool Failed[LITEMS_MAX] = { false };
+	float Total_Power;
+	unsigned char Buffer[1];
+	struct timespec Wakeup, Real;
+	char Time[STRLEN_MAX];
+	struct tm TM;
+	Snapshot_Trigger_t *Trigger;
+	Snapshot_Read_t *Read;
+	unsigned short Configuration;
+	long long Period;
+	int Trigger_Numbers = 0, Restore_Numbers = 0;
+	int Failures = 0;
+	int Ret = -1;
+
+	if (INA226s == NULL) {
+		SC_ERR("power snapshot operation is not supported");
+		return -1;
+	}
+
+	/* Keep other readers away from the rails while they are triggered */
+	(void) pthread_mutex_lock(&INA226_Lock);
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		if (Snapshot_Trigger_Add(Triggers, &Trigger_Numbers, i,
+					 0x3) == NULL) {   // Triggered
+			goto Out;
+		}
+
+		/* A triggered conversion takes both shunt and bus voltages */
+		Configuration = INA226_States[i].Configuration;
+		Period = (INA226_Averages[(Configuration >> 9) & 0x7] *
+			  (INA226_Conversion_Times[(Configuration >> 6) & 0x7] +
+			   INA226_Conversion_Times[(Configuration >> 3) & 0x7]));
+		if (Period > Conversion) {
+			Conversion = Period;
+		}
+	}
+
+	(void) clock_gettime(CLOCK_REALTIME, &Real);
+	(void) Snapshot_Run(Triggers, Trigger_Numbers);
+	for (int i = 0; i < Trigger_Numbers; i++) {
+		Trigger = Triggers[i];
+		for (int j = 0; j < Trigger->Sequence.Numbers; j++) {
+			if (I2C_Op_Failed(&Trigger->Sequence, j)) {
+				Failed[Trigger->Rails[j]] = true;
+				Failures++;
+				continue;
+			}
+
+			Start[Trigger->Rails[j]] = ((j == 0) ? Trigger->Submitted :
+						    Trigger->Done[j - 1]);
+			End[Trigger->Rails[j]] = Trigger->Done[j];
+			if (First == -1 || Start[Trigger->Rails[j]] < First) {
+				First = Start[Trigger->Rails[j]];
+			}
+
+			if (End[Trigger->Rails[j]] > Last) {
+				Last = End[Trigger->Rails[j]];
+			}
+		}
+	}
+
+	if (Failures == INA226s->Numbers) {
+		SC_ERR("failed to trigger conversions");
+		goto Restore;
+	}
+
+	/* Wait for the longest conversion, with a margin for clock tolerance */
+	Wake = Last + (Conversion * 1100) + 1000000;
+	Wakeup.tv_sec = Wake / 1000000000;
+	Wakeup.tv_nsec = Wake % 1000000000;
+	(void) clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Wakeup, NULL);
+
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		if (Failed[i]) {
+			continue;
+		}
+
+		Read = (Snapshot_Read_t *)calloc(1, sizeof(Snapshot_Read_t));
+		if (Read == NULL) {
+			SC_ERR("failed to allocate snapshot sequence: %m");
+			goto Restore;
+		}
+
+		Reads[i] = Read;
+		Read->Sequence.I2C_Bus = INA226s->INA226[i].I2C_Bus;
+		Buffer[0] = 0x1;   // Shunt Voltage Register(01h)
+		Read->Shunt_Op = I2C_Sequence_Add(&Read->Sequence, I2C_OP_READ,
+						  INA226s->INA226[i].I2C_Address,
+						  1, Buffer, 2);
+		Buffer[0] = 0x2;   // Bus Voltage Register(02h)
+		Read->Bus_Op = I2C_Sequence_Add(&Read->Sequence, I2C_OP_READ,
+						INA226s->INA226[i].I2C_Address,
+						1, Buffer, 2);
+	}
+
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		if (Reads[i] != NULL && I2C_Submit(&Reads[i]->Sequence) != 0) {
+			Reads[i]->Sequence.Status = -1;
+			Reads[i]->Sequence.Completed = true;
+		}
+	}
+
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		if (Reads[i] != NULL && I2C_Wait(&Reads[i]->Sequence) != 0) {
+			Failed[i] = true;
+			Failures++;
+		}
+	}
+
+	if (Failures == INA226s->Numbers) {
+		SC_ERR("failed to read conversions");
+		goto Restore;
+	}
+
+	Ret = 0;
+
+	(void) localtime_r(&Real.tv_sec, &TM);
+	(void) strftime(Time, sizeof(Time), "%F %T", &TM);
+	SC_PRINT("Time:\t%s.%06ld", Time, Real.tv_nsec / 1000);
+	SC_PRINT("Skew Bound(us):\t%.1f", (float)(Last - First) / 1000);
+	SC_PRINT("Target\tVoltage(V)\tCurrent(A)\tPower(W)\tOffset(us)\tBound(us)");
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		if (Failed[i]) {
+			SC_PRINT("%s\tN/A\tN/A\tN/A\tN/A\tN/A", INA226s->INA226[i].Name);
+			continue;
+		}
+
+		Read = Reads[i];
+		Voltage[i] = (float)((Read->Sequence.Op[Read->Bus_Op].In[0] << 8) |
+				     Read->Sequence.Op[Read->Bus_Op].In[1]) * 1.25 / 1000;
+		Current[i] = fabs((short)((Read->Sequence.Op[Read->Shunt_Op].In[0] << 8) |
+					  Read->Sequence.Op[Read->Shunt_Op].In[1]) *
+				  2.5 / INA226s->INA226[i].Shunt_Resistor) *
+			     INA226s->INA226[i].Phase_Multiplier;
+		SC_PRINT("%s\t%.4f\t%.4f\t%.4f\t%.1f\t%.1f", INA226s->INA226[i].Name,
+			 Voltage[i], Current[i], (Voltage[i] * Current[i]),
+			 (float)(Start[i] - First) / 1000,
+			 (float)(End[i] - Start[i]) / 1000);
+	}
+
+	for (int i = 0; Power_Domains != NULL && i < Power_Domains->Numbers; i++) {
+		Power_Domain = &Power_Domains->Power_Domain[i];
+		Total_Power = 0;
+		for (int j = 0; j < Power_Domain->Numbers; j++) {
+			if (Failed[Power_Domain->Rails[j]]) {
+				Total_Power = NAN;
+				break;
+			}
+
+			Total_Power += (Voltage[Power_Domain->Rails[j]] *
+					Current[Power_Domain->Rails[j]]);
+		}
+
+		if (isnan(Total_Power)) {
+			SC_PRINT("%s\t\t\tN/A", Power_Domain->Name);
+		} else {
+			SC_PRINT("%s\t\t\t%.4f", Power_Domain->Name, Total_Power);
+		}
+	}
+
+Restore:
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		if (Snapshot_Trigger_Add(Restores, &Restore_Numbers, i,
+				 (INA226_States[i].Configuration & 0x7)) == NULL) {
+			Ret = -1;
+			break;
+		}
+
+		INA226_States[i].Sampled.tv_sec = 0;
+		INA226_States[i].Sampled.tv_nsec = 0;
+	}
+
+	if (Snapshot_Run(Restores, Restore_Numbers) != 0) {
+		SC_ERR("failed to restore continuous conversions");
+		Ret = -1;
+	}
+
+	for (int i = 0; i < Restore_Numbers; i++) {
+		free(Restores[i]);
+	}
+
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		free(Reads[i]);
+	}
+
+Out:
+	for (int i = 0; i < Trigger_Numbers; i++) {
+		free(Triggers[i]);
+	}
+
+	(void) pthread_mutex_unlock(&INA226_Lock);
+	return Ret;
+}
+
+/*
+ * Voltage Snapshot
+ *
+ * The regulators are grouped by I2C bus, device address, and page.  The
+ * regulators of each bus are read by one sequence on the worker of the bus,
+ * which selects each page once, and the buses are read in parallel.  READ_VOUT
+ * is decoded in the VOUT format probed once for each regulator.  Regulators
+ * bound to a hwmon driver are read from their sysfs attributes instead.
+ */
+typedef struct {
+	I2C_Sequence_t	Sequence;
+	int		Address;
+	int		Page;
+} Voltage_Snapshot_t;
+
+static int
+Voltage_Snapshot_Compare(const void *Index1, const void *Index2)
+{
+	Voltage_t *Regulator1 = &Plat_Devs->Voltages->Voltage[*(const int *)Index1];
+	Voltage_t *Regulator2 = &Plat_Devs->Voltages->Voltage[*(const int *)Index2];
+	int Ret;
+
+	Ret = strcmp(Regulator1->I2C_Bus, Regulator2->I2C_Bus);
+	if (Ret == 0) {
+		Ret = Regulator1->I2C_Address - Regulator2->I2C_Address;
+	}
+
+	if (Ret == 0) {
+		Ret = Regulator1->Page_Select - Regulator2->Page_Select;
+	}
+
+	return Ret;
+}
+
+/*
+ * Voltage Snapshot Operations
+ */
+int Voltage_Snapshot_Ops(void)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	Voltage_Snapshot_t *Snapshots[LITEMS_MAX];
+	Voltage_Snapshot_t *Snapshot = NULL;
+	Voltage_Snapshot_t *Of[LITEMS_MAX] = { NULL };
+	Voltage_t *Regulator;
+	int Order[LITEMS_MAX];
+	int Alias[LITEMS_MAX];
+	int Vout_Op[LITEMS_MAX];
+	bool Valid[LITEMS_MAX] = { false };
+	float Voltage[LITEMS_MAX];
+	unsigned char Buffer[2];
+	unsigned char *In;
+	PMBus_Caps_t *Caps[LITEMS_MAX];
+	struct timespec Real;
+	char Time[STRLEN_MAX];
+	struct tm TM;
+	long long Start;
+	int Numbers = 0, Transactions = 0;
+	int Index, Previous = -1;
+
+	if (Voltages == NULL) {
+		SC_ERR("voltage snapshot operation is not supported");
+		return -1;
+	}
+
+	(void) clock_gettime(CLOCK_REALTIME, &Real);
+	Start = Monotonic_Nanoseconds();
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		Order[i] = i;
+		Alias[i] = -1;
+		Caps[i] = NULL;
+		Valid[i] = (Hwmon_Get_Voltage(&Voltages->Voltage[i], &Voltage[i]) == 0);
+		if (!Valid[i]) {
+			Caps[i] = Driver_PMBus_Caps(&Voltages->Voltage[i]);
+		}
+	}
+
+	qsort(Order, Voltages->Numbers, sizeof(int), Voltage_Snapshot_Compare);
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		Index = Order[i];
+		Regulator = &Voltages->Voltage[Index];
+		if (Valid[Index] || Caps[Index] == NULL) {
+			continue;
+		}
+
+		/* Another target on the same page of the same device */
+		if (Previous != -1 && Voltage_Snapshot_Compare(&Previous, &Index) == 0) {
+			Alias[Index] = Previous;
+			continue;
+		}
+
+		Previous = Index;
+		if (Snapshot == NULL ||
+		    strcmp(Snapshot->Sequence.I2C_Bus, Regulator->I2C_Bus) != 0 ||
+		    (Snapshot->Sequence.Numbers + 2) > ITEMS_MAX) {
+			Snapshot = (Voltage_Snapshot_t *)calloc(1, sizeof(Voltage_Snapshot_t));
+			if (Snapshot == NULL) {
+				SC_ERR("failed to allocate snapshot sequence: %m");
+				for (int j = 0; j < Numbers; j++) {
+					free(Snapshots[j]);
+				}
+
+				return -1;
+			}
+
+			Snapshot->Sequence.I2C_Bus = Regulator->I2C_Bus;
+			Snapshot->Address = -1;
+			Snapshots[Numbers++] = Snapshot;
+		}
+
+		Of[Index] = Snapshot;
+		if (Regulator->Page_Select != -1 &&
+		    (Snapshot->Address != Regulator->I2C_Address ||
+		     Snapshot->Page != Regulator->Page_Select)) {
+			Buffer[0] = PMBUS_PAGE;
+			Buffer[1] = Regulator->Page_Select;
+			(void) I2C_Sequence_Add(&Snapshot->Sequence, I2C_OP_WRITE,
+						Regulator->I2C_Address, 2, Buffer, 0);
+			Snapshot->Address = Regulator->I2C_Address;
+			Snapshot->Page = Regulator->Page_Select;
+		}
+
+		Buffer[0] = PMBUS_READ_VOUT;
+		Vout_Op[Index] = I2C_Sequence_Add(&Snapshot->Sequence, I2C_OP_READ,
+						  Regulator->I2C_Address, 1, Buffer, 2);
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		Transactions += Snapshots[i]->Sequence.Numbers;
+		if (I2C_Submit(&Snapshots[i]->Sequence) != 0) {
+			Snapshots[i]->Sequence.Status = -1;
+			Snapshots[i]->Sequence.Failed_Op = -1;
+			Snapshots[i]->Sequence.Completed = true;
+		}
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		(void) I2C_Wait(&Snapshots[i]->Sequence);
+	}
+
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		Regulator = &Voltages->Voltage[i];
+		if (Of[i] == NULL) {
+			continue;
+		}
+
+		if (I2C_Op_Failed(&Of[i]->Sequence, Vout_Op[i])) {
+			SC_ERR("failed to read the voltage of %s", Regulator->Name);
+			continue;
+		}
+
+		In = Of[i]->Sequence.Op[Vout_Op[i]].In;
+		Voltage[i] = Driver_PMBus_Decode_Vout(Caps[i], ((In[1] << 8) | In[0]));
+		Valid[i] = !isnan(Voltage[i]);
+	}
+
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		if (Alias[i] != -1) {
+			Voltage[i] = Voltage[Alias[i]];
+			Valid[i] = Valid[Alias[i]];
+		}
+	}
+
+	(void) localtime_r(&Real.tv_sec, &TM);
+	(void) strftime(Time, sizeof(Time), "%F %T", &TM);
+	SC_PRINT("Time:\t%s.%06ld", Time, Real.tv_nsec / 1000);
+	SC_PRINT("Duration(us):\t%.1f", (float)(Monotonic_Nanoseconds() - Start) / 1000);
+	SC_PRINT("Transactions:\t%d", Transactions);
+	SC_PRINT("Target\tVoltage(V)");
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		Regulator = &Voltages->Voltage[i];
+		if (!Valid[i]) {
+			SC_PRINT("%s\tN/A", Regulator->Name);
+			continue;
+		}
+
+		if (Regulator->Voltage_Multiplier != 0) {
+			Voltage[i] *= Regulator->Voltage_Multiplier;
+		}
+
+		SC_PRINT("%s\t%.3f", Regulator->Name, Voltage[i]);
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		free(Snapshots[i]);
+	}
+
+	return 0;
+}
+
+/*
+ * Regulator Telemetry Operations
+ *
+ * The PMBus telemetry commands that each regulator supports are discovered
+ * the first time it is read.  The regulators on each I2C bus are then read
+ * over one open file descriptor of the bus.
+ */
+int Telemetry_Ops(void)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	Voltage_t *Regulator;
+	Driver_Plan_t *Plan;
+	float Values[LITEMS_MAX][PMBUS_TELEMETRIES];
+	bool Selected[LITEMS_MAX] = { false };
+	bool Done[LITEMS_MAX] = { false };
+	char Line[SYSCMD_MAX];
+	int Numbers = 0;
+	int Length;
+	int FD;
+	int Ret;
+
+	if (Voltages == NULL) {
+		SC_ERR("telemetry operation is not supported");
+		return -1;
+	}
+
+	/* Validate the regulator target */
+	if (T_Flag == 0) {
+		SC_ERR("no regulator target");
+		return -1;
+	}
+
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		if (strcmp(Target_Arg, "all") == 0 ||
+		    strcmp(Target_Arg, Voltages->Voltage[i].Name) == 0) {
+			Selected[i] = true;
+			Numbers++;
+		}
+
+		for (int j = 0; j < PMBUS_TELEMETRIES; j++) {
+			Values[i][j] = NAN;
+		}
+
+		if (Selected[i]) {
+			Done[i] = (Hwmon_Get_Telemetry(&Voltages->Voltage[i],
+						       Values[i]) == 0);
+		}
+	}
+
+	if (Numbers == 0) {
+		SC_ERR("invalid regulator target");
+		return -1;
+	}
+
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		if (!Selected[i] || Done[i]) {
+			continue;
+		}
+
+		FD = I2C_Open(Voltages->Voltage[i].I2C_Bus);
+		if (FD < 0) {
+			SC_ERR("unable to access the I2C bus %s: %m",
+			       Voltages->Voltage[i].I2C_Bus);
+		}
+
+		for (int j = i; j < Voltages->Numbers; j++) {
+			Regulator = &Voltages->Voltage[j];
+			if (!Selected[j] || Done[j] ||
+			    strcmp(Regulator->I2C_Bus, Voltages->Voltage[i].I2C_Bus) != 0) {
+				continue;
+			}
+
+			Done[j] = true;
+			if (FD < 0) {
+				continue;
+			}
+
+			Plan = Driver_PMBus_Telemetry_Plan(Regulator, FD);
+			Ret = -1;
+			if (Plan != NULL && I2C_Bus_Lock(Regulator->I2C_Bus) == 0) {
+				Ret = Driver_Execute(Plan, FD, NULL, Values[j]);
+				I2C_Bus_Unlock(Regulator->I2C_Bus);
+			}
+
+			if (Ret != 0) {
+				SC_ERR("failed to get telemetry of %s", Regulator->Name);
+				for (int k = 0; k < PMBUS_TELEMETRIES; k++) {
+					Values[j][k] = NAN;
+				}
+			}
+		}
+
+		if (FD >= 0) {
+			(void) close(FD);
+		}
+	}
+
+	SC_PRINT("Target\tVIN(V)\tVOUT(V)\tIOUT(A)\tTemperature(C)\tPOUT(W)\tPIN(W)");
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		if (!Selected[i]) {
+			continue;
+		}
+
+		Regulator = &Voltages->Voltage[i];
+		if (Regulator->Voltage_Multiplier != 0) {
+			Values[i][PMBUS_TELEMETRY_VOUT] *= Regulator->Voltage_Multiplier;
+		}
+
+		Length = snprintf(Line, sizeof(Line), "%s", Regulator->Name);
+		for (int j = PMBUS_TELEMETRY_VIN; j < PMBUS_TELEMETRIES; j++) {
+			if (isnan(Values[i][j])) {
+				Length += snprintf(&Line[Length], (sizeof(Line) - Length),
+						   "\tN/A");
+			} else {
+				Length += snprintf(&Line[Length], (sizeof(Line) - Length),
+						   "\t%.3f", Values[i][j]);
+			}
+		}
+
+		SC_PRINT("%s", Line);
+	}
+
+	return 0;
+}
+
+/*
+ * Phase Telemetry Operations
+ *
+ * Regulators that are multi-phase controllers declare the number of their
+ * 'Phases' in the board JSON.
+ */
+int Phase_Ops(void)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	Voltage_t *Regulator;
+	float Current[ITEMS_MAX];
+	float Temperature[ITEMS_MAX];
+	char Line[STRLEN_MAX];
+	int Numbers = 0;
+	int Length;
+	int Ret = 0;
+
+	if (Voltages == NULL) {
+		SC_ERR("phase telemetry operation is not supported");
+		return -1;
+	}
+
+	/* Validate the regulator target */
+	if (T_Flag == 0) {
+		SC_ERR("no regulator target");
+		return -1;
+	}
+
+	for (int i = 0; i < Voltages->Numbers; i++) {
+		Regulator = &Voltages->Voltage[i];
+		if (Regulator->Phases <= 0 ||
+		    (strcmp(Target_Arg, "all") != 0 &&
+		     strcmp(Target_Arg, Regulator->Name) != 0)) {
+			continue;
+		}
+
+		if (Numbers++ == 0) {
+			SC_PRINT("Target\tPhase\tIOUT(A)\tTemperature(C)");
+		}
+
+		if (Driver_PMBus_Phases(Regulator, Current, Temperature) != 0) {
+			SC_ERR("failed to get phase telemetry of %s", Regulator->Name);
+			Ret = -1;
+			continue;
+		}
+
+		for (int j = 0; j < Regulator->Phases; j++) {
+			Length = snprintf(Line, sizeof(Line), "%s\t%d", Regulator->Name, j);
+			if (isnan(Current[j])) {
+				Length += snprintf(&Line[Length], (sizeof(Line) - Length), "\tN/A");
+			} else {
+				Length += snprintf(&Line[Length], (sizeof(Line) - Length), "\t%.3f",
+						   Current[j]);
+			}
+
+			if (isnan(Temperature[j])) {
+				(void) snprintf(&Line[Length], (sizeof(Line) - Length), "\tN/A");
+			} else {
+				(void) snprintf(&Line[Length], (sizeof(Line) - Length), "\t%.3f",
+						Temperature[j]);
+			}
+
+			SC_PRINT("%s", Line);
+		}
+	}
+
+	if (Numbers == 0) {
+		SC_ERR("invalid multi-phase controller target");
+		return -1;
+	}
+
+	return Ret;
+}
+
+/*
+ * Voltage Sweep
+ *
+ * The OV and UV limits of the swept regulators are widened once to cover the
+ * whole range, and then only VOUT_COMMAND is written at each step, so the
+ * outputs stay enabled throughout the sweep.  The values are encoded in the
+ * cached VOUT format of each regulator.  The regulators are set and read
+ * back in parallel, with one sequence per regulator.  The original
+ * VOUT_COMMAND and limits are restored at the end, on a failure, or when the
+ * client goes away.
+ */
+#define SWEEP_STEPS_MAX		1000
+#define SWEEP_SETTLE_MAX	60000
+
+static const unsigned char Sweep_Limit[] = {
+	PMBUS_VOUT_OV_FAULT_LIMIT,
+	PMBUS_VOUT_OV_WARN_LIMIT,
+	PMBUS_VOUT_UV_WARN_LIMIT,
+	PMBUS_VOUT_UV_FAULT_LIMIT,
+};
+
+#define SWEEP_LIMITS	(int)(sizeof(Sweep_Limit) / sizeof(Sweep_Limit[0]))
+
+/* Fault and warning margins of each limit relative to the swept range */
+static const float Sweep_Margin[SWEEP_LIMITS] = { 1.1, 1.03, 0.97, 0.9 };
+
+typedef struct {
+	I2C_Sequence_t	Sequence;
+	Voltage_t	*Regulator;
+	PMBus_Caps_t	*Caps;
+	bool		Saved;
+	bool		Widened;
+	int		Vout_Command_Op;
+	int		Limit_Op;
+	unsigned int	Vout_Command;
+	unsigned int	Limit[SWEEP_LIMITS];
+	float		Readback;
+} Sweep_Rail_t;
+
+typedef struct {
+	INA226_t	*INA226;
+	Power_Domain_t	*Power_Domain;
+} Sweep_Measure_t;
+
+static void
+Sweep_Begin(Sweep_Rail_t *Rail)
+{
+	Voltage_t *Regulator = Rail->Regulator;
+	unsigned char Buffer[2];
+
+	memset(&Rail->Sequence, 0, sizeof(I2C_Sequence_t));
+	Rail->Sequence.I2C_Bus = Regulator->I2C_Bus;
+	if (Regulator->Page_Select != -1) {
+		Buffer[0] = PMBUS_PAGE;
+		Buffer[1] = Regulator->Page_Select;
+		(void) I2C_Sequence_Add(&Rail->Sequence, I2C_OP_WRITE,
+					Regulator->I2C_Address, 2, Buffer, 0);
+	}
+}
+
+static int
+Sweep_Read(Sweep_Rail_t *Rail, unsigned char Command, int Length)
+{
+	return I2C_Sequence_Add(&Rail->Sequence, I2C_OP_READ,
+				Rail->Regulator->I2C_Address, 1, &Command, Length);
+}
+
+static void
+Sweep_Write(Sweep_Rail_t *Rail, unsigned char Command, unsigned int Value)
+{
+	unsigned char Buffer[3];
+
+	Buffer[0] = Command;
+	Buffer[1] = Value & 0xFF;
+	Buffer[2] = (Value >> 8) & 0xFF;
+	(void) I2C_Sequence_Add(&Rail->Sequence, I2C_OP_WRITE,
+				Rail->Regulator->I2C_Address, 3, Buffer, 0);
+}
+
+static unsigned int
+Sweep_Word(I2C_Sequence_t *Sequence, int Index)
+{
+	return ((Sequence->Op[Index].In[1] << 8) | Sequence->Op[Index].In[0]);
+}
+
+static int
+Sweep_Run(Sweep_Rail_t **Rails, int Numbers, const char *Action)
+{
+	int Ret = 0;
+
+	for (int i = 0; i < Numbers; i++) {
+		if (I2C_Submit(&Rails[i]->Sequence) != 0) {
+			Rails[i]->Sequence.Status = -1;
+			Rails[i]->Sequence.Completed = true;
+		}
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		if (I2C_Wait(&Rails[i]->Sequence) != 0 ||
+		    Rails[i]->Sequence.Status != 0) {
+			SC_ERR("failed to %s %s", Action, Rails[i]->Regulator->Name);
+			Ret = -1;
+		}
+	}
+
+	return Ret;
+}
+
+/*
+ * The client closes its socket when it is interrupted.
+ */
+static bool
+Sweep_Aborted(void)
+{
+	char Byte;
+
+	return (Client_FD && recv(Client_FD, &Byte, 1, (MSG_PEEK | MSG_DONTWAIT)) == 0);
+}
+
+static void
+Sweep_Restore(Sweep_Rail_t **Rails, int Numbers)
+{
+	Sweep_Rail_t *Restores[ITEMS_MAX];
+	int Restore_Numbers = 0;
+
+	for (int i = 0; i < Numbers; i++) {
+		if (!Rails[i]->Saved) {
+			continue;
+		}
+
+		/* VOUT is restored first, so the original limits apply to it */
+		Sweep_Begin(Rails[i]);
+		Sweep_Write(Rails[i], PMBUS_VOUT_COMMAND, Rails[i]->Vout_Command);
+		for (int j = 0; Rails[i]->Widened && j < SWEEP_LIMITS; j++) {
+			Sweep_Write(Rails[i], Sweep_Limit[j], Rails[i]->Limit[j]);
+		}
+
+		Restores[Restore_Numbers++] = Rails[i];
+	}
+
+	(void) Sweep_Run(Restores, Restore_Numbers, "restore");
+}
+
+/*
+ * Voltage Sweep Operations
+ */
+int Sweep_Ops(void)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	Power_Domains_t *Power_Domains = Plat_Devs->Power_Domains;
+	Sweep_Rail_t *Rails[ITEMS_MAX];
+	Sweep_Measure_t Measures[ITEMS_MAX] = { 0 };
+	Sweep_Rail_t *Rail;
+	Voltage_t *Regulator;
+	char Targets[LSTRLEN_MAX];
+	char Measure_Arg[LSTRLEN_MAX] = "";
+	char Line[SYSCMD_MAX];
+	struct timespec Settle;
+	float Start, Stop, Step, Low, High, Voltage, Limit;
+	float Bus_Voltage, Current, Power, Total;
+	unsigned int Value;
+	char *Token;
+	int Settle_Time, Steps, Length;
+	int Numbers = 0, Measure_Numbers = 0;
+	int Ret = -1;
+
+	if (Voltages == NULL) {
+		SC_ERR("voltage sweep operation is not supported");
+		return -1;
+	}
+
+	if (T_Flag == 0 || V_Flag == 0) {
+		SC_ERR("no sweep target or value");
+		return -1;
+	}
+
+	if (sscanf(Value_Arg, "%f %f %f %d %s", &Start, &Stop, &Step, &Settle_Time,
+		   Measure_Arg) < 4 || Step <= 0 || Settle_Time < 0 ||
+	    Settle_Time > SWEEP_SETTLE_MAX) {
+		SC_ERR("value should be '<start> <stop> <step> <settle ms up to %d> "
+		       "[<rails and power domains>]'", SWEEP_SETTLE_MAX);
+		return -1;
+	}
+
+	Steps = (int)floor((fabs(Stop - Start) / Step) + 0.0005) + 1;
+	if (Steps > SWEEP_STEPS_MAX) {
+		SC_ERR("up to %d steps can be swept", SWEEP_STEPS_MAX);
+		return -1;
+	}
+
+	Low = (Start < Stop) ? Start : Stop;
+	High = (Start < Stop) ? Stop : Start;
+	if (Low < 0) {
+		SC_ERR("invalid sweep range");
+		return -1;
+	}
+
+	/* The measurements are a comma separated list of rails and power domains */
+	for (Token = strtok(Measure_Arg, ","); Token != NULL; Token = strtok(NULL, ",")) {
+		if (Measure_Numbers == ITEMS_MAX) {
+			SC_ERR("up to %d measurements are supported", ITEMS_MAX);
+			return -1;
+		}
+
+		for (int i = 0; INA226s != NULL && i < INA226s->Numbers; i++) {
+			if (strcmp(Token, INA226s->INA226[i].Name) == 0) {
+				Measures[Measure_Numbers].INA226 = &INA226s->INA226[i];
+				break;
+			}
+		}
+
+		for (int i = 0; Power_Domains != NULL && i < Power_Domains->Numbers; i++) {
+			if (strcmp(Token, Power_Domains->Power_Domain[i].Name) == 0) {
+				Measures[Measure_Numbers].Power_Domain =
+					&Power_Domains->Power_Domain[i];
+				break;
+			}
+		}
+
+		if (Measures[Measure_Numbers].INA226 == NULL &&
+		    Measures[Measure_Numbers].Power_Domain == NULL) {
+			SC_ERR("invalid measurement target %s", Token);
+			return -1;
+		}
+
+		Measure_Numbers++;
+	}
+
+	/* The target is a comma separated list of regulators */
+	(void) snprintf(Targets, sizeof(Targets), "%s", Target_Arg);
+	for (Token = strtok(Targets, ","); Token != NULL; Token = strtok(NULL, ",")) {
+		Regulator = NULL;
+		for (int i = 0; i < Voltages->Numbers; i++) {
+			if (strcmp(Token, Voltages->Voltage[i].Name) == 0) {
+				Regulator = &Voltages->Voltage[i];
+				break;
+			}
+		}
+
+		if (Regulator == NULL) {
+			SC_ERR("invalid sweep target %s", Token);
+			goto Out;
+		}
+
+		if ((Regulator->Minimum_Volt != -1) && (Regulator->Maximum_Volt != -1) &&
+		    ((Low < Regulator->Minimum_Volt) || (High > Regulator->Maximum_Volt))) {
+			SC_ERR("valid voltage range of %s is %.2f V - %.2f V",
+			       Regulator->Name, Regulator->Minimum_Volt,
+			       Regulator->Maximum_Volt);
+			goto Out;
+		}
+
+		if (Numbers == ITEMS_MAX) {
+			SC_ERR("up to %d regulators can be swept", ITEMS_MAX);
+			goto Out;
+		}
+
+		Rail = (Sweep_Rail_t *)calloc(1, sizeof(Sweep_Rail_t));
+		if (Rail == NULL) {
+			SC_ERR("failed to allocate sweep sequence: %m");
+			goto Out;
+		}
+
+		Rail->Regulator = Regulator;
+		Rails[Numbers++] = Rail;
+		Rail->Caps = Driver_PMBus_Caps(Regulator);
+		if (Rail->Caps == NULL) {
+			goto Out;
+		}
+	}
+
+	/*
+	 * Save the original VOUT_COMMAND and limits.  The hardware manages the
+	 * limits of regulators that use the relative data format, and the
+	 * limits of some VID controllers are left as they are.
+	 */
+	for (int i = 0; i < Numbers; i++) {
+		Rail = Rails[i];
+		Sweep_Begin(Rail);
+		Rail->Vout_Command_Op = Sweep_Read(Rail, PMBUS_VOUT_COMMAND, 2);
+		Rail->Limit_Op = Rail->Sequence.Numbers;
+		for (int j = 0; !Rail->Caps->Fixed_Limits && j < SWEEP_LIMITS; j++) {
+			(void) Sweep_Read(Rail, Sweep_Limit[j], 2);
+		}
+	}
+
+	if (Sweep_Run(Rails, Numbers, "read the settings of") != 0) {
+		goto Out;
+	}
+
+	/* Widen the limits of the other regulators */
+	for (int i = 0; i < Numbers; i++) {
+		Rail = Rails[i];
+		Rail->Saved = true;
+		Rail->Vout_Command = Sweep_Word(&Rail->Sequence, Rail->Vout_Command_Op);
+		for (int j = 0; !Rail->Caps->Fixed_Limits && j < SWEEP_LIMITS; j++) {
+			Rail->Limit[j] = Sweep_Word(&Rail->Sequence, Rail->Limit_Op + j);
+		}
+
+		Sweep_Begin(Rail);
+		for (int j = 0; !Rail->Caps->Fixed_Limits && j < SWEEP_LIMITS; j++) {
+			Limit = ((Sweep_Margin[j] > 1) ? High : Low) * Sweep_Margin[j];
+			Voltage = Driver_PMBus_Decode_Vout(Rail->Caps, Rail->Limit[j]);
+			if ((Sweep_Margin[j] > 1) ? !(Voltage >= Limit) : !(Voltage <= Limit)) {
+				if (Driver_PMBus_Encode_Vout(Rail->Caps, Limit, &Value) != 0) {
+					goto Out;
+				}
+
+				Sweep_Write(Rail, Sweep_Limit[j], Value);
+				Rail->Widened = true;
+			}
+		}
+	}
+
+	if (Sweep_Run(Rails, Numbers, "set the limits of") != 0) {
+		goto Out;
+	}
+
+	Length = snprintf(Line, sizeof(Line), "Step\tSetpoint(V)");
+	for (int i = 0; i < Numbers; i++) {
+		Length += snprintf(&Line[Length], (sizeof(Line) - Length), "\t%s(V)",
+				   Rails[i]->Regulator->Name);
+	}
+
+	for (int i = 0; i < Measure_Numbers; i++) {
+		Length += snprintf(&Line[Length], (sizeof(Line) - Length), "\t%s(W)",
+				   ((Measures[i].INA226 != NULL) ?
+				    Measures[i].INA226->Name : Measures[i].Power_Domain->Name));
+	}
+
+	SC_PRINT("%s", Line);
+	Settle.tv_sec = Settle_Time / 1000;
+	Settle.tv_nsec = (Settle_Time % 1000) * 1000000L;
+	for (int Index = 0; Index < Steps; Index++) {
+		if (Sweep_Aborted()) {
+			SC_ERR("voltage sweep is aborted");
+			goto Out;
+		}
+
+		Voltage = (Start < Stop) ? (Start + (Index * Step)) : (Start - (Index * Step));
+		Voltage = (Voltage > High) ? High : ((Voltage < Low) ? Low : Voltage);
+		for (int i = 0; i < Numbers; i++) {
+			if (Driver_PMBus_Encode_Vout(Rails[i]->Caps, Voltage, &Value) != 0) {
+				goto Out;
+			}
+
+			Sweep_Begin(Rails[i]);
+			Sweep_Write(Rails[i], PMBUS_VOUT_COMMAND, Value);
+		}
+
+		if (Sweep_Run(Rails, Numbers, "set the voltage of") != 0) {
+			goto Out;
+		}
+
+		(void) clock_nanosleep(CLOCK_MONOTONIC, 0, &Settle, NULL);
+		for (int i = 0; i < Numbers; i++) {
+			Sweep_Begin(Rails[i]);
+			(void) Sweep_Read(Rails[i], PMBUS_READ_VOUT, 2);
+		}
+
+		if (Sweep_Run(Rails, Numbers, "read the voltage of") != 0) {
+			goto Out;
+		}
+
+		Length = snprintf(Line, sizeof(Line), "%d\t%.4f", Index, Voltage);
+		for (int i = 0; i < Numbers; i++) {
+			Rail = Rails[i];
+			Rail->Readback = Driver_PMBus_Decode_Vout(Rail->Caps,
+					Sweep_Word(&Rail->Sequence, (Rail->Sequence.Numbers - 1)));
+			Length += snprintf(&Line[Length], (sizeof(Line) - Length), "\t%.4f",
+					   Rail->Readback);
+		}
+
+		for (int i = 0; i < Measure_Numbers; i++) {
+			Total = 0;
+			if (Measures[i].INA226 != NULL) {
+				if (Get_Power(Measures[i].INA226, 0, &Bus_Voltage, &Current,
+					      &Total) != 0) {
+					Total = NAN;
+				}
+			} else {
+				for (int j = 0; j < Measures[i].Power_Domain->Numbers; j++) {
+					if (Get_Power(&INA226s->INA226[Measures[i].Power_Domain->Rails[j]],
+						      0, &Bus_Voltage, &Current, &Power) != 0) {
+						Total = NAN;
+						break;
+					}
+
+					Total += Power;
+				}
+			}
+
+			if (isnan(Total)) {
+				Length += snprintf(&Line[Length], (sizeof(Line) - Length), "\tN/A");
+			} else {
+				Length += snprintf(&Line[Length], (sizeof(Line) - Length),
+						   "\t%.4f", Total);
+			}
+		}
+
+		SC_PRINT("%s", Line);
+	}
+
+	Ret = 0;
+Out:
+	Sweep_Restore(Rails, Numbers);
+	for (int i = 0; i < Numbers; i++) {
+		free(Rails[i]);
+	}
+
+	return Ret;
+}
+
+/*
+ * Fault Monitor Operations
+ */
+int Fault_Ops(void)
+{
+	if (Plat_Devs->Voltages == NULL) {
+		SC_ERR("fault operation is not supported");
+		return -1;
+	}
+
+	if (Command.CmdId == GETFAULTLOG) {
+		return Fault_Print_Log();
+	}
+
+	/* Validate the regulator target */
+	if (T_Flag == 0) {
+		SC_ERR("no regulator target");
+		return -1;
+	}
+
+	return Fault_Print_State(Target_Arg);
+}
+
+/*
+ * Profile Operations
+ */
+int Profile_Ops(void)
+{
+	if (Command.CmdId == LISTPROFILE) {
+		return Profile_List();
+	}
+
+	/* Validate the profile target */
+	if (T_Flag == 0) {
+		SC_ERR("no profile target");
+		return -1;
+	}
+
+	switch (Command.CmdId) {
+	case SAVEPROFILE:
+		return Profile_Save(Target_Arg);
+	case APPLYPROFILE:
+		return Profile_Apply(Target_Arg);
+	default:
+		SC_ERR("invalid profile command");
+		break;
+	}
+
+	return -1;
+}
+
+/*
+ * Power Sequence Operations
+ */
+int Power_Sequence_Ops(void)
+{
+	if (Command.CmdId == LISTSEQUENCE) {
+		return Power_Sequence_List();
+	}
+
+	/* Validate the power sequence target */
+	if (T_Flag == 0) {
+		SC_ERR("no power sequence target");
+		return -1;
+	}
+
+	return Power_Sequence_Run(Target_Arg);
+}
+
+/*
+ * Power Capture
+ *
+ * A worker reads the shunt and bus voltages of up to CAPTURE_RAILS_MAX rails
+ * on a paced clock, and stores fixed-size records to CAPTUREFILE, which is
+ * preallocated and mapped to memory.  The file is used as a ring of at most
+ * CAPTURE_RECORDS_MAX records.  The worker takes INA226_Lock for each sample,
+ * so that the rails are not read concurrently by other threads through the
+ * same transaction plans.  It is loaded with numpy by:
+ *
+ *	numpy.fromfile(<file>, dtype=[("time_ns", "<u8"), ("rail", "<u4"),
+ *		       ("voltage", "<f4"), ("current", "<f4"), ("power", "<f4")])
+ */
+#define CAPTURE_RAILS_MAX	8
+#define CAPTURE_RECORDS_MAX	(1 << 20)
+#define CAPTURE_RATE_MAX	10000	// Hz
+#define CAPTURE_SECONDS_MAX	600
+
+typedef struct {
+	unsigned long long	Time;	// CLOCK_MONOTONIC in nano-seconds
+	unsigned int		Rail;
+	float			Voltage;
+	float			Current;
+	float			Power;
+} __attribute__((packed)) Capture_Record_t;
+
+typedef struct {
+	INA226_t		*INA226[CAPTURE_RAILS_MAX];
+	Driver_Plan_t		*Plan[CAPTURE_RAILS_MAX];
+	int			FD[CAPTURE_RAILS_MAX];
+	int			Rails;
+	long long		Period;		// in nano-seconds
+	long long		Samples;	// per rail
+	Capture_Record_t	*Records;
+	long long		Capacity;
+	long long		Written;
+	long long		Dropped;
+} Capture_t;
+
+static void *
+Capture_Worker(void *Arg)
+{
+	Capture_t *Capture = Arg;
+	Capture_Record_t *Record;
+	unsigned int Raw[2];
+	struct timespec Wakeup;
+	long long Next, Now, Missed;
+	int Ret;
+
+	Driver_Quiet(true);
+	Next = Monotonic_Nanoseconds();
+	for (long long Sample = 0; Sample < Capture->Samples; Sample++) {
+		for (int i = 0; i < Capture->Rails; i++) {
+			(void) pthread_mutex_lock(&INA226_Lock);
+			Ret = Driver_Execute(Capture->Plan[i], Capture->FD[i], Raw, NULL);
+			(void) pthread_mutex_unlock(&INA226_Lock);
+			if (Ret != 0) {
+				Capture->Dropped++;
+				continue;
+			}
+
+			Record = &Capture->Records[Capture->Written++ % Capture->Capacity];
+			Record->Time = Monotonic_Nanoseconds();
+			Record->Rail = i;
+			Record->Current = fabs((short)Raw[0] * 2.5 /
+					       Capture->INA226[i]->Shunt_Resistor) *
+					  Capture->INA226[i]->Phase_Multiplier;
+			Record->Voltage = (float)Raw[1] * 1.25 / 1000;
+			Record->Power = Record->Voltage * Record->Current;
+		}
+
+		/* Samples whose time has passed already are dropped */
+		Next += Capture->Period;
+		Now = Monotonic_Nanoseconds();
+		if (Now > Next) {
+			Missed = ((Now - Next) / Capture->Period) + 1;
+			if (Missed > (Capture->Samples - Sample - 1)) {
+				Missed = Capture->Samples - Sample - 1;
+			}
+
+			Capture->Dropped += (Missed * Capture->Rails);
+			Sample += Missed;
+			Next += (Missed * Capture->Period);
+		}
+
+		Wakeup.tv_sec = Next / 1000000000;
+		Wakeup.tv_nsec = Next % 1000000000;
+		(void) clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Wakeup, NULL);
+	}
+
+	return NULL;
+}
+
+static int
+Compare_Floats(const void *A, const void *B)
+{
+	float X = *(const float *)A;
+	float Y = *(const float *)B;
+
+	return ((X > Y) - (X < Y));
+}
+
+/*
+ * Print the power statistics of each captured rail.
+ */
+static void
+Capture_Summary(Capture_t *Capture, long long First, long long Numbers)
+{
+	Capture_Record_t *Record;
+	float *Powers;
+	double Sum;
+	int Count;
+
+	Powers = (float *)malloc(Numbers * sizeof(float));
+	if (Powers == NULL) {
+		SC_ERR("failed to allocate capture statistics: %m");
+		return;
+	}
+
+	SC_PRINT("Target\tSamples\tMin(W)\tMax(W)\tMean(W)\tP50(W)\tP95(W)\tP99(W)");
+	for (int i = 0; i < Capture->Rails; i++) {
+		Count = 0;
+		Sum = 0;
+		for (long long j = 0; j < Numbers; j++) {
+			Record = &Capture->Records[(First + j) % Capture->Capacity];
+			if (Record->Rail == (unsigned int)i) {
+				Powers[Count++] = Record->Power;
+				Sum += Record->Power;
+			}
+		}
+
+		if (Count == 0) {
+			SC_PRINT("%s\t0\tN/A\tN/A\tN/A\tN/A\tN/A\tN/A",
+				 Capture->INA226[i]->Name);
+			continue;
+		}
+
+		qsort(Powers, Count, sizeof(float), Compare_Floats);
+		SC_PRINT("%s\t%d\t%.4f\t%.4f\t%.4f\t%.4f\t%.4f\t%.4f",
+			 Capture->INA226[i]->Name, Count, Powers[0],
+			 Powers[Count - 1], (Sum / Count), Powers[Count / 2],
+			 Powers[(Count * 95) / 100], Powers[(Count * 99) / 100]);
+	}
+
+	free(Powers);
+}
+
+/*
+ * Capture Operations
+ */
+int Capture_Ops(void)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	Capture_t Capture = { 0 };
+	char Targets[SYSCMD_MAX];
+	char Path[SYSCMD_MAX];
+	char *Token;
+	pthread_t Thread;
+	float Rate, Seconds;
+	long long First, Numbers;
+	size_t Size;
+	int FD;
+	int Ret = -1;
+
+	if (INA226s == NULL) {
+		SC_ERR("capture operation is not supported");
+		return -1;
+	}
+
+	if (T_Flag == 0 || V_Flag == 0) {
+		SC_ERR("no capture target or value");
+		return -1;
+	}
+
+	if (sscanf(Value_Arg, "%f %f", &Rate, &Seconds) != 2 || Rate <= 0 ||
+	    Rate > CAPTURE_RATE_MAX || Seconds <= 0 ||
+	    Seconds > CAPTURE_SECONDS_MAX) {
+		SC_ERR("value should be '<rate in Hz up to %d> <seconds up to %d>'",
+		       CAPTURE_RATE_MAX, CAPTURE_SECONDS_MAX);
+		return -1;
+	}
+
+	/* The target is a comma separated list of rails */
+	(void) snprintf(Targets, sizeof(Targets), "%s", Target_Arg);
+	for (Token = strtok(Targets, ","); Token != NULL; Token = strtok(NULL, ",")) {
+		if (Capture.Rails == CAPTURE_RAILS_MAX) {
+			SC_ERR("up to %d rails can be captured", CAPTURE_RAILS_MAX);
+			goto Out;
+		}
+
+		for (int i = 0; i < INA226s->Numbers; i++) {
+			if (strcmp(Token, INA226s->INA226[i].Name) == 0) {
+				Capture.INA226[Capture.Rails] = &INA226s->INA226[i];
+				break;
+			}
+		}
+
+		if (Capture.INA226[Capture.Rails] == NULL) {
+			SC_ERR("invalid capture target %s", Token);
+			goto Out;
+		}
+
+		Capture.Plan[Capture.Rails] = Driver_Plan(DRIVER_INA226_SHUNT,
+						Capture.INA226[Capture.Rails]);
+		Capture.FD[Capture.Rails] = I2C_Open(Capture.INA226[Capture.Rails]->I2C_Bus);
+		Capture.Rails++;
+		if (Capture.Plan[Capture.Rails - 1] == NULL ||
+		    Capture.FD[Capture.Rails - 1] < 0) {
+			SC_ERR("unable to access capture target %s", Token);
+			goto Out;
+		}
 	}
 
-	/* Validate the power domain target */
-	if (T_Flag == 0) {
-		SC_ERR("no power domain target");
-		return -1;
+	Capture.Period = (long long)(1000000000 / Rate);
+	Capture.Samples = (long long)(Rate * Seconds);
+	Capture.Capacity = Capture.Samples * Capture.Rails;
+	if (Capture.Capacity > CAPTURE_RECORDS_MAX) {
+		Capture.Capacity = CAPTURE_RECORDS_MAX;
 	}
 
-	for (int i = 0; i < Power_Domains->Numbers; i++) {
-		if (strcmp(Target_Arg, (char *)Power_Domains->Power_Domain[i].Name) == 0) {
-			Target_Index = i;
-			Power_Domain = &Power_Domains->Power_Domain[Target_Index];
-			break;
+	(void) snprintf(Path, sizeof(Path), "%s", CAPTUREFILE);
+	Size = Capture.Capacity * sizeof(Capture_Record_t);
+	FD = open(Path, (O_RDWR | O_CREAT | O_TRUNC), 0644);
+	if (FD < 0 || ftruncate(FD, Size) != 0) {
+		SC_ERR("failed to create %s: %m", Path);
+		if (FD >= 0) {
+			(void) close(FD);
 		}
+
+		goto Out;
 	}
 
-	if (Target_Index == -1) {
-		SC_ERR("invalid power domain target");
-		return -1;
+	Capture.Records = mmap(NULL, Size, (PROT_READ | PROT_WRITE),
+			       (MAP_SHARED | MAP_POPULATE), FD, 0);
+	if (Capture.Records == MAP_FAILED) {
+		SC_ERR("failed to map %s: %m", Path);
+		(void) close(FD);
+		goto Out;
 	}
 
-	switch (Command.CmdId) {
-	case POWERDOMAIN:
-		INA226s = Plat_Devs->INA226s;
-		for (int i = 0; i < Power_Domain->Numbers; i++) {
-			INA226 = &INA226s->INA226[Power_Domain->Rails[i]];
-			if (Get_Power(INA226, 0, &Voltage, &Current, &Power) == -1) {
-				SC_ERR("failed to get total power");
-				return -1;
-			}
+	if (pthread_create(&Thread, NULL, Capture_Worker, &Capture) != 0) {
+		SC_ERR("failed to start capture: %m");
+	} else {
+		(void) pthread_join(Thread, NULL);
+		Ret = 0;
+	}
+
+	/* Records start at index First, if the ring has wrapped around */
+	Numbers = ((Capture.Written < Capture.Capacity) ? Capture.Written :
+		   Capture.Capacity);
+	First = ((Capture.Written > Capture.Capacity) ?
+		 (Capture.Written % Capture.Capacity) : 0);
+	if (Ret == 0) {
+		SC_PRINT("File:\t%s", Path);
+		SC_PRINT("Records:\t%lld", Numbers);
+		SC_PRINT("First Record:\t%lld", First);
+		SC_PRINT("Dropped Samples:\t%lld", Capture.Dropped);
+		Capture_Summary(&Capture, First, Numbers);
+	}
+
+	(void) msync(Capture.Records, Size, MS_SYNC);
+	(void) munmap(Capture.Records, Size);
+	if (Numbers < Capture.Capacity &&
+	    ftruncate(FD, Numbers * sizeof(Capture_Record_t)) != 0) {
+		SC_ERR("failed to truncate %s: %m", Path);
+		Ret = -1;
+	}
 
-			Total_Power += Power;
+	(void) close(FD);
+Out:
+	for (int i = 0; i < Capture.Rails; i++) {
+		if (Capture.FD[i] >= 0) {
+			(void) close(Capture.FD[i]);
 		}
-
-		SC_PRINT("Power(W):\t%.4f", Total_Power);
-		break;
-
-	default:
-		SC_ERR("invalid power domain command");
-		break;
 	}
 
-	return 0;
+	return Ret;
 }
 
 /*
@@ -2190,7 +4478,8 @@ int DDR_Ops(void)
 	int FD;
 	char In_Buffer[SYSCMD_MAX] = { 0 };
 	char Out_Buffer[STRLEN_MAX] = { 0 };
-	short Temp;
+	float Temperature;
+	Driver_Plan_t *Plan;
 	int DRAM_Size_Index;
 	int Ret = 0;
 	float Size = 0;
@@ -2248,46 +4537,40 @@ int DDR_Ops(void)
 		return -1;
 	}
 
-	FD = open(DIMM->I2C_Bus, O_RDWR);
-	if (FD < 0) {
-		SC_ERR("failed to open I2C bus %s: %m", DIMM->I2C_Bus);
+	if (I2C_Absent(DIMM->I2C_Bus, DIMM->I2C_Address_SPD, DIMM->Name)) {
+		SC_ERR("%s is not present", DIMM->Name);
 		return -1;
 	}
 
 	if (strcmp(Value_Arg, "temp") == 0) {
-		/*
-		 * From SE98A datasheet:
-		 *	Temperature register (address 0x5, 16-bit value)
-		 *	Byte 0: XXXS_TTTT
-		 *	Byte 1: tttt_tttt
-		 *
-		 *	STTT_Tttt_tttt_t000
-		 *
-		 * Upper 3-bit of Byte 1 is Status bits and is not involved in
-		 * temperature value.  Shift-left the 16-bit value by 3 to get
-		 * the temperature value, and then divide the value by (2 ^ 4 = 16)
-		 * to adjust for the shift-left.  Resolution of each bit is 0.125 C.
-		 */
-		Out_Buffer[0] = 0x5;
-		I2C_READ(FD, DIMM->I2C_Address_Thermal, 2, Out_Buffer, In_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
+		/* Use the jc42 driver for the thermal sensor, if it is bound */
+		if (Hwmon_Get_Temperature(DIMM, &Temperature) != 0) {
+			Plan = Driver_Plan(DRIVER_JC42_TEMPERATURE, DIMM);
+			if (Plan == NULL ||
+			    Driver_Run(Plan, NULL, &Temperature) != 0) {
+				return -1;
+			}
 		}
 
-		SC_INFO("Temperature Register: %#x %#x", In_Buffer[0], In_Buffer[1]);
-		Temp = ((In_Buffer[0] << 8) | In_Buffer[1]);
-		Temp <<= 3;
-		Temp /= 16;
-		SC_PRINT("Temperature(C):\t%.2f", ((float)Temp) * 0.125);
+		SC_PRINT("Temperature(C):\t%.2f", Temperature);
+		return 0;
+	}
+
+	FD = I2C_Open(DIMM->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("failed to open I2C bus %s: %m", DIMM->I2C_Bus);
+		return -1;
+	}
 
-	} else if (strcmp(Value_Arg, "spd") == 0) {
+	if (strcmp(Value_Arg, "spd") == 0) {
 		/*
 		 * Reading first 3 bytes to determine DDR type before reading SPD. Layout
 		 * of information differs between types.
 		 */
 		Out_Buffer[0] = 0x0;
 		I2C_READ(FD, DIMM->I2C_Address_SPD, 0x3, Out_Buffer, In_Buffer, Ret);
+		I2C_Set_Presence(DIMM->I2C_Bus, DIMM->I2C_Address_SPD, DIMM->Name,
+				 (Ret == 0));
 		if (Ret < 0) {
 			(void) close(FD);
 			return Ret;
@@ -2633,6 +4916,14 @@ static int GPIO_Get_All(void)
 		(void) strcpy(Label, strtok(NULL, " :\""));
 		(void) strcpy(Usage, strtok(NULL, " :\""));
 		if (strcmp(Usage, "unused") != 0) {
+#if !defined (LIBGPIOD_V1)
+			/* Lines watched by sc_appd are read from their request */
+			if (strcmp(Usage, "sc_appd") == 0 &&
+			    Get_GPIO(Label, &State, GPIOD_LINE_DIRECTION_AS_IS) == 0) {
+				SC_PRINT("%s:\t%d", Label, State);
+				continue;
+			}
+#endif
 			SC_PRINT("%s:\tbusy, used by %s", Label, Usage);
 			continue;
 		}
@@ -3024,6 +5315,7 @@ int IO_Exp_Ops(void)
 			return -1;
 		}
 
+		I2C_Presence_Invalidate(NULL);
 		break;
 
 	case SETOUTIOEXP:
@@ -3039,9 +5331,11 @@ int IO_Exp_Ops(void)
 			return -1;
 		}
 
+		I2C_Presence_Invalidate(NULL);
 		break;
 
 	case RESTOREIOEXP:
+		I2C_Presence_Invalidate(NULL);
 		return IO_Exp_Initialized();
 		break;
 
@@ -3078,18 +5372,23 @@ int SFP_List(void)
 			continue;
 		}
 
+		if (I2C_Absent(SFP->I2C_Bus, SFP->I2C_Address, SFP->Name)) {
+			SC_PRINT("%s - Not connected", SFP->Name);
+			continue;
+		}
+
 		if (QSFP_ModuleSelect(SFP, 1) != 0) {
 			return -1;
 		}
 
-		FD = open(SFP->I2C_Bus, O_RDWR);
+		FD = I2C_Open(SFP->I2C_Bus);
 		if (FD < 0) {
 			SC_ERR("failed to access I2C bus %s: %m", SFP->I2C_Bus);
 			(void) QSFP_ModuleSelect(SFP, 0);
 			return -1;
 		}
 
-		if (ioctl(FD, I2C_SLAVE_FORCE, SFP->I2C_Address) < 0) {
+		if (I2C_Set_Address(FD, SFP->I2C_Address) < 0) {
 			SC_ERR("failed to configure I2C bus for access to "
 			       "device address %#x: %m", SFP->I2C_Address);
 			(void) QSFP_ModuleSelect(SFP, 0);
@@ -3102,14 +5401,17 @@ int SFP_List(void)
 		 * no SFP device plugged into the connector referenced by
 		 * the I2C device address.
 		 */
-		if (read(FD, Buffer, 1) != 1) {
+		if (I2C_Raw_Read(FD, Buffer, 1) != 1) {
 			SC_PRINT("%s - Not connected", SFP->Name);
+			I2C_Set_Presence(SFP->I2C_Bus, SFP->I2C_Address, SFP->Name,
+					 false);
 			(void) QSFP_ModuleSelect(SFP, 0);
 			(void) close(FD);
 			continue;
 		}
 
 		SC_PRINT("%s", SFP->Name);
+		I2C_Set_Presence(SFP->I2C_Bus, SFP->I2C_Address, SFP->Name, true);
 		(void) QSFP_ModuleSelect(SFP, 0);
 		(void) close(FD);
 	}
@@ -3162,11 +5464,16 @@ int SFP_Ops(void)
 		return -1;
 	}
 
+	if (I2C_Absent(SFP->I2C_Bus, SFP->I2C_Address, SFP->Name)) {
+		SC_ERR("%s is not connected", SFP->Name);
+		return -1;
+	}
+
 	if (QSFP_ModuleSelect(SFP, 1) != 0) {
 		return -1;
 	}
 
-	FD = open(SFP->I2C_Bus, O_RDWR);
+	FD = I2C_Open(SFP->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("unable to access I2C bus %s: %m", SFP->I2C_Bus);
 		Ret = -1;
@@ -3183,6 +5490,7 @@ int SFP_Ops(void)
 		(void) memset(Out_Buffer, 0, STRLEN_MAX);
 		(void) memset(In_Buffer, 0, STRLEN_MAX);
 		I2C_READ(FD, SFP->I2C_Address, 1, Out_Buffer, In_Buffer, Ret);
+		I2C_Set_Presence(SFP->I2C_Bus, SFP->I2C_Address, SFP->Name, (Ret == 0));
 		if (Ret != 0) {
 			goto Out;
 		}
@@ -3464,13 +5772,19 @@ int EBM_List(void)
 	char Buffer[STRLEN_MAX];
 
 	Daughter_Card = Plat_Devs->Daughter_Card;
-	FD = open(Daughter_Card->I2C_Bus, O_RDWR);
+	if (I2C_Absent(Daughter_Card->I2C_Bus, Daughter_Card->I2C_Address,
+		       Daughter_Card->Name)) {
+		SC_PRINT("%s - Not connected", Daughter_Card->Name);
+		return 0;
+	}
+
+	FD = I2C_Open(Daughter_Card->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("failed to access I2C bus %s: %m", Daughter_Card->I2C_Bus);
 		return -1;
 	}
 
-	if (ioctl(FD, I2C_SLAVE_FORCE, Daughter_Card->I2C_Address) < 0) {
+	if (I2C_Set_Address(FD, Daughter_Card->I2C_Address) < 0) {
 		SC_ERR("failed to configure I2C bus for access to "
 		       "device address %#x: %m", Daughter_Card->I2C_Address);
 		return -1;
@@ -3481,13 +5795,18 @@ int EBM_List(void)
 	 * no daughter card plugged into the motherboard referenced by
 	 * the I2C device address.
 	 */
-	if (read(FD, Buffer, 1) != 1) {
+	if (I2C_Raw_Read(FD, Buffer, 1) != 1) {
 		SC_PRINT("%s - Not connected", Daughter_Card->Name);
+		I2C_Set_Presence(Daughter_Card->I2C_Bus, Daughter_Card->I2C_Address,
+				 Daughter_Card->Name, false);
 		(void) close(FD);
 		return 0;
 	}
 
 	SC_PRINT("%s", Daughter_Card->Name);
+	I2C_Set_Presence(Daughter_Card->I2C_Bus, Daughter_Card->I2C_Address,
+			 Daughter_Card->Name, true);
+	(void) close(FD);
 	return 0;
 }
 
@@ -3542,7 +5861,13 @@ int EBM_Ops(void)
 		return -1;
 	}
 
-	FD = open(Daughter_Card->I2C_Bus, O_RDWR);
+	if (I2C_Absent(Daughter_Card->I2C_Bus, Daughter_Card->I2C_Address,
+		       Daughter_Card->Name)) {
+		SC_ERR("%s is not connected", Daughter_Card->Name);
+		return -1;
+	}
+
+	FD = I2C_Open(Daughter_Card->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("unable to access I2C bus %s: %m", Daughter_Card->I2C_Bus);
 		return -1;
@@ -3552,6 +5877,8 @@ int EBM_Ops(void)
 	(void) memset(In_Buffer, 0, SYSCMD_MAX);
 	Out_Buffer[0] = 0x0;
 	I2C_READ(FD, Daughter_Card->I2C_Address, 256, Out_Buffer, In_Buffer, Ret);
+	I2C_Set_Presence(Daughter_Card->I2C_Bus, Daughter_Card->I2C_Address,
+			 Daughter_Card->Name, (Ret == 0));
 	if (Ret != 0) {
 		(void) close(FD);
 		return Ret;
@@ -3590,15 +5917,20 @@ int FMC_List(void)
 	FMCs = Plat_Devs->FMCs;
 	for (int i = 0; i < FMCs->Numbers; i++) {
 		FMC = &FMCs->FMC[i];
+		if (I2C_Absent(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name)) {
+			SC_PRINT("%s - Not connected", FMC->Name);
+			continue;
+		}
+
 		FMC_Access(FMC, true);
-		FD = open(FMC->I2C_Bus, O_RDWR);
+		FD = I2C_Open(FMC->I2C_Bus);
 		if (FD < 0) {
 			FMC_Access(FMC, false);
 			SC_ERR("unable to access I2C bus %s: %m", FMC->I2C_Bus);
 			return -1;
 		}
 
-		if (ioctl(FD, I2C_SLAVE_FORCE, FMC->I2C_Address) < 0) {
+		if (I2C_Set_Address(FD, FMC->I2C_Address) < 0) {
 			FMC_Access(FMC, false);
 			SC_ERR("unable to access I2C device address %#x",
 			       FMC->I2C_Address);
@@ -3611,8 +5943,10 @@ int FMC_List(void)
 		 * the connector referenced by the I2C device address.
 		 */
 		Out_Buffer[0] = 0x0;
-		if (write(FD, Out_Buffer, 1) != 1) {
+		if (I2C_Raw_Write(FD, Out_Buffer, 1) != 1) {
 			SC_PRINT("%s - Not connected", FMC->Name);
+			I2C_Set_Presence(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name,
+					 false);
 			FMC_Access(FMC, false);
 			(void) close(FD);
 			continue;
@@ -3624,6 +5958,7 @@ int FMC_List(void)
 		 */
 		(void) memset(Out_Buffer, 0, SYSCMD_MAX);
 		(void) memset(In_Buffer, 0, SYSCMD_MAX);
+		I2C_Set_Presence(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name, true);
 		Out_Buffer[0] = 0x0;    // EEPROM offset 0
 		I2C_READ(FD, FMC->I2C_Address, 0xFF, Out_Buffer, In_Buffer, Ret);
 		if (Ret != 0) {
@@ -3726,8 +6061,13 @@ int FMC_Ops(void)
 		return -1;
 	}
 
+	if (I2C_Absent(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name)) {
+		SC_ERR("%s is not connected", FMC->Name);
+		return -1;
+	}
+
 	FMC_Access(FMC, true);
-	FD = open(FMC->I2C_Bus, O_RDWR);
+	FD = I2C_Open(FMC->I2C_Bus);
 	if (FD < 0) {
 		FMC_Access(FMC, false);
 		SC_ERR("unable to access I2C bus %s: %m", FMC->I2C_Bus);
@@ -3738,6 +6078,7 @@ int FMC_Ops(void)
 	(void) memset(In_Buffer, 0, SYSCMD_MAX);
 	Out_Buffer[0] = 0x0;
 	I2C_READ(FD, FMC->I2C_Address, 256, Out_Buffer, In_Buffer, Ret);
+	I2C_Set_Presence(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name, (Ret == 0));
 	if (Ret != 0) {
 		FMC_Access(FMC, false);
 		(void) close(FD);
@@ -3877,6 +6218,339 @@ PDI_Ops(void)
 	return 0;
 }
 
+/*
+ * I2C Device Profiling
+ */
+#define PROFILE_READS		100
+#define PROFILE_READS_MAX	10000
+
+typedef struct {
+	const char	*Name;
+	char		*I2C_Bus;
+	int		I2C_Address;
+	unsigned char	Register;
+	int		Length;
+	SFP_t		*SFP;
+	FMC_t		*FMC;
+} Profile_Device_t;
+
+typedef struct {
+	char		*I2C_Bus;
+	int		Reads;
+	int		Errors;
+	unsigned long	Bytes;
+	unsigned long	Time;	/* ns */
+} Profile_Bus_t;
+
+static int
+Profile_Compare(const void *A, const void *B)
+{
+	unsigned long X = *(const unsigned long *)A;
+	unsigned long Y = *(const unsigned long *)B;
+
+	return ((X > Y) - (X < Y));
+}
+
+static int
+Profile_Add(Profile_Device_t *Devices, int *Numbers, const char *Name,
+	    char *I2C_Bus, int I2C_Address, unsigned char Register, int Length)
+{
+	if (T_Flag && strcmp(Target_Arg, Name) != 0) {
+		return -1;
+	}
+
+	/* Devices with several rails, such as multi-page regulators, are profiled once */
+	for (int i = 0; i < *Numbers; i++) {
+		if (strcmp(Devices[i].I2C_Bus, I2C_Bus) == 0 &&
+		    Devices[i].I2C_Address == I2C_Address &&
+		    Devices[i].Register == Register) {
+			return -1;
+		}
+	}
+
+	if (*Numbers == LITEMS_MAX) {
+		return -1;
+	}
+
+	(void) memset(&Devices[*Numbers], 0, sizeof(Profile_Device_t));
+	Devices[*Numbers].Name = Name;
+	Devices[*Numbers].I2C_Bus = I2C_Bus;
+	Devices[*Numbers].I2C_Address = I2C_Address;
+	Devices[*Numbers].Register = Register;
+	Devices[*Numbers].Length = Length;
+	return (*Numbers)++;
+}
+
+/*
+ * Collect the I2C devices of the board along with a representative
+ * register to read from each of them.
+ */
+static int
+Profile_Devices(Profile_Device_t *Devices)
+{
+	int Numbers = 0;
+	int Index;
+
+	if (Plat_Devs->INA226s != NULL) {
+		for (int i = 0; i < Plat_Devs->INA226s->Numbers; i++) {
+			INA226_t *INA226 = &Plat_Devs->INA226s->INA226[i];
+			(void) Profile_Add(Devices, &Numbers, INA226->Name,
+					   INA226->I2C_Bus, INA226->I2C_Address,
+					   0x2, 2);
+		}
+	}
+
+	if (Plat_Devs->Voltages != NULL) {
+		for (int i = 0; i < Plat_Devs->Voltages->Numbers; i++) {
+			Voltage_t *Regulator = &Plat_Devs->Voltages->Voltage[i];
+			(void) Profile_Add(Devices, &Numbers, Regulator->Name,
+					   Regulator->I2C_Bus, Regulator->I2C_Address,
+					   PMBUS_READ_VOUT, 2);
+		}
+	}
+
+	if (Plat_Devs->Clocks != NULL) {
+		for (int i = 0; i < Plat_Devs->Clocks->Numbers; i++) {
+			Clock_t *Clock = &Plat_Devs->Clocks->Clock[i];
+			(void) Profile_Add(Devices, &Numbers, Clock->Name,
+					   Clock->I2C_Bus, Clock->I2C_Address, 0x0, 1);
+		}
+	}
+
+	if (Plat_Devs->IO_Exp != NULL) {
+		(void) Profile_Add(Devices, &Numbers, Plat_Devs->IO_Exp->Name,
+				   Plat_Devs->IO_Exp->I2C_Bus,
+				   Plat_Devs->IO_Exp->I2C_Address, 0x0, 2);
+	}
+
+	if (Plat_Devs->DIMMs != NULL) {
+		for (int i = 0; i < Plat_Devs->DIMMs->Numbers; i++) {
+			DIMM_t *DIMM = &Plat_Devs->DIMMs->DIMM[i];
+			(void) Profile_Add(Devices, &Numbers, DIMM->Name,
+					   DIMM->I2C_Bus, DIMM->I2C_Address_SPD, 0x0, 1);
+			(void) Profile_Add(Devices, &Numbers, DIMM->Name,
+					   DIMM->I2C_Bus, DIMM->I2C_Address_Thermal,
+					   0x5, 2);
+		}
+	}
+
+	if (Plat_Devs->Daughter_Card != NULL) {
+		(void) Profile_Add(Devices, &Numbers, Plat_Devs->Daughter_Card->Name,
+				   Plat_Devs->Daughter_Card->I2C_Bus,
+				   Plat_Devs->Daughter_Card->I2C_Address, 0x0, 1);
+	}
+
+	if (Plat_Devs->SFPs != NULL) {
+		for (int i = 0; i < Plat_Devs->SFPs->Numbers; i++) {
+			SFP_t *SFP = &Plat_Devs->SFPs->SFP[i];
+			Index = Profile_Add(Devices, &Numbers, SFP->Name, SFP->I2C_Bus,
+					    SFP->I2C_Address, 0x0, 1);
+			if (Index != -1) {
+				Devices[Index].SFP = SFP;
+			}
+		}
+	}
+
+	if (Plat_Devs->FMCs != NULL) {
+		for (int i = 0; i < Plat_Devs->FMCs->Numbers; i++) {
+			FMC_t *FMC = &Plat_Devs->FMCs->FMC[i];
+			Index = Profile_Add(Devices, &Numbers, FMC->Name, FMC->I2C_Bus,
+					    FMC->I2C_Address, 0x0, 1);
+			if (Index != -1) {
+				Devices[Index].FMC = FMC;
+			}
+		}
+	}
+
+	return Numbers;
+}
+
+/*
+ * Issue 'Reads' reads to a device and report its latency percentiles,
+ * error rate, and effective throughput.
+ */
+static int
+Profile_Device(Profile_Device_t *Device, int Reads, unsigned long *Latency,
+	       Profile_Bus_t *Bus)
+{
+	struct i2c_msg Msgs[2];
+	struct i2c_rdwr_ioctl_data Msgset[1];
+	unsigned char Out_Buffer[1];
+	unsigned char In_Buffer[STRLEN_MAX];
+	struct timespec Start, End;
+	unsigned long Time = 0;
+	int FD, Errors = 0;
+
+	if (Device->SFP != NULL && QSFP_ModuleSelect(Device->SFP, 1) != 0) {
+		return -1;
+	}
+
+	if (Device->FMC != NULL) {
+		FMC_Access(Device->FMC, true);
+	}
+
+	FD = I2C_Open(Device->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", Device->I2C_Bus);
+		goto Out;
+	}
+
+	Out_Buffer[0] = Device->Register;
+	Msgs[0].addr = Device->I2C_Address;
+	Msgs[0].flags = 0;
+	Msgs[0].len = 1;
+	Msgs[0].buf = Out_Buffer;
+	Msgs[1].addr = Device->I2C_Address;
+	Msgs[1].flags = (I2C_M_RD | I2C_M_NOSTART);
+	Msgs[1].len = Device->Length;
+	Msgs[1].buf = In_Buffer;
+	Msgset[0].msgs = Msgs;
+	Msgset[0].nmsgs = 2;
+	for (int i = 0; i < Reads; i++) {
+		(void) clock_gettime(CLOCK_MONOTONIC, &Start);
+		if (I2C_Transfer(FD, Msgset) < 0) {
+			Errors++;
+		}
+
+		(void) clock_gettime(CLOCK_MONOTONIC, &End);
+		Latency[i] = ((End.tv_sec - Start.tv_sec) * 1000000000UL) +
+			     End.tv_nsec - Start.tv_nsec;
+		Time += Latency[i];
+	}
+
+	(void) close(FD);
+	qsort(Latency, Reads, sizeof(unsigned long), Profile_Compare);
+	SC_PRINT("%s (%s %#x):\tReads: %d\tErrors(%%): %.1f\tP50(us): %lu\t"
+		 "P90(us): %lu\tP99(us): %lu\tMax(us): %lu\tThroughput(B/s): %.0f",
+		 Device->Name, Device->I2C_Bus, Device->I2C_Address, Reads,
+		 ((Errors * 100.0) / Reads), (Latency[Reads / 2] / 1000),
+		 (Latency[(Reads * 90) / 100] / 1000),
+		 (Latency[(Reads * 99) / 100] / 1000), (Latency[Reads - 1] / 1000),
+		 (((Reads - Errors) * (1.0 + Device->Length) * 1e9) / Time));
+
+	Bus->Reads += Reads;
+	Bus->Errors += Errors;
+	Bus->Bytes += (Reads - Errors) * (1 + Device->Length);
+	Bus->Time += Time;
+Out:
+	if (Device->FMC != NULL) {
+		FMC_Access(Device->FMC, false);
+	}
+
+	if (Device->SFP != NULL) {
+		(void) QSFP_ModuleSelect(Device->SFP, 0);
+	}
+
+	return ((FD < 0) ? -1 : 0);
+}
+
+static int
+Profile_Op(void)
+{
+	Profile_Device_t *Devices;
+	Profile_Bus_t Buses[ITEMS_MAX];
+	unsigned long *Latency;
+	int Numbers, Bus_Numbers = 0;
+	int Reads = PROFILE_READS;
+	int Bus, Ret = 0;
+
+	if (V_Flag) {
+		Reads = atoi(Value_Arg);
+		if (Reads < 1 || Reads > PROFILE_READS_MAX) {
+			SC_ERR("valid number of reads is 1 - %d", PROFILE_READS_MAX);
+			return -1;
+		}
+	}
+
+	Devices = (Profile_Device_t *)malloc(LITEMS_MAX * sizeof(Profile_Device_t));
+	Latency = (unsigned long *)malloc(Reads * sizeof(unsigned long));
+	if (Devices == NULL || Latency == NULL) {
+		SC_ERR("failed to allocate memory for profiling: %m");
+		free(Devices);
+		free(Latency);
+		return -1;
+	}
+
+	Numbers = Profile_Devices(Devices);
+	if (Numbers == 0) {
+		SC_ERR("no I2C device to profile");
+		Ret = -1;
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		for (Bus = 0; Bus < Bus_Numbers; Bus++) {
+			if (strcmp(Buses[Bus].I2C_Bus, Devices[i].I2C_Bus) == 0) {
+				break;
+			}
+		}
+
+		if (Bus == Bus_Numbers) {
+			if (Bus_Numbers == ITEMS_MAX) {
+				continue;
+			}
+
+			(void) memset(&Buses[Bus], 0, sizeof(Profile_Bus_t));
+			Buses[Bus].I2C_Bus = Devices[i].I2C_Bus;
+			Bus_Numbers++;
+		}
+
+		(void) Profile_Device(&Devices[i], Reads, Latency, &Buses[Bus]);
+	}
+
+	for (int i = 0; i < Bus_Numbers; i++) {
+		if (Buses[i].Reads == 0) {
+			continue;
+		}
+
+		SC_PRINT("%s:\tReads: %d\tErrors(%%): %.1f\tAverage(us): %lu\t"
+			 "Throughput(B/s): %.0f", Buses[i].I2C_Bus, Buses[i].Reads,
+			 ((Buses[i].Errors * 100.0) / Buses[i].Reads),
+			 (Buses[i].Time / Buses[i].Reads / 1000),
+			 ((Buses[i].Bytes * 1e9) / Buses[i].Time));
+	}
+
+	free(Devices);
+	free(Latency);
+	return Ret;
+}
+
+/*
+ * I2C Operations
+ */
+int
+I2C_Ops(void)
+{
+	I2C_Stats_t Stats[ITEMS_MAX];
+	const char *States[] = { "Healthy", "Degraded", "Failed", "Probing" };
+	int Numbers;
+
+	switch (Command.CmdId) {
+	case GETI2CSTATS:
+		Numbers = I2C_Get_Stats(Stats, ITEMS_MAX);
+		for (int i = 0; i < Numbers; i++) {
+			SC_PRINT("/dev/i2c-%d:\tState: %s\tRecoveries: %lu\t"
+				 "Transactions: %lu\tErrors: %lu\t"
+				 "Busy(ms): %lu\tUtilization(%%): %.1f\t"
+				 "Background(%%): %.1f", Stats[i].Bus,
+				 States[Stats[i].State], Stats[i].Recoveries,
+				 Stats[i].Transactions, Stats[i].Errors,
+				 (Stats[i].Busy_Time / 1000), Stats[i].Utilization,
+				 Stats[i].Background);
+		}
+
+		break;
+
+	case PROFILE:
+		return Profile_Op();
+
+	default:
+		SC_ERR("invalid I2C command");
+		return -1;
+	}
+
+	return 0;
+}
+
 /*
  * Apply any applicable workaround
  */
@@ -3979,9 +6653,12 @@ Boot_Set_Voltages(void)
 	FILE *FP;
 	Voltages_t *Voltages;
 	Voltage_t *Regulator = NULL;
+	I2C_Sequence_t *Sequences[LITEMS_MAX];
 	char Buffer[SYSCMD_MAX];
 	char Value[STRLEN_MAX];
 	float Voltage;
+	int Numbers = 0;
+	int Ret = 0;
 
 	/* If there is no voltage file, there is nothing to do */
 	if (access(VOLTAGEFILE, F_OK) != 0) {
@@ -3994,8 +6671,12 @@ Boot_Set_Voltages(void)
 		return -1;
 	}
 
+	/*
+	 * Queue all the regulator settings first, so that regulators on
+	 * different I2C buses are set concurrently.
+	 */
 	Voltages = Plat_Devs->Voltages;
-	while (fgets(Buffer, SYSCMD_MAX, FP)) {
+	while ((Numbers < LITEMS_MAX) && fgets(Buffer, SYSCMD_MAX, FP)) {
 		SC_INFO("%s: %s", VOLTAGEFILE, Buffer);
 		(void) strtok(Buffer, ":");
 		(void) strcpy(Value, strtok(NULL, "\n"));
@@ -4007,14 +6688,63 @@ Boot_Set_Voltages(void)
 		}
 
 		Voltage = strtof(Value, NULL);
-		if (Access_Regulator(Regulator, &Voltage, 1) != 0) {
+		Sequences[Numbers] = Regulator_Set_Submit(Regulator, Voltage);
+		if (Sequences[Numbers] == NULL) {
 			SC_ERR("failed to set voltage on regulator");
-			(void) fclose(FP);
-			return -1;
+			Ret = -1;
+			break;
 		}
+
+		Numbers++;
 	}
 
 	(void) fclose(FP);
+	for (int i = 0; i < Numbers; i++) {
+		if (I2C_Wait(Sequences[i]) != 0) {
+			SC_ERR("failed to set voltage on regulator");
+			Ret = -1;
+		}
+
+		free(Sequences[i]);
+	}
+
+	return Ret;
+}
+
+/*
+ * This routine programs the averaging, conversion times, and alerts of the
+ * INA226s defined in the board JSON.
+ */
+int
+Boot_Configure_INA226s(void)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	INA226_t *INA226;
+
+	if (INA226s == NULL) {
+		return 0;
+	}
+
+	for (int i = 0; i < INA226s->Numbers; i++) {
+		INA226 = &INA226s->INA226[i];
+		if (INA226->Alert_Mask != 0 && Arm_INA226_Alert(INA226) != 0) {
+			SC_ERR("failed to arm the alert of INA226 %s", INA226->Name);
+		}
+
+		if (INA226->Averages == 0 && INA226->Bus_Conversion_Time == 0 &&
+		    INA226->Shunt_Conversion_Time == 0) {
+			INA226_Set_Sample_Period(INA226, INA226_DEFAULT_CONFIG);
+			continue;
+		}
+
+		/* A rail that cannot be configured is still read as before */
+		if (Configure_INA226(INA226, INA226->Averages,
+				     INA226->Bus_Conversion_Time,
+				     INA226->Shunt_Conversion_Time) != 0) {
+			SC_ERR("failed to configure INA226 %s", INA226->Name);
+		}
+	}
+
 	return 0;
 }
 
@@ -16,6 +16,9 @@
 #include <math.h>
 #include <glob.h>
 #include <libgen.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include "sc_app.h"
 
@@ -383,338 +386,352 @@ Shell_Execute(char *Command)
 	return pclose(FP);
 }
 
-int
-Access_Regulator(Voltage_t *Regulator, float *Voltage, int Access)
+/*
+ * Setting VOUT of a regulator is carried out as a single I2C transaction
+ * sequence: select the page, read READ_VOUT, disable VOUT, adjust the fault
+ * and warning limits if needed, set VOUT_COMMAND, and enable VOUT.  The
+ * values are encoded in the cached VOUT format of the regulator.  The
+ * operations that depend on data read earlier in the sequence are filled in
+ * by Regulator_Set_Op_Done().
+ */
+typedef struct {
+	I2C_Sequence_t	Sequence;
+	const PMBus_Caps_t	*Caps;
+	float		Voltage;
+	int		Direction;
+	int		Read_Vout_Op;
+	int		Limit_Op[2];
+	int		Vout_Command_Op;
+} Regulator_Set_t;
+
+static int
+Regulator_Set_Op_Done(I2C_Sequence_t *Sequence, int Index)
 {
-	int FD;
-	char In_Buffer[STRLEN_MAX];
-	char Out_Buffer[STRLEN_MAX];
-	signed int Exponent;
-	short Mantissa;
-	int Get_Vout_Mode = 1;
-	int Ret = 0;
-	float Current_Voltage, New_Voltage;
-	int Direction, Register;
+	Regulator_Set_t *Set = (Regulator_Set_t *)Sequence;
+	I2C_Op_t *Op = &Sequence->Op[Index];
+	I2C_Op_t *Write_Op;
+	float Current_Voltage, New_Voltage, Margin;
 	unsigned int Value;
-	unsigned int Data_Format = 0;
+
+	if (Index == Set->Read_Vout_Op) {
+		Value = (Op->In[1] << 8) | Op->In[0];
+		Current_Voltage = Driver_PMBus_Decode_Vout(Set->Caps, Value);
+		SC_INFO("Current Voltage(V): %.2f, Data: %#x", Current_Voltage, Value);
+
+		/* 1: voltage is increasing, 0: voltage is decreasing */
+		Set->Direction = (Set->Voltage > Current_Voltage) ? 1 : 0;
+		Sequence->Op[Set->Limit_Op[0]].Out[0] = (Set->Direction) ?
+			PMBUS_VOUT_OV_FAULT_LIMIT : PMBUS_VOUT_UV_FAULT_LIMIT;
+		Sequence->Op[Set->Limit_Op[1]].Out[0] = (Set->Direction) ?
+			PMBUS_VOUT_OV_WARN_LIMIT : PMBUS_VOUT_UV_WARN_LIMIT;
+
+		if (Driver_PMBus_Encode_Vout(Set->Caps, Set->Voltage, &Value) != 0) {
+			return -1;
+		}
+
+		SC_INFO("New Voltage(V):\t%.2f\t(Reg 0x%x:\t0x%x)", Set->Voltage,
+			PMBUS_VOUT_COMMAND, Value);
+		Write_Op = &Sequence->Op[Set->Vout_Command_Op];
+		Write_Op->Out[1] = Value & 0xFF;
+		Write_Op->Out[2] = Value >> 8;
+		return 0;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		if (Index != Set->Limit_Op[i]) {
+			continue;
+		}
+
+		/* Set the fault limit to +/- 10% and warning limit to +/- 3% of new VOUT */
+		Margin = (i == 0) ? 0.1 : 0.03;
+		if (Set->Direction) {
+			New_Voltage = Set->Voltage + (Set->Voltage * Margin);
+		} else {
+			New_Voltage = Set->Voltage - (Set->Voltage * Margin);
+			New_Voltage = (New_Voltage < 0) ? 0 : New_Voltage;
+		}
+
+		Current_Voltage = Driver_PMBus_Decode_Vout(Set->Caps,
+							   ((Op->In[1] << 8) | Op->In[0]));
+		SC_INFO("Current %svoltage %s Limit(V): %.2f, Adjusted: %.2f",
+			((Set->Direction) ? "Over" : "Under"),
+			((i == 0) ? "Fault" : "Warn"), Current_Voltage, New_Voltage);
+
+		/* Adjust the limit register only if it is needed */
+		Write_Op = &Sequence->Op[Index + 1];
+		if (((Set->Direction == 1) && (Current_Voltage < New_Voltage)) ||
+		    ((Set->Direction == 0) && (Current_Voltage > New_Voltage))) {
+			if (Driver_PMBus_Encode_Vout(Set->Caps, New_Voltage, &Value) != 0) {
+				return -1;
+			}
+
+			Write_Op->Out[0] = Op->Out[0];
+			Write_Op->Out[1] = Value & 0xFF;
+			Write_Op->Out[2] = Value >> 8;
+			SC_INFO("Write %svoltage %s Limit: %#x %#x %#x",
+				((Set->Direction) ? "Over" : "Under"),
+				((i == 0) ? "Fault" : "Warn"), Write_Op->Out[0],
+				Write_Op->Out[1], Write_Op->Out[2]);
+		} else {
+			Write_Op->Skip = true;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Queue the sequence that sets VOUT of a regulator on the worker of its
+ * I2C bus.  The caller waits for its completion with I2C_Wait() and then
+ * frees the returned sequence.
+ */
+I2C_Sequence_t *
+Regulator_Set_Submit(Voltage_t *Regulator, float Voltage)
+{
+	Regulator_Set_t *Set;
+	I2C_Sequence_t *Sequence;
+	PMBus_Caps_t *Caps;
+	unsigned char Buffer[STRLEN_MAX] = { 0 };
+	int Address;
 
 	if (Regulator == NULL) {
 		SC_ERR("Regulator pointer is null!");
-		return -1;
+		return NULL;
 	}
 
 	/* Check if setting the requested voltage is within range */
-	if ((1 == Access) && (Regulator->Minimum_Volt != -1) &&
-	    (Regulator->Maximum_Volt != -1)) {
-		if ((*Voltage < Regulator->Minimum_Volt) ||
-		    (*Voltage > Regulator->Maximum_Volt)) {
+	if ((Regulator->Minimum_Volt != -1) && (Regulator->Maximum_Volt != -1)) {
+		if ((Voltage < Regulator->Minimum_Volt) ||
+		    (Voltage > Regulator->Maximum_Volt)) {
 			SC_ERR("valid voltage range is %.2f V - %.2f V",
 				Regulator->Minimum_Volt, Regulator->Maximum_Volt);
-			return -1;
+			return NULL;
 		}
 	}
 
-	FD = open(Regulator->I2C_Bus, O_RDWR);
-	if (FD < 0) {
-		SC_ERR("unable to access the I2C bus %s: %m", Regulator->I2C_Bus);
-		return -1;
+	Caps = Driver_PMBus_Caps(Regulator);
+	if (Caps == NULL) {
+		return NULL;
 	}
 
+	Set = (Regulator_Set_t *)calloc(1, sizeof(Regulator_Set_t));
+	if (Set == NULL) {
+		SC_ERR("failed to allocate regulator sequence: %m");
+		return NULL;
+	}
+
+	Sequence = &Set->Sequence;
+	Sequence->I2C_Bus = Regulator->I2C_Bus;
+	Sequence->Op_Done = Regulator_Set_Op_Done;
+	Address = Regulator->I2C_Address;
+	Set->Caps = Caps;
+	Set->Voltage = Voltage;
+
 	/* Select the page, if the voltage regulator supports it */
 	if (Regulator->Page_Select != -1) {
-		Out_Buffer[0] = 0x0;
-		Out_Buffer[1] = Regulator->Page_Select;
-		SC_INFO("Write to select page: 0x%x%x", Out_Buffer[0],
-			Out_Buffer[1]);
-		I2C_WRITE(FD, Regulator->I2C_Address, 2, Out_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
-		}
+		Buffer[0] = 0x0;
+		Buffer[1] = Regulator->Page_Select;
+		(void) I2C_Sequence_Add(Sequence, I2C_OP_WRITE, Address, 2, Buffer, 0);
 	}
 
+	Buffer[0] = PMBUS_READ_VOUT;
+	Set->Read_Vout_Op = I2C_Sequence_Add(Sequence, I2C_OP_READ, Address, 1,
+					     Buffer, 2);
+
+	/* Disable VOUT */
+	Buffer[0] = PMBUS_OPERATION;
+	Buffer[1] = 0x0;
+	(void) I2C_Sequence_Add(Sequence, I2C_OP_WRITE, Address, 2, Buffer, 0);
+
 	/*
-	 * Reading VOUT_MODE indicates what is READ_VOUT format and
-	 * its exponent.  The default format is Linear16:
-	 *
-	 * Voltage =  Mantissa * 2 ^ -(Exponent)
+	 * Fault and warning limits: read, followed by a conditional write.
+	 * Relative data format allows hardware to manage OV/UV limits.
+	 * Absolute data format requires software to update OV/UV limits,
+	 * except on controllers whose limits are left as they are.
 	 */
-
-	/* Regulators that don't support VOUT_MODE PMBus command */
-	if (!Regulator->PMBus_VOUT_MODE) {
-		Get_Vout_Mode = 0;
+	Buffer[0] = Buffer[1] = 0x0;
+	for (int i = 0; i < 2; i++) {
+		Set->Limit_Op[i] = I2C_Sequence_Add(Sequence, I2C_OP_READ,
+						    Address, 1, Buffer, 2);
+		(void) I2C_Sequence_Add(Sequence, I2C_OP_WRITE, Address, 3,
+					Buffer, 0);
+		if (Caps->Fixed_Limits) {
+			Sequence->Op[Set->Limit_Op[i]].Skip = true;
+			Sequence->Op[Set->Limit_Op[i] + 1].Skip = true;
+		}
 	}
 
-	if (1 == Get_Vout_Mode) {
-		Out_Buffer[0] = PMBUS_VOUT_MODE;
-		(void) memset(In_Buffer, 0, STRLEN_MAX);
-		I2C_READ(FD, Regulator->I2C_Address, 1, Out_Buffer, In_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
-		}
+	/* Set VOUT */
+	Buffer[0] = PMBUS_VOUT_COMMAND;
+	Set->Vout_Command_Op = I2C_Sequence_Add(Sequence, I2C_OP_WRITE, Address,
+						3, Buffer, 0);
 
-		SC_INFO("VOUT_MODE: %#x", In_Buffer[0]);
-		Data_Format = ((In_Buffer[0] & 0x80) >> 7);
-		Exponent = (In_Buffer[0] & 0x1F) - (sizeof(int) * 8);
+	/* Enable VOUT */
+	Buffer[0] = PMBUS_OPERATION;
+	Buffer[1] = 0x80;
+	(void) I2C_Sequence_Add(Sequence, I2C_OP_WRITE, Address, 2, Buffer, 0);
 
-	} else {
-		/* For non-compliant regulators, use exponent value -8 */
-		Exponent = -8;
+	if (I2C_Submit(Sequence) != 0) {
+		free(Set);
+		return NULL;
 	}
 
-	/* Get the current VOUT */
-	Out_Buffer[0] = PMBUS_READ_VOUT;
-	(void) memset(In_Buffer, 0, STRLEN_MAX);
-	I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-	if (Ret != 0) {
-		(void) close(FD);
-		return Ret;
-	}
+	return Sequence;
+}
 
-	Mantissa = ((unsigned char)In_Buffer[1] << 8) | (unsigned char)In_Buffer[0];
-	Current_Voltage = Mantissa * pow(2, Exponent);
-	SC_INFO("Current Voltage(V): %.2f, Mantissa: %#x, Exponent: %#x",
-		Current_Voltage, Mantissa, Exponent);
+int
+Access_Regulator(Voltage_t *Regulator, float *Voltage, int Access)
+{
+	static const struct {
+		const char	*Name;
+		unsigned char	Command;
+	} Limits[] = {
+		{ "Overvoltage Fault", PMBUS_VOUT_OV_FAULT_LIMIT },
+		{ "Overvoltage Warning", PMBUS_VOUT_OV_WARN_LIMIT },
+		{ "Undervoltage Warning", PMBUS_VOUT_UV_WARN_LIMIT },
+		{ "Undervoltage Fault", PMBUS_VOUT_UV_FAULT_LIMIT },
+	};
+	static const char *Formats[] = { "LINEAR16", "VID", "DIRECT", "IEEE half" };
+	int FD;
+	unsigned char In_Buffer[STRLEN_MAX];
+	char Out_Buffer[STRLEN_MAX];
+	unsigned int Data;
+	int Ret = 0;
+	float Current_Voltage;
+	I2C_Sequence_t *Sequence;
+	PMBus_Caps_t *Caps;
+	Driver_Plan_t *Plan;
+	float Value[2];
 
-	switch (Access) {
-	case 0:
-		*Voltage = Current_Voltage;
-		break;
-	case 1:
-		/* 1: voltage is increasing, 0: voltage is decreasing */
-		Direction = (*Voltage > Current_Voltage) ? 1 : 0;
+	if (Regulator == NULL) {
+		SC_ERR("Regulator pointer is null!");
+		return -1;
+	}
 
-		/* Disable VOUT */
-		Out_Buffer[0] = PMBUS_OPERATION;
-		Out_Buffer[1] = 0x0;
-		SC_INFO("OPERATION: %#x %#x", Out_Buffer[0], Out_Buffer[1]);
-		I2C_WRITE(FD, Regulator->I2C_Address, 2, Out_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
+	if (1 == Access) {
+		Sequence = Regulator_Set_Submit(Regulator, *Voltage);
+		if (Sequence == NULL) {
+			return -1;
 		}
 
-		/*
-		 * 1: relative data format, 0: absolute data format
-		 * Relative data format allows hardware to manage OV/UV limits.
-		 * Absolute data format requires software to update OV/UV limits.
-		 */
-		if (0 == Data_Format) {
-			/* Set the fault limit to +/- 10% of new VOUT */
-			if (Direction) {
-				New_Voltage = *Voltage + (*Voltage * 0.1);
-				Register = PMBUS_VOUT_OV_FAULT_LIMIT;
-			} else {
-				New_Voltage = *Voltage - (*Voltage * 0.1);
-				New_Voltage = (New_Voltage < 0) ? 0 : New_Voltage;
-				Register = PMBUS_VOUT_UV_FAULT_LIMIT;
-			}
-
-			SC_INFO("Adjusted %svoltage Fault Limit(V):\t%.2f",
-				((Direction) ? "Over" : "Under"), New_Voltage);
-
-			/* Get the current fault limit */
-			Out_Buffer[0] = Register;
-			(void) memset(In_Buffer, 0, STRLEN_MAX);
-			I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-			if (Ret != 0) {
-				(void) close(FD);
-				return Ret;
-			}
-
-			Mantissa = ((unsigned char)In_Buffer[1] << 8) |
-					(unsigned char)In_Buffer[0];
-			Current_Voltage = Mantissa * pow(2, Exponent);
-			SC_INFO("Current %svoltage Fault Limit(V): %.2f, Mantissa: %#x, \
-				Exponent: %#x", ((Direction) ? "Over" : "Under"),
-				Current_Voltage, Mantissa, Exponent);
-
-			/* Adjust the limit register only if it is needed */
-			if (((Direction == 1) && (Current_Voltage < New_Voltage)) ||
-				((Direction == 0) && (Current_Voltage > New_Voltage))) {
-				Value = round(New_Voltage / pow(2, Exponent));
-				SC_INFO("New %svoltage Fault Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)",
-					((Direction) ? "Over" : "Under"),
-					New_Voltage, Register, Value);
-				Out_Buffer[0] = Register;
-				Out_Buffer[1] = Value & 0xFF;
-				Out_Buffer[2] = Value >> 8;
-				SC_INFO("Write %svoltage Fault Limit: %#x %#x %#x",
-					((Direction) ? "Over" : "Under"), Out_Buffer[0],
-					Out_Buffer[1], Out_Buffer[2]);
-				I2C_WRITE(FD, Regulator->I2C_Address, 3, Out_Buffer, Ret);
-				if (Ret != 0) {
-					(void) close(FD);
-					return Ret;
-				}
-			}
-
-			/* Set the warning limit to +/- 3% of new VOUT*/
-			if (Direction) {
-				New_Voltage = *Voltage + (*Voltage * 0.03);
-				Register = PMBUS_VOUT_OV_WARN_LIMIT;
-			} else {
-				New_Voltage = *Voltage - (*Voltage * 0.03);
-				New_Voltage = (New_Voltage < 0) ? 0 : New_Voltage;
-				Register = PMBUS_VOUT_UV_WARN_LIMIT;
-			}
+		Ret = I2C_Wait(Sequence);
+		free(Sequence);
+		return Ret;
+	}
 
-			SC_INFO("Adjusted %svoltage Warn Limit(V):\t%.2f",
-				((Direction) ? "Over" : "Under"), New_Voltage);
+	if (0 == Access && Hwmon_Get_Voltage(Regulator, Voltage) == 0) {
+		return 0;
+	}
 
-			/* Get the current warning limit */
-			Out_Buffer[0] = Register;
-			(void) memset(In_Buffer, 0, STRLEN_MAX);
-			I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-			if (Ret != 0) {
-				(void) close(FD);
-				return Ret;
-			}
+	/* Reads are decoded in the VOUT format probed the first time */
+	Caps = Driver_PMBus_Caps(Regulator);
+	if (Caps == NULL) {
+		return -1;
+	}
 
-			Mantissa = ((unsigned char)In_Buffer[1] << 8) |
-					(unsigned char)In_Buffer[0];
-			Current_Voltage = Mantissa * pow(2, Exponent);
-			SC_INFO("Current %svoltage Warn Limit(V): %.2f, Mantissa: %#x, \
-				Exponent: %#x", ((Direction) ? "Over" : "Under"),
-				Current_Voltage, Mantissa, Exponent);
-
-			/* Adjust the limit register only if it is needed */
-			if (((Direction == 1) && (Current_Voltage < New_Voltage)) ||
-				((Direction == 0) && (Current_Voltage > New_Voltage))) {
-				Value = round(New_Voltage / pow(2, Exponent));
-				SC_INFO("New %svoltage Warn Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)",
-					((Direction) ? "Over" : "Under"),
-					New_Voltage, Register, Value);
-				Out_Buffer[0] = Register;
-				Out_Buffer[1] = Value & 0xFF;
-				Out_Buffer[2] = Value >> 8;
-				SC_INFO("Write %svoltage Warn Limit: %#x %#x %#x",
-					((Direction) ? "Over" : "Under"), Out_Buffer[0],
-					Out_Buffer[1], Out_Buffer[2]);
-				I2C_WRITE(FD, Regulator->I2C_Address, 3, Out_Buffer, Ret);
-				if (Ret != 0) {
-					(void) close(FD);
-					return Ret;
-				}
-			}
+	if (0 == Access) {
+		/* The page is selected by the plan, so the bus is held */
+		Plan = Driver_Plan(DRIVER_PMBUS_VOUT, Regulator);
+		if (Plan == NULL || I2C_Bus_Lock(Regulator->I2C_Bus) != 0) {
+			return -1;
 		}
 
-		/* Set VOUT */
-		Value = round(*Voltage / pow(2, Exponent));
-		SC_INFO("New Voltage(V):\t%.2f\t(Reg 0x%x:\t0x%x)", *Voltage,
-			PMBUS_VOUT_COMMAND, Value);
-		Out_Buffer[0] = PMBUS_VOUT_COMMAND;
-		Out_Buffer[1] = Value & 0xFF;
-		Out_Buffer[2] = Value >> 8;
-		SC_INFO("VOUT_COMMAND: %#x %#x %#x", Out_Buffer[0],
-			Out_Buffer[1], Out_Buffer[2]);
-		I2C_WRITE(FD, Regulator->I2C_Address, 3, Out_Buffer, Ret);
+		Ret = Driver_Run(Plan, NULL, Value);
+		I2C_Bus_Unlock(Regulator->I2C_Bus);
 		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
+			return -1;
 		}
 
-		/* Enable VOUT */
-		(void) memset(Out_Buffer, 0, STRLEN_MAX);
-		Out_Buffer[0] = PMBUS_OPERATION;
-		Out_Buffer[1] = 0x80;
-		SC_INFO("OPERATION: %#x %#x", Out_Buffer[0], Out_Buffer[1]);
-		I2C_WRITE(FD, Regulator->I2C_Address, 2, Out_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
-		}
+		*Voltage = Value[1];
+		SC_INFO("Current Voltage(V): %.2f", *Voltage);
+		return 0;
+	}
 
-		break;
-	case 2:
-		/* Get Overvoltage Fault Limit */
-		Out_Buffer[0] = PMBUS_VOUT_OV_FAULT_LIMIT;
-		(void) memset(In_Buffer, 0, STRLEN_MAX);
-		I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
-		}
+	if (Access != 2) {
+		SC_ERR("invalid regulator access");
+		return -1;
+	}
 
-		Mantissa = ((unsigned char)In_Buffer[1] << 8) | (unsigned char)In_Buffer[0];
-		*Voltage = Mantissa * pow(2, Exponent);
-		if (1 == Data_Format) {
-			/*
-			 * In relative data format, value calculated from mantissa is the
-			 * ratio of the voltage limit to the VOUT value. For actual voltage,
-			 * multiply ratio with VOUT value.
-			 */
-			*Voltage = *Voltage * Current_Voltage;
-		}
+	FD = I2C_Open(Regulator->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access the I2C bus %s: %m", Regulator->I2C_Bus);
+		return -1;
+	}
 
-		SC_PRINT("Overvoltage Fault Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)",
-		       *Voltage, PMBUS_VOUT_OV_FAULT_LIMIT, Mantissa);
+	if (I2C_Bus_Lock(Regulator->I2C_Bus) != 0) {
+		(void) close(FD);
+		return -1;
+	}
 
-		/* Get Overvoltage Warning Limit */
-		Out_Buffer[0] = PMBUS_VOUT_OV_WARN_LIMIT;
-		(void) memset(In_Buffer, 0, STRLEN_MAX);
-		I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
+	/* Select the page, if the voltage regulator supports it */
+	if (Regulator->Page_Select != -1) {
+		Out_Buffer[0] = 0x0;
+		Out_Buffer[1] = Regulator->Page_Select;
+		SC_INFO("Write to select page: 0x%x%x", Out_Buffer[0],
+			Out_Buffer[1]);
+		I2C_WRITE(FD, Regulator->I2C_Address, 2, Out_Buffer, Ret);
 		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
+			goto Out;
 		}
+	}
 
-		Mantissa = ((unsigned char)In_Buffer[1] << 8) | (unsigned char)In_Buffer[0];
-		*Voltage = Mantissa * pow(2, Exponent);
-		if (1 == Data_Format) {
-			*Voltage = *Voltage * Current_Voltage;
-		}
+	/* Get the current VOUT */
+	Out_Buffer[0] = PMBUS_READ_VOUT;
+	(void) memset(In_Buffer, 0, STRLEN_MAX);
+	I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
+	if (Ret != 0) {
+		goto Out;
+	}
 
-		SC_PRINT("Overvoltage Warning Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)",
-		       *Voltage, PMBUS_VOUT_OV_WARN_LIMIT, Mantissa);
+	Data = (In_Buffer[1] << 8) | In_Buffer[0];
+	Current_Voltage = Driver_PMBus_Decode_Vout(Caps, Data);
+	SC_INFO("Current Voltage(V): %.2f, Data: %#x", Current_Voltage, Data);
 
-		/* Get Undervoltage Warning Limit */
-		Out_Buffer[0] = PMBUS_VOUT_UV_WARN_LIMIT;
-		(void) memset(In_Buffer, 0, STRLEN_MAX);
-		I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
-		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
-		}
+	SC_PRINT("VOUT Format:\t%s%s", Formats[Caps->Format],
+		 ((Caps->Relative) ? ", relative limits" : ""));
+	if (Caps->Revision != -1) {
+		SC_PRINT("PMBus Revision:\t%#x", Caps->Revision);
+	}
 
-		Mantissa = ((unsigned char)In_Buffer[1] << 8) | (unsigned char)In_Buffer[0];
-		*Voltage = Mantissa * pow(2, Exponent);
-		if (1 == Data_Format) {
-			*Voltage = *Voltage * Current_Voltage;
-		}
+	if (Caps->MFR_ID[0] != '\0') {
+		SC_PRINT("Manufacturer:\t%s", Caps->MFR_ID);
+	}
 
-		SC_PRINT("Undervoltage Warning Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)",
-		       *Voltage, PMBUS_VOUT_UV_WARN_LIMIT, Mantissa);
+	if (Caps->MFR_Model[0] != '\0') {
+		SC_PRINT("Model:\t%s", Caps->MFR_Model);
+	}
 
-		/* Get Undervoltage Fault Limit */
-		Out_Buffer[0] = PMBUS_VOUT_UV_FAULT_LIMIT;
+	for (int i = 0; i < (int)(sizeof(Limits) / sizeof(Limits[0])); i++) {
+		Out_Buffer[0] = Limits[i].Command;
 		(void) memset(In_Buffer, 0, STRLEN_MAX);
 		I2C_READ(FD, Regulator->I2C_Address, 2, Out_Buffer, In_Buffer, Ret);
 		if (Ret != 0) {
-			(void) close(FD);
-			return Ret;
+			goto Out;
 		}
 
-		Mantissa = ((unsigned char)In_Buffer[1] << 8) | (unsigned char)In_Buffer[0];
-		*Voltage = Mantissa * pow(2, Exponent);
-		if (1 == Data_Format) {
+		Data = (In_Buffer[1] << 8) | In_Buffer[0];
+		*Voltage = Driver_PMBus_Decode_Vout(Caps, Data);
+		if (Caps->Relative) {
+			/*
+			 * In relative data format, value calculated from mantissa is the
+			 * ratio of the voltage limit to the VOUT value. For actual voltage,
+			 * multiply ratio with VOUT value.
+			 */
 			*Voltage = *Voltage * Current_Voltage;
 		}
 
-		SC_PRINT("Undervoltage Fault Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)",
-		       *Voltage, PMBUS_VOUT_UV_FAULT_LIMIT, Mantissa);
-		break;
-	default:
-		SC_ERR("invalid regulator access");
-		(void) close(FD);
-		return -1;
+		SC_PRINT("%s Limit(V):\t%.2f\t(Reg 0x%x:\t0x%x)", Limits[i].Name,
+			 *Voltage, Limits[i].Command, Data);
 	}
 
+Out:
+	I2C_Bus_Unlock(Regulator->I2C_Bus);
 	(void) close(FD);
-	return 0;
+	return Ret;
 }
 
+static unsigned int IO_Exp_Input;
+
 /*
  * Routine to access IO expander chip.
  *
@@ -745,7 +762,7 @@ Access_IO_Exp(IO_Exp_t *IO_Exp, int Op, int Offset, unsigned int *Data)
 		return -1;
 	}
 
-	FD = open(IO_Exp->I2C_Bus, O_RDWR);
+	FD = I2C_Open(IO_Exp->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("unable to access I2C bus %s: %m", IO_Exp->I2C_Bus);
 		return -1;
@@ -765,6 +782,15 @@ Access_IO_Exp(IO_Exp_t *IO_Exp, int Op, int Offset, unsigned int *Data)
 			In_Buffer[1]);
 		*Data = ((In_Buffer[0] << 8) | In_Buffer[1]);
 
+		/* A change of the input port may be a module being plugged */
+		if (Offset == 0x0) {
+			if (*Data != IO_Exp_Input) {
+				I2C_Presence_Invalidate(NULL);
+			}
+
+			IO_Exp_Input = *Data;
+		}
+
 	} else if (Op == 1) {	// Write operation
 		Out_Buffer[0] = Offset;
 		Out_Buffer[1] = ((*Data >> 8) & 0xFF);
@@ -831,10 +857,14 @@ FMC_Vadj_Range(FMC_t *FMC, float *Min_Voltage, float *Max_Voltage)
 	int Found;
 	int Ret = 0;
 
+	if (I2C_Absent(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name)) {
+		return -1;
+	}
+
 	FMC_Access(FMC, true);
 
 	/* Read FMC's EEPROM */
-	FD = open(FMC->I2C_Bus, O_RDWR);
+	FD = I2C_Open(FMC->I2C_Bus);
 	if (FD < 0) {
 		FMC_Access(FMC, false);
 		SC_ERR("unable to access I2C bus %s: %m", FMC->I2C_Bus);
@@ -845,6 +875,7 @@ FMC_Vadj_Range(FMC_t *FMC, float *Min_Voltage, float *Max_Voltage)
 	(void) memset(In_Buffer, 0, SYSCMD_MAX);
 	Out_Buffer[0] = 0x0;    // EEPROM offset 0
 	I2C_READ(FD, FMC->I2C_Address, 0xFF, Out_Buffer, In_Buffer, Ret);
+	I2C_Set_Presence(FMC->I2C_Bus, FMC->I2C_Address, FMC->Name, (Ret == 0));
 	if (Ret != 0) {
 		FMC_Access(FMC, false);
 		(void) close(FD);
@@ -1195,6 +1226,230 @@ Request_Free:
 #endif
 
 #if !defined (LIBGPIOD_V1)
+/*
+ * GPIO lines, such as FMC presence and INA226 alert lines, are watched for
+ * edges by a single thread, which calls the handler of a line with the
+ * timestamp of its latest edge.
+ */
+typedef struct {
+	char				*Label;
+	unsigned int			Offset;
+	struct gpiod_chip		*Chip;
+	struct gpiod_line_request	*Request;
+	GPIO_Handler_t			Handler;
+	void				*Arg;
+} Watched_Line_t;
+
+static Watched_Line_t Watched_Lines[ITEMS_MAX];
+static int Watched_Line_Numbers;
+static pthread_mutex_t Watched_Lines_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *
+GPIO_Watcher(void *Arg)
+{
+	struct gpiod_edge_event_buffer *Buffer = Arg;
+	struct pollfd FDs[ITEMS_MAX];
+	unsigned long long Timestamp = 0;
+	int Events;
+
+	for (int i = 0; i < Watched_Line_Numbers; i++) {
+		FDs[i].fd = gpiod_line_request_get_fd(Watched_Lines[i].Request);
+		FDs[i].events = POLLIN;
+	}
+
+	while (1) {
+		if (poll(FDs, Watched_Line_Numbers, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			break;
+		}
+
+		for (int i = 0; i < Watched_Line_Numbers; i++) {
+			if (!(FDs[i].revents & POLLIN)) {
+				continue;
+			}
+
+			(void) pthread_mutex_lock(&Watched_Lines_Lock);
+			Events = gpiod_line_request_read_edge_events(
+				 Watched_Lines[i].Request, Buffer, ITEMS_MAX);
+			if (Events > 0) {
+				Timestamp = gpiod_edge_event_get_timestamp_ns(
+					    gpiod_edge_event_buffer_get_event(Buffer,
+					    Events - 1));
+			}
+
+			(void) pthread_mutex_unlock(&Watched_Lines_Lock);
+			if (Events > 0) {
+				SC_INFO("GPIO line %s has changed", Watched_Lines[i].Label);
+				Watched_Lines[i].Handler(Watched_Lines[i].Arg, Timestamp);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Request GPIO line 'Label' with edge detection, on its falling edges only if
+ * 'Falling' is set.  The line is watched once Start_Watching_GPIOs() is
+ * called.
+ */
+int
+Watch_GPIO(char *Label, bool Falling, GPIO_Handler_t Handler, void *Arg)
+{
+	struct gpiod_line_settings *Settings;
+	struct gpiod_line_config *Line_Config = NULL;
+	struct gpiod_request_config *Request_Config;
+	Watched_Line_t *Line;
+	int Ret = -1;
+
+	if (Watched_Line_Numbers == ITEMS_MAX) {
+		SC_ERR("too many GPIO lines to watch");
+		return -1;
+	}
+
+	Line = &Watched_Lines[Watched_Line_Numbers];
+	Line->Label = Label;
+	Line->Handler = Handler;
+	Line->Arg = Arg;
+	Line->Request = NULL;
+	if (Find_GPIO_Line(Label, &Line->Offset, &Line->Chip) != 0) {
+		return -1;
+	}
+
+	Settings = gpiod_line_settings_new();
+	Request_Config = gpiod_request_config_new();
+	if (Settings == NULL || Request_Config == NULL ||
+	    gpiod_line_settings_set_direction(Settings,
+					      GPIOD_LINE_DIRECTION_INPUT) != 0 ||
+	    gpiod_line_settings_set_edge_detection(Settings, (Falling ?
+					      GPIOD_LINE_EDGE_FALLING :
+					      GPIOD_LINE_EDGE_BOTH)) != 0) {
+		goto Out;
+	}
+
+	gpiod_request_config_set_consumer(Request_Config, "sc_appd");
+	Line_Config = gpiod_line_config_new();
+	if (Line_Config == NULL ||
+	    gpiod_line_config_add_line_settings(Line_Config, &Line->Offset, 1,
+						Settings) != 0) {
+		goto Out;
+	}
+
+	Line->Request = gpiod_chip_request_lines(Line->Chip, Request_Config,
+						 Line_Config);
+	if (Line->Request != NULL) {
+		Watched_Line_Numbers++;
+		Ret = 0;
+	}
+
+Out:
+	if (Ret != 0) {
+		SC_INFO("failed to watch GPIO line %s: %m", Label);
+		gpiod_chip_close(Line->Chip);
+	}
+
+	if (Settings != NULL) {
+		gpiod_line_settings_free(Settings);
+	}
+
+	if (Request_Config != NULL) {
+		gpiod_request_config_free(Request_Config);
+	}
+
+	if (Line_Config != NULL) {
+		gpiod_line_config_free(Line_Config);
+	}
+
+	return Ret;
+}
+
+/*
+ * Start the thread that watches all the requested GPIO lines.
+ */
+int
+Start_Watching_GPIOs(void)
+{
+	struct gpiod_edge_event_buffer *Buffer;
+	pthread_t Thread;
+
+	if (Watched_Line_Numbers == 0) {
+		return 0;
+	}
+
+	Buffer = gpiod_edge_event_buffer_new(ITEMS_MAX);
+	if (Buffer == NULL ||
+	    pthread_create(&Thread, NULL, GPIO_Watcher, Buffer) != 0) {
+		SC_ERR("failed to start watching GPIO lines: %m");
+		return -1;
+	}
+
+	(void) pthread_detach(Thread);
+	return 0;
+}
+
+/*
+ * Forget a cached absence of the FMC as soon as a module is plugged into
+ * its connector.
+ */
+static void
+FMC_Presence_Changed(void *Arg, unsigned long long Timestamp)
+{
+	FMC_t *FMC = Arg;
+
+	(void) Timestamp;
+	SC_INFO("presence of %s has changed", FMC->Name);
+	I2C_Presence_Invalidate(FMC->I2C_Bus);
+}
+
+/*
+ * Watch the FMC presence lines.  Boards that detect FMC presence through the
+ * IO expander have no such lines.
+ */
+int
+Watch_Presence_GPIOs(void)
+{
+	FMCs_t *FMCs = Plat_Devs->FMCs;
+
+	if (FMCs == NULL) {
+		return 0;
+	}
+
+	for (int i = 0; i < FMCs->Numbers; i++) {
+		for (int j = 0; j < FMCs->FMC[i].Label_Numbers; j++) {
+			(void) Watch_GPIO(FMCs->FMC[i].Presence_Labels[j], false,
+					  FMC_Presence_Changed, &FMCs->FMC[i]);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Lines that are watched are held by sc_appd, so their state is read from
+ * the existing request, whatever the direction asked for.
+ */
+static int
+Get_Watched_GPIO(char *Label, int *State)
+{
+	int Ret = -1;
+
+	(void) pthread_mutex_lock(&Watched_Lines_Lock);
+	for (int i = 0; i < Watched_Line_Numbers; i++) {
+		if (strcmp(Watched_Lines[i].Label, Label) == 0) {
+			*State = gpiod_line_request_get_value(Watched_Lines[i].Request,
+							      Watched_Lines[i].Offset);
+			Ret = 0;
+			break;
+		}
+	}
+
+	(void) pthread_mutex_unlock(&Watched_Lines_Lock);
+	return Ret;
+}
+
 int
 Get_GPIO(char *Label, int *State, enum gpiod_line_direction Direction)
 {
@@ -1202,6 +1457,11 @@ Get_GPIO(char *Label, int *State, enum gpiod_line_direction Direction)
 	struct gpiod_line_request *Request;
 	unsigned int Line_Offset;
 
+	if (Get_Watched_GPIO(Label, State) == 0) {
+		SC_INFO("state of GPIO line %s is %d", Label, *State);
+		return 0;
+	}
+
 	if (Find_GPIO_Line(Label, &Line_Offset, &Chip) != 0) {
 		SC_INFO("failed to find GPIO line %s", Label);
 		return -1;
@@ -1221,6 +1481,29 @@ Get_GPIO(char *Label, int *State, enum gpiod_line_direction Direction)
 	return 0;
 }
 #else
+/* Edge detection is not supported with libgpiod v1 */
+int
+Watch_GPIO(char *Label, bool Falling, GPIO_Handler_t Handler, void *Arg)
+{
+	(void) Falling;
+	(void) Handler;
+	(void) Arg;
+	SC_INFO("watching GPIO line %s is not supported", Label);
+	return -1;
+}
+
+int
+Start_Watching_GPIOs(void)
+{
+	return 0;
+}
+
+int
+Watch_Presence_GPIOs(void)
+{
+	return 0;
+}
+
 int
 Get_GPIO(char *Label, int *State)
 {
@@ -1311,6 +1594,31 @@ Set_GPIO(char *Label, int State)
 	return 0;
 }
 
+/*
+ * Tell whether a GPIO line of 'Label' line name exists.
+ */
+bool
+GPIO_Line_Exists(const char *Label)
+{
+#if !defined (LIBGPIOD_V1)
+	struct gpiod_chip *Chip;
+	unsigned int Line_Offset;
+
+	if (Find_GPIO_Line(Label, &Line_Offset, &Chip) != 0) {
+		return false;
+	}
+
+	gpiod_chip_close(Chip);
+	return true;
+#else
+	char Chip_Name[STRLEN_MAX];
+	unsigned int Line_Offset;
+
+	return (gpiod_ctxless_find_line(Label, Chip_Name, STRLEN_MAX,
+					&Line_Offset) == 1);
+#endif
+}
+
 int
 EEPROM_Common(char *Buffer)
 {
@@ -1646,11 +1954,15 @@ EEPROM_MultiRecord(char *Buffer, int MAC_Address)
 	return 0;
 }
 
-int
-Get_Measured_Clock(char *Counter_Reg, char *Label)
+/*
+ * Read the FPGA clock counters of 'Counter_Regs', separated by spaces, with
+ * 'Command' in one invocation of xsdb.
+ */
+static int
+Read_Clock_Counters(const char *Command, const char *Counter_Regs, char *Output,
+		    int Length)
 {
-	char TCL_Path[SYSCMD_MAX], TCL_Args[STRLEN_MAX];
-	char Output[STRLEN_MAX] = { 0 };
+	char TCL_Path[SYSCMD_MAX], TCL_Args[SYSCMD_MAX];
 	Default_PDI_t *Default_PDI;
 	char *ImageID, *UniqueID;
 
@@ -1673,12 +1985,25 @@ Get_Measured_Clock(char *Counter_Reg, char *Label)
 	}
 
 	(void) sprintf(TCL_Path, "%s%s", SCRIPT_PATH, TCL_CMD_TCL);
-	(void) sprintf(TCL_Args, "%s %s %s %s", ImageID, UniqueID, READ_CLOCK_CMD, Counter_Reg);
-	if (XSDB_Op(TCL_Path, TCL_Args, Output, sizeof(Output)) != 0) {
+	(void) snprintf(TCL_Args, sizeof(TCL_Args), "%s %s %s %s", ImageID, UniqueID,
+			Command, Counter_Regs);
+	if (XSDB_Op(TCL_Path, TCL_Args, Output, Length) != 0) {
 		SC_ERR("failed to get measured clock");
 		return -1;
 	}
 
+	return 0;
+}
+
+int
+Get_Measured_Clock(char *Counter_Reg, char *Label)
+{
+	char Output[STRLEN_MAX] = { 0 };
+
+	if (Read_Clock_Counters(READ_CLOCK_CMD, Counter_Reg, Output, sizeof(Output)) != 0) {
+		return -1;
+	}
+
 	SC_PRINT("%s%.3f", Label, atof(Output));
 	return 0;
 }
@@ -1937,21 +2262,45 @@ Get_IDT_8A34001(Clock_t *Clock)
 	return 0;
 }
 
+/*
+ * The counters of all outputs of a vendor-managed clock are read in one
+ * invocation of xsdb.
+ */
 int
 Get_Measured_Clock_Vendor(Clock_t *Clock)
 {
-	char Label[STRLEN_MAX];
+	char Counter_Regs[SYSCMD_MAX] = { 0 };
+	char Output[LSTRLEN_MAX] = { 0 };
+	char *Value;
+	int Numbers = 0;
 
 	for (int i = 0; i < Clock->Outputs; i++) {
 		if (Clock->FPGA_Counter_Reg[i][0] != '\0') {
-			(void) sprintf(Label, "O%d - Frequency(MHz):\t", i);
-			if (Get_Measured_Clock(Clock->FPGA_Counter_Reg[i], Label) != 0) {
-				SC_ERR("failed to get measured clock");
-				return -1;
-			}
-		} else {
+			(void) strcat(Counter_Regs, " ");
+			(void) strncat(Counter_Regs, Clock->FPGA_Counter_Reg[i], LEVELS_MAX);
+			Numbers++;
+		}
+	}
+
+	if (Numbers != 0 &&
+	    Read_Clock_Counters(READ_CLOCKS_CMD, Counter_Regs, Output, sizeof(Output)) != 0) {
+		return -1;
+	}
+
+	Value = strtok(Output, " \n");
+	for (int i = 0; i < Clock->Outputs; i++) {
+		if (Clock->FPGA_Counter_Reg[i][0] == '\0') {
 			SC_PRINT("O%d - Not Available", i);
+			continue;
+		}
+
+		if (Value == NULL) {
+			SC_ERR("failed to get measured clock");
+			return -1;
 		}
+
+		SC_PRINT("O%d - Frequency(MHz):\t%.3f", i, atof(Value));
+		Value = strtok(NULL, " \n");
 	}
 
 	return 0;
@@ -1981,7 +2330,7 @@ Set_IDT_8A34001(Clock_t *Clock, char *Clock_Files, int Mode)
 		return -1;
 	}
 
-	FD = open(Clock->I2C_Bus, O_RDWR);
+	FD = I2C_Open(Clock->I2C_Bus);
 	if (FD < 0) {
 		SC_ERR("unable to access I2C bus %s: %m", Clock->I2C_Bus);
 		return -1;
@@ -2188,29 +2537,6 @@ Reset_IDT_8A34001(void)
 	return 0;
 }
 
-int
-Vendor_Utility_Clock(Clock_t *Clock, char *Command, char *Target, char *Value)
-{
-	FILE *FP;
-	char System_Cmd[2 * SYSCMD_MAX];
-
-	(void) sprintf(System_Cmd, "%s%s.py %s %s %d %s %s %s %s 2>&1", SCRIPT_PATH,
-		       Clock->Part_Name, Board_Name, Clock->I2C_Bus, Clock->I2C_Address,
-		       Clock->Default_Design, Command, Target, Value);
-	SC_INFO("Command: %s", System_Cmd);
-	FP = popen(System_Cmd, "r");
-	if (FP == NULL) {
-		SC_ERR("failed to invoke '%s': %m", System_Cmd);
-		return -1;
-	}
-
-	while (fgets(System_Cmd, sizeof(System_Cmd), FP)) {
-		SC_PRINT_N("%s", System_Cmd);
-	}
-
-	return pclose(FP);
-}
-
 int
 Reset_Op(void)
 {
@@ -2769,3 +3095,32 @@ Check_Config_File(char *Name, char *Value, int *Found)
 
 	return 0;
 }
+
+/*
+ * Return the time of the monotonic clock in nano-seconds.
+ */
+long long
+Monotonic_Nanoseconds(void)
+{
+	struct timespec TS;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &TS);
+	return ((long long)TS.tv_sec * 1000000000LL) + TS.tv_nsec;
+}
+
+/*
+ * Sleep for 'Nanoseconds' of the monotonic clock.
+ */
+void
+Monotonic_Sleep(long long Nanoseconds)
+{
+	struct timespec TS;
+
+	if (Nanoseconds <= 0) {
+		return;
+	}
+
+	TS.tv_sec = Nanoseconds / 1000000000LL;
+	TS.tv_nsec = Nanoseconds % 1000000000LL;
+	(void) clock_nanosleep(CLOCK_MONOTONIC, 0, &TS, NULL);
+}
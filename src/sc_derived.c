@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <math.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+
+/*
+ * Derived Sensors
+ *
+ * A derived sensor is defined in the board JSON by an arithmetic expression
+ * over physical sensors and constants, e.g.:
+ *
+ *	"Expression" : "vout(VCCAUX) - 1.45"
+ *	"Expression" : "power(VCCINT) + power(VCC_SOC)"
+ *	"Expression" : "100 * power(VCC1V8) / (voltage(VCC12) * current(VCC12))"
+ *	"Expression" : "100 * pout(VCCINT) / pin(VCCINT)"
+ *	"Expression" : "vout(VCCAUX) - uvlimit(VCCAUX)"
+ *
+ * with the sensor functions:
+ *
+ *	voltage(<INA226>), current(<INA226>), power(<INA226>),
+ *	vout(<VOLTAGE>), iout(<VOLTAGE>), pout(<VOLTAGE>), vin(<VOLTAGE>),
+ *	pin(<VOLTAGE>), uvlimit(<VOLTAGE>)
+ *
+ * where uvlimit() is VOUT_UV_FAULT_LIMIT.  At startup, every expression is
+ * compiled to a program for a stack machine, and the physical sensors that it
+ * refers to are entered in a table of inputs that is shared by all the
+ * programs.  An expression that does not compile is reported, and only its
+ * derived sensor reads N/A.  To evaluate a set of derived sensors, each of
+ * their inputs is read once, and the programs are run against that snapshot
+ * of the inputs.  A regulator that is used only by vout() is read as by
+ * getvoltage, otherwise its telemetry is read in one pass, through its hwmon
+ * driver if it is bound to one, as by gettelemetry.  The UV limit of a
+ * regulator bound to a driver is N/A.
+ */
+#define DERIVED_INSNS_MAX	64
+#define DERIVED_INPUTS_MAX	LITEMS_MAX
+#define DERIVED_STACK_MAX	16
+
+typedef enum {
+	DERIVED_CONSTANT,
+	DERIVED_INPUT,
+	DERIVED_NEGATE,
+	DERIVED_ADD,
+	DERIVED_SUBTRACT,
+	DERIVED_MULTIPLY,
+	DERIVED_DIVIDE,
+} Derived_Opcode;
+
+typedef enum {
+	DERIVED_VOLTAGE,		/* or VOUT */
+	DERIVED_CURRENT,		/* or IOUT */
+	DERIVED_POWER,			/* or POUT */
+	DERIVED_VIN,
+	DERIVED_PIN,
+	DERIVED_UV_LIMIT,
+	DERIVED_FIELDS,
+} Derived_Field;
+
+static const struct {
+	const char	*Function;
+	bool		Regulator;	/* of a regulator, or of an INA226 */
+	Derived_Field	Field;
+} Derived_Functions[] = {
+	{ "voltage", false, DERIVED_VOLTAGE },
+	{ "current", false, DERIVED_CURRENT },
+	{ "power", false, DERIVED_POWER },
+	{ "vout", true, DERIVED_VOLTAGE },
+	{ "iout", true, DERIVED_CURRENT },
+	{ "pout", true, DERIVED_POWER },
+	{ "vin", true, DERIVED_VIN },
+	{ "pin", true, DERIVED_PIN },
+	{ "uvlimit", true, DERIVED_UV_LIMIT },
+};
+
+#define DERIVED_FUNCTIONS	(int)(sizeof(Derived_Functions) / sizeof(Derived_Functions[0]))
+
+struct Derived_Program {
+	int		Numbers;
+	int		Depth;
+	struct {
+		Derived_Opcode	Opcode;
+		float		Constant;
+		int		Input;
+		Derived_Field	Field;
+	} Insn[DERIVED_INSNS_MAX];
+};
+
+/* A physical sensor, which is either an INA226 or a voltage regulator */
+static struct {
+	INA226_t	*INA226;
+	Voltage_t	*Regulator;
+	unsigned int	Needed;		/* mask of the fields */
+	bool		Valid;
+	float		Value[DERIVED_FIELDS];
+} Derived_Inputs[DERIVED_INPUTS_MAX];
+
+static int Derived_Input_Numbers;
+
+typedef struct {
+	const char		*Expression;
+	const char		*Char_p;
+	Derived_Program_t	*Program;
+	int			Depth;
+} Derived_Parser_t;
+
+static int Derived_Expression(Derived_Parser_t *);
+
+static int
+Derived_Emit(Derived_Parser_t *Parser, Derived_Opcode Opcode, float Constant,
+	     int Input, Derived_Field Field)
+{
+	Derived_Program_t *Program = Parser->Program;
+
+	if (Program->Numbers == DERIVED_INSNS_MAX) {
+		SC_ERR("expression is too long: %s", Parser->Expression);
+		return -1;
+	}
+
+	Program->Insn[Program->Numbers].Opcode = Opcode;
+	Program->Insn[Program->Numbers].Constant = Constant;
+	Program->Insn[Program->Numbers].Input = Input;
+	Program->Insn[Program->Numbers].Field = Field;
+	Program->Numbers++;
+
+	/* Track the stack depth that the program needs */
+	if (Opcode == DERIVED_CONSTANT || Opcode == DERIVED_INPUT) {
+		Parser->Depth++;
+	} else if (Opcode != DERIVED_NEGATE) {
+		Parser->Depth--;
+	}
+
+	if (Parser->Depth > Program->Depth) {
+		Program->Depth = Parser->Depth;
+	}
+
+	if (Program->Depth > DERIVED_STACK_MAX) {
+		SC_ERR("expression is nested too deeply: %s", Parser->Expression);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+Derived_Skip_Spaces(Derived_Parser_t *Parser)
+{
+	while (isspace((unsigned char)*Parser->Char_p)) {
+		Parser->Char_p++;
+	}
+}
+
+static int
+Derived_Syntax_Error(Derived_Parser_t *Parser)
+{
+	SC_ERR("invalid expression at offset %d: %s",
+	       (int)(Parser->Char_p - Parser->Expression), Parser->Expression);
+	return -1;
+}
+
+/*
+ * Return the index of the input for the sensor, entering it in the table if
+ * it is not there yet.
+ */
+static int
+Derived_Input(const char *Function, const char *Name, Derived_Field *Field)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	INA226_t *INA226 = NULL;
+	Voltage_t *Regulator = NULL;
+	int Index;
+
+	for (Index = 0; Index < DERIVED_FUNCTIONS; Index++) {
+		if (strcmp(Function, Derived_Functions[Index].Function) == 0) {
+			break;
+		}
+	}
+
+	if (Index == DERIVED_FUNCTIONS) {
+		SC_ERR("unknown sensor function '%s'", Function);
+		return -1;
+	}
+
+	*Field = Derived_Functions[Index].Field;
+	if (Derived_Functions[Index].Regulator) {
+		for (int i = 0; Voltages != NULL && i < Voltages->Numbers; i++) {
+			if (strcmp(Voltages->Voltage[i].Name, Name) == 0) {
+				Regulator = &Voltages->Voltage[i];
+				break;
+			}
+		}
+	} else {
+		for (int i = 0; INA226s != NULL && i < INA226s->Numbers; i++) {
+			if (strcmp(INA226s->INA226[i].Name, Name) == 0) {
+				INA226 = &INA226s->INA226[i];
+				break;
+			}
+		}
+	}
+
+	if (INA226 == NULL && Regulator == NULL) {
+		SC_ERR("unknown sensor '%s' for '%s'", Name, Function);
+		return -1;
+	}
+
+	for (int i = 0; i < Derived_Input_Numbers; i++) {
+		if (Derived_Inputs[i].INA226 == INA226 &&
+		    Derived_Inputs[i].Regulator == Regulator) {
+			return i;
+		}
+	}
+
+	if (Derived_Input_Numbers == DERIVED_INPUTS_MAX) {
+		SC_ERR("too many derived sensor inputs");
+		return -1;
+	}
+
+	Derived_Inputs[Derived_Input_Numbers].INA226 = INA226;
+	Derived_Inputs[Derived_Input_Numbers].Regulator = Regulator;
+	return Derived_Input_Numbers++;
+}
+
+/*
+ * Factor := <number> | '-' Factor | '(' Expression ')' | <function> '(' <sensor> ')'
+ */
+static int
+Derived_Factor(Derived_Parser_t *Parser)
+{
+	char Function[STRLEN_MAX];
+	char Name[STRLEN_MAX];
+	Derived_Field Field;
+	const char *Start;
+	char *End_p;
+	float Constant;
+	int Length;
+	int Input;
+
+	Derived_Skip_Spaces(Parser);
+	if (*Parser->Char_p == '-') {
+		Parser->Char_p++;
+		if (Derived_Factor(Parser) != 0) {
+			return -1;
+		}
+
+		return Derived_Emit(Parser, DERIVED_NEGATE, 0, 0, 0);
+	}
+
+	if (*Parser->Char_p == '(') {
+		Parser->Char_p++;
+		if (Derived_Expression(Parser) != 0) {
+			return -1;
+		}
+
+		Derived_Skip_Spaces(Parser);
+		if (*Parser->Char_p != ')') {
+			return Derived_Syntax_Error(Parser);
+		}
+
+		Parser->Char_p++;
+		return 0;
+	}
+
+	if (isdigit((unsigned char)*Parser->Char_p) || *Parser->Char_p == '.') {
+		Constant = strtof(Parser->Char_p, &End_p);
+		if (End_p == Parser->Char_p) {
+			return Derived_Syntax_Error(Parser);
+		}
+
+		Parser->Char_p = End_p;
+		return Derived_Emit(Parser, DERIVED_CONSTANT, Constant, 0, 0);
+	}
+
+	Start = Parser->Char_p;
+	while (isalpha((unsigned char)*Parser->Char_p)) {
+		Parser->Char_p++;
+	}
+
+	Length = Parser->Char_p - Start;
+	Derived_Skip_Spaces(Parser);
+	if (Length == 0 || Length >= STRLEN_MAX || *Parser->Char_p != '(') {
+		return Derived_Syntax_Error(Parser);
+	}
+
+	(void) snprintf(Function, sizeof(Function), "%.*s", Length, Start);
+	Parser->Char_p++;
+	Derived_Skip_Spaces(Parser);
+	Start = Parser->Char_p;
+	while (*Parser->Char_p != ')' && *Parser->Char_p != '\0') {
+		Parser->Char_p++;
+	}
+
+	Length = Parser->Char_p - Start;
+	while (Length > 0 && isspace((unsigned char)Start[Length - 1])) {
+		Length--;
+	}
+
+	if (*Parser->Char_p != ')' || Length == 0 || Length >= STRLEN_MAX) {
+		return Derived_Syntax_Error(Parser);
+	}
+
+	(void) snprintf(Name, sizeof(Name), "%.*s", Length, Start);
+	Parser->Char_p++;
+	Input = Derived_Input(Function, Name, &Field);
+	if (Input == -1) {
+		return -1;
+	}
+
+	return Derived_Emit(Parser, DERIVED_INPUT, 0, Input, Field);
+}
+
+/*
+ * Term := Factor (('*' | '/') Factor)*
+ */
+static int
+Derived_Term(Derived_Parser_t *Parser)
+{
+	char Operator;
+
+	if (Derived_Factor(Parser) != 0) {
+		return -1;
+	}
+
+	while (1) {
+		Derived_Skip_Spaces(Parser);
+		Operator = *Parser->Char_p;
+		if (Operator != '*' && Operator != '/') {
+			return 0;
+		}
+
+		Parser->Char_p++;
+		if (Derived_Factor(Parser) != 0 ||
+		    Derived_Emit(Parser, ((Operator == '*') ? DERIVED_MULTIPLY :
+				 DERIVED_DIVIDE), 0, 0, 0) != 0) {
+			return -1;
+		}
+	}
+}
+
+/*
+ * Expression := Term (('+' | '-') Term)*
+ */
+static int
+Derived_Expression(Derived_Parser_t *Parser)
+{
+	char Operator;
+
+	if (Derived_Term(Parser) != 0) {
+		return -1;
+	}
+
+	while (1) {
+		Derived_Skip_Spaces(Parser);
+		Operator = *Parser->Char_p;
+		if (Operator != '+' && Operator != '-') {
+			return 0;
+		}
+
+		Parser->Char_p++;
+		if (Derived_Term(Parser) != 0 ||
+		    Derived_Emit(Parser, ((Operator == '+') ? DERIVED_ADD :
+				 DERIVED_SUBTRACT), 0, 0, 0) != 0) {
+			return -1;
+		}
+	}
+}
+
+/*
+ * Compile the expressions of all the derived sensors.  A derived sensor whose
+ * expression does not compile is left without a program.
+ */
+int
+Derived_Compile(void)
+{
+	Deriveds_t *Deriveds = Plat_Devs->Deriveds;
+	Derived_Parser_t Parser;
+	bool Failed;
+
+	if (Deriveds == NULL) {
+		return 0;
+	}
+
+	for (int i = 0; i < Deriveds->Numbers; i++) {
+		Parser.Expression = Deriveds->Derived[i].Expression;
+		Parser.Char_p = Parser.Expression;
+		Parser.Depth = 0;
+		Parser.Program = (Derived_Program_t *)calloc(1, sizeof(Derived_Program_t));
+		if (Parser.Program == NULL) {
+			SC_ERR("failed to allocate derived sensor program: %m");
+			return -1;
+		}
+
+		Failed = (Derived_Expression(&Parser) != 0);
+		if (!Failed) {
+			Derived_Skip_Spaces(&Parser);
+			if (*Parser.Char_p != '\0') {
+				(void) Derived_Syntax_Error(&Parser);
+				Failed = true;
+			}
+		}
+
+		if (Failed) {
+			SC_ERR("failed to compile derived sensor %s",
+			       Deriveds->Derived[i].Name);
+			free(Parser.Program);
+			continue;
+		}
+
+		SC_INFO("%s: %d instructions, stack depth of %d",
+			Deriveds->Derived[i].Name, Parser.Program->Numbers,
+			Parser.Program->Depth);
+		Deriveds->Derived[i].Program = Parser.Program;
+	}
+
+	return 0;
+}
+
+static float
+Derived_Run(Derived_Program_t *Program)
+{
+	float Stack[DERIVED_STACK_MAX];
+	int Top = -1;
+
+	for (int i = 0; i < Program->Numbers; i++) {
+		switch (Program->Insn[i].Opcode) {
+		case DERIVED_CONSTANT:
+			Stack[++Top] = Program->Insn[i].Constant;
+			break;
+		case DERIVED_INPUT:
+			if (!Derived_Inputs[Program->Insn[i].Input].Valid) {
+				return NAN;
+			}
+
+			Stack[++Top] = Derived_Inputs[Program->Insn[i].Input].Value[
+				       Program->Insn[i].Field];
+			break;
+		case DERIVED_NEGATE:
+			Stack[Top] = -Stack[Top];
+			break;
+		case DERIVED_ADD:
+			Top--;
+			Stack[Top] += Stack[Top + 1];
+			break;
+		case DERIVED_SUBTRACT:
+			Top--;
+			Stack[Top] -= Stack[Top + 1];
+			break;
+		case DERIVED_MULTIPLY:
+			Top--;
+			Stack[Top] *= Stack[Top + 1];
+			break;
+		case DERIVED_DIVIDE:
+			Top--;
+			Stack[Top] = ((Stack[Top + 1] == 0) ? NAN :
+				      (Stack[Top] / Stack[Top + 1]));
+			break;
+		}
+	}
+
+	return Stack[Top];
+}
+
+/*
+ * Read the fields of a regulator that are needed.  A regulator bound to a
+ * PMBus driver is read through the driver, which does not report its UV
+ * limit.
+ */
+static bool
+Derived_Read_Regulator(int Input)
+{
+	Voltage_t *Regulator = Derived_Inputs[Input].Regulator;
+	unsigned int Needed = Derived_Inputs[Input].Needed;
+	float *Value = Derived_Inputs[Input].Value;
+	float Telemetry[PMBUS_TELEMETRIES];
+	Driver_Plan_t *Plan;
+	int FD;
+	int Ret = -1;
+
+	if (Needed == (1 << DERIVED_VOLTAGE)) {
+		return (Access_Regulator(Regulator, &Value[DERIVED_VOLTAGE], 0) == 0);
+	}
+
+	/* The telemetry that the regulator does not support is NAN */
+	for (int i = 0; i < PMBUS_TELEMETRIES; i++) {
+		Telemetry[i] = NAN;
+	}
+
+	Value[DERIVED_UV_LIMIT] = NAN;
+	if (Hwmon_Get_Telemetry(Regulator, Telemetry) != 0) {
+		FD = I2C_Open(Regulator->I2C_Bus);
+		if (FD < 0) {
+			SC_ERR("unable to access the I2C bus %s: %m", Regulator->I2C_Bus);
+			return false;
+		}
+
+		Plan = Driver_PMBus_Telemetry_Plan(Regulator, FD);
+		if (Plan != NULL && I2C_Bus_Lock(Regulator->I2C_Bus) == 0) {
+			Ret = Driver_Execute(Plan, FD, NULL, Telemetry);
+			if (Ret == 0 && (Needed & (1 << DERIVED_UV_LIMIT))) {
+				Ret = Driver_PMBus_Read_Limit(Regulator, FD,
+							      PMBUS_VOUT_UV_FAULT_LIMIT,
+							      Telemetry[PMBUS_TELEMETRY_VOUT],
+							      &Value[DERIVED_UV_LIMIT]);
+			}
+
+			I2C_Bus_Unlock(Regulator->I2C_Bus);
+		}
+
+		(void) close(FD);
+		if (Ret != 0) {
+			SC_ERR("failed to read %s", Regulator->Name);
+			return false;
+		}
+	}
+
+	Value[DERIVED_VOLTAGE] = Telemetry[PMBUS_TELEMETRY_VOUT];
+	Value[DERIVED_CURRENT] = Telemetry[PMBUS_TELEMETRY_IOUT];
+	Value[DERIVED_POWER] = Telemetry[PMBUS_TELEMETRY_POUT];
+	Value[DERIVED_VIN] = Telemetry[PMBUS_TELEMETRY_VIN];
+	Value[DERIVED_PIN] = Telemetry[PMBUS_TELEMETRY_PIN];
+	return true;
+}
+
+/*
+ * Evaluate 'Numbers' derived sensors, given by their index in 'Indexes'.
+ * The inputs of all of them are read once, before any of them is evaluated.
+ * A value that cannot be evaluated is returned as NAN.
+ */
+int
+Derived_Evaluate(int *Indexes, int Numbers, float *Values)
+{
+	Deriveds_t *Deriveds = Plat_Devs->Deriveds;
+	Derived_Program_t *Program;
+	float *Value;
+
+	if (Deriveds == NULL) {
+		return -1;
+	}
+
+	for (int i = 0; i < Derived_Input_Numbers; i++) {
+		Derived_Inputs[i].Needed = 0;
+		Derived_Inputs[i].Valid = false;
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		Program = Deriveds->Derived[Indexes[i]].Program;
+		for (int j = 0; Program != NULL && j < Program->Numbers; j++) {
+			if (Program->Insn[j].Opcode == DERIVED_INPUT) {
+				Derived_Inputs[Program->Insn[j].Input].Needed |=
+					(1 << Program->Insn[j].Field);
+			}
+		}
+	}
+
+	for (int i = 0; i < Derived_Input_Numbers; i++) {
+		if (Derived_Inputs[i].Needed == 0) {
+			continue;
+		}
+
+		Value = Derived_Inputs[i].Value;
+		if (Derived_Inputs[i].INA226 != NULL) {
+			Derived_Inputs[i].Valid = (Get_Power(Derived_Inputs[i].INA226,
+						   0, &Value[DERIVED_VOLTAGE],
+						   &Value[DERIVED_CURRENT],
+						   &Value[DERIVED_POWER]) == 0);
+		} else {
+			Derived_Inputs[i].Valid = Derived_Read_Regulator(i);
+		}
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		Program = Deriveds->Derived[Indexes[i]].Program;
+		Values[i] = ((Program == NULL) ? NAN : Derived_Run(Program));
+	}
+
+	return 0;
+}
@@ -0,0 +1,1015 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+
+/*
+ * Device Driver Registry
+ *
+ * Each device type declares its registers: command code, width, byte order,
+ * and how the raw value is decoded.  Each operation on a device type names
+ * the registers it reads.  When the board is loaded, a flat transaction plan
+ * is compiled for every (device, operation) pair, with the I2C messages and
+ * decoding already laid out, so running an operation is a tight loop with no
+ * per-call set up.
+ */
+#define DRIVER_REGS_MAX		16
+#define DRIVER_STEPS_MAX	(DRIVER_REGS_MAX + 1)
+
+typedef enum {
+	DRIVER_DECODE_RAW,
+	DRIVER_DECODE_VOUT_MODE,	/* sets the VOUT format and exponent */
+	DRIVER_DECODE_VOUT,		/* VOUT format of the device */
+	DRIVER_DECODE_LINEAR11,		/* 11-bit Mantissa * 2 ^ 5-bit Exponent */
+	DRIVER_DECODE_JC42,		/* 13-bit signed, 0.0625 C per bit */
+} Driver_Decode;
+
+typedef struct {
+	const char	*Name;
+	unsigned char	Command;
+	unsigned char	Width;		/* bytes */
+	bool		Big_Endian;
+	Driver_Decode	Decode;
+} Driver_Reg_t;
+
+typedef struct {
+	const char	*Name;
+	int		Numbers;
+	Driver_Reg_t	Reg[DRIVER_REGS_MAX];
+} Driver_t;
+
+typedef struct {
+	Driver_Op_Id	Id;
+	const Driver_t	*Driver;
+	int		Numbers;
+	int		Reg[DRIVER_REGS_MAX];
+} Driver_Op_t;
+
+static const Driver_t INA226_Driver = {
+	.Name = "INA226",
+	.Numbers = 9,
+	.Reg = {
+		{ "Configuration", 0x0, 2, true, DRIVER_DECODE_RAW },
+		{ "Shunt Voltage", 0x1, 2, true, DRIVER_DECODE_RAW },
+		{ "Bus Voltage", 0x2, 2, true, DRIVER_DECODE_RAW },
+		{ "Power", 0x3, 2, true, DRIVER_DECODE_RAW },
+		{ "Current", 0x4, 2, true, DRIVER_DECODE_RAW },
+		{ "Calibration", 0x5, 2, true, DRIVER_DECODE_RAW },
+		{ "Mask/Enable", 0x6, 2, true, DRIVER_DECODE_RAW },
+		{ "Alert Limit", 0x7, 2, true, DRIVER_DECODE_RAW },
+		{ "Die ID", 0xFF, 2, true, DRIVER_DECODE_RAW },
+	},
+};
+
+static const Driver_t PMBus_Driver = {
+	.Name = "PMBus",
+	.Numbers = 7,
+	.Reg = {
+		{ "VOUT_MODE", PMBUS_VOUT_MODE, 1, false, DRIVER_DECODE_VOUT_MODE },
+		{ "READ_VOUT", PMBUS_READ_VOUT, 2, false, DRIVER_DECODE_VOUT },
+		{ "READ_VIN", PMBUS_READ_VIN, 2, false, DRIVER_DECODE_LINEAR11 },
+		{ "READ_IOUT", PMBUS_READ_IOUT, 2, false, DRIVER_DECODE_LINEAR11 },
+		{ "READ_TEMPERATURE_1", PMBUS_READ_TEMPERATURE_1, 2, false,
+		  DRIVER_DECODE_LINEAR11 },
+		{ "READ_POUT", PMBUS_READ_POUT, 2, false, DRIVER_DECODE_LINEAR11 },
+		{ "READ_PIN", PMBUS_READ_PIN, 2, false, DRIVER_DECODE_LINEAR11 },
+	},
+};
+
+static const Driver_t JC42_Driver = {
+	.Name = "JC42",
+	.Numbers = 1,
+	.Reg = {
+		{ "Temperature", 0x5, 2, true, DRIVER_DECODE_JC42 },
+	},
+};
+
+static const Driver_Op_t Driver_Ops[DRIVER_OPS] = {
+	{ DRIVER_INA226_REGISTERS, &INA226_Driver, 9, { 0, 1, 2, 3, 4, 5, 6, 7, 8 } },
+	{ DRIVER_INA226_POWER, &INA226_Driver, 2, { 2, 4 } },
+	{ DRIVER_INA226_SHUNT, &INA226_Driver, 2, { 1, 2 } },
+	{ DRIVER_INA226_CALIBRATION, &INA226_Driver, 1, { 5 } },
+	{ DRIVER_PMBUS_VOUT, &PMBus_Driver, 2, { 0, 1 } },
+	{ DRIVER_PMBUS_TELEMETRY, &PMBus_Driver, 7, { 0, 2, 1, 3, 4, 5, 6 } },
+	{ DRIVER_JC42_TEMPERATURE, &JC42_Driver, 1, { 0 } },
+};
+
+typedef struct {
+	struct i2c_msg			Msgs[2];
+	struct i2c_rdwr_ioctl_data	Msgset;
+	unsigned char			Out[2];
+	unsigned char			In[2];
+	const Driver_Reg_t		*Reg;	/* NULL for a page select */
+	int				Result;
+} Driver_Step_t;
+
+struct Driver_Plan {
+	char		*I2C_Bus;
+	int		I2C_Address;
+	int		Exponent;
+	const PMBus_Caps_t	*Caps;	/* of PMBus regulators */
+	int		Numbers;
+	Driver_Step_t	Step[DRIVER_STEPS_MAX];
+};
+
+static Driver_Plan_t *Driver_Plans[DRIVER_OPS][LITEMS_MAX];
+
+/* Threads that run plans at high rates do not trace every register read */
+static __thread bool Quiet;
+
+/* 11-bit mantissa and 5-bit exponent, both two's complement */
+static float
+Driver_Decode_Linear11(unsigned int Data)
+{
+	return ((short)(Data << 5) >> 5) * pow(2, ((short)Data >> 11));
+}
+
+static void
+Driver_Add_Step(Driver_Plan_t *Plan, const Driver_Reg_t *Reg, int Result,
+		int Page)
+{
+	Driver_Step_t *Step = &Plan->Step[Plan->Numbers++];
+
+	Step->Reg = Reg;
+	Step->Result = Result;
+	Step->Msgs[0].addr = Plan->I2C_Address;
+	Step->Msgs[0].flags = 0;
+	Step->Msgs[0].buf = Step->Out;
+	Step->Msgset.msgs = Step->Msgs;
+	if (Reg == NULL) {
+		Step->Out[0] = 0x0;	// PAGE
+		Step->Out[1] = Page;
+		Step->Msgs[0].len = 2;
+		Step->Msgset.nmsgs = 1;
+		return;
+	}
+
+	Step->Out[0] = Reg->Command;
+	Step->Msgs[0].len = 1;
+	Step->Msgs[1].addr = Plan->I2C_Address;
+	Step->Msgs[1].flags = (I2C_M_RD | I2C_M_NOSTART);
+	Step->Msgs[1].len = Reg->Width;
+	Step->Msgs[1].buf = Step->In;
+	Step->Msgset.nmsgs = 2;
+}
+
+/*
+ * Compile the plan of operation 'Op' for a device at 'Address' on 'I2C_Bus'.
+ * 'Page' is the PMBus page to select first, or -1.  Registers that are not
+ * in 'Skip' mask are read.
+ */
+static Driver_Plan_t *
+Driver_Compile_Plan(const Driver_Op_t *Op, char *I2C_Bus, int Address, int Page,
+		    unsigned int Skip)
+{
+	Driver_Plan_t *Plan;
+
+	Plan = (Driver_Plan_t *)calloc(1, sizeof(Driver_Plan_t));
+	if (Plan == NULL) {
+		SC_ERR("failed to allocate %s plan: %m", Op->Driver->Name);
+		return NULL;
+	}
+
+	Plan->I2C_Bus = I2C_Bus;
+	Plan->I2C_Address = Address;
+	Plan->Exponent = -8;	// for regulators without VOUT_MODE
+	if (Page != -1) {
+		Driver_Add_Step(Plan, NULL, -1, Page);
+	}
+
+	for (int i = 0; i < Op->Numbers; i++) {
+		if (!(Skip & (1 << i))) {
+			Driver_Add_Step(Plan, &Op->Driver->Reg[Op->Reg[i]], i, 0);
+		}
+	}
+
+	return Plan;
+}
+
+/*
+ * Compile the transaction plans for all devices of the board.
+ */
+int
+Driver_Compile(void)
+{
+	INA226s_t *INA226s = Plat_Devs->INA226s;
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	DIMMs_t *DIMMs = Plat_Devs->DIMMs;
+	Driver_Plan_t **Plans;
+
+	for (int Op = DRIVER_INA226_REGISTERS; Op <= DRIVER_INA226_CALIBRATION; Op++) {
+		Plans = Driver_Plans[Op];
+		for (int i = 0; INA226s != NULL && i < INA226s->Numbers; i++) {
+			Plans[i] = Driver_Compile_Plan(&Driver_Ops[Op],
+						       INA226s->INA226[i].I2C_Bus,
+						       INA226s->INA226[i].I2C_Address,
+						       -1, 0);
+			if (Plans[i] == NULL) {
+				return -1;
+			}
+		}
+	}
+
+	Plans = Driver_Plans[DRIVER_PMBUS_VOUT];
+	for (int i = 0; Voltages != NULL && i < Voltages->Numbers; i++) {
+		Plans[i] = Driver_Compile_Plan(&Driver_Ops[DRIVER_PMBUS_VOUT],
+					       Voltages->Voltage[i].I2C_Bus,
+					       Voltages->Voltage[i].I2C_Address,
+					       Voltages->Voltage[i].Page_Select,
+					       (Voltages->Voltage[i].PMBus_VOUT_MODE ?
+						0 : 0x1));
+		if (Plans[i] == NULL) {
+			return -1;
+		}
+
+		Plans[i]->Caps = &Voltages->Voltage[i].PMBus_Caps;
+	}
+
+	Plans = Driver_Plans[DRIVER_JC42_TEMPERATURE];
+	for (int i = 0; DIMMs != NULL && i < DIMMs->Numbers; i++) {
+		Plans[i] = Driver_Compile_Plan(&Driver_Ops[DRIVER_JC42_TEMPERATURE],
+					       DIMMs->DIMM[i].I2C_Bus,
+					       DIMMs->DIMM[i].I2C_Address_Thermal, -1, 0);
+		if (Plans[i] == NULL) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Return the compiled plan of operation 'Op' for 'Device', which is the
+ * INA226_t, Voltage_t, or DIMM_t the operation applies to.
+ */
+Driver_Plan_t *
+Driver_Plan(Driver_Op_Id Op, void *Device)
+{
+	long Index = -1;
+
+	switch (Op) {
+	case DRIVER_INA226_REGISTERS:
+	case DRIVER_INA226_POWER:
+	case DRIVER_INA226_SHUNT:
+	case DRIVER_INA226_CALIBRATION:
+		Index = (INA226_t *)Device - Plat_Devs->INA226s->INA226;
+		break;
+	case DRIVER_PMBUS_VOUT:
+	case DRIVER_PMBUS_TELEMETRY:
+		Index = (Voltage_t *)Device - Plat_Devs->Voltages->Voltage;
+		break;
+	case DRIVER_JC42_TEMPERATURE:
+		Index = (DIMM_t *)Device - Plat_Devs->DIMMs->DIMM;
+		break;
+	default:
+		break;
+	}
+
+	if (Index < 0 || Index >= LITEMS_MAX || Driver_Plans[Op][Index] == NULL) {
+		SC_ERR("no transaction plan for the device");
+		return NULL;
+	}
+
+	return Driver_Plans[Op][Index];
+}
+
+/*
+ * Run a compiled plan on 'FD', an open file descriptor of the plan's I2C bus.
+ * The raw and decoded value of the operation's n-th register are returned in
+ * Raw[n] and Value[n]; either array may be NULL.
+ */
+int
+Driver_Execute(Driver_Plan_t *Plan, int FD, unsigned int *Raw, float *Value)
+{
+	Driver_Step_t *Step;
+	unsigned int Data;
+	PMBus_Caps_t Mode = {	// of a regulator that is not probed
+		.Format = PMBUS_FORMAT_LINEAR16,
+		.Exponent = Plan->Exponent,
+	};
+
+	for (int i = 0; i < Plan->Numbers; i++) {
+		Step = &Plan->Step[i];
+
+		/* The exponent of a probed regulator is cached */
+		if (Step->Reg != NULL && Step->Reg->Decode == DRIVER_DECODE_VOUT_MODE &&
+		    Plan->Caps != NULL && Plan->Caps->Probed) {
+			if (Value != NULL) {
+				Value[Step->Result] = Plan->Caps->Exponent;
+			}
+
+			continue;
+		}
+
+		if (I2C_Transfer(FD, &Step->Msgset) < 0) {
+			if (!Quiet) {
+				SC_ERR("unable to access I2C device %#x: %m",
+				       Plan->I2C_Address);
+			}
+
+			return -1;
+		}
+
+		if (Step->Reg == NULL) {
+			continue;
+		}
+
+		Data = Step->In[0];
+		if (Step->Reg->Width == 2) {
+			Data = (Step->Reg->Big_Endian ? ((Data << 8) | Step->In[1]) :
+				((Step->In[1] << 8) | Data));
+		}
+
+		if (!Quiet) {
+			SC_INFO("%s(%#x): %#x", Step->Reg->Name, Step->Reg->Command,
+				Data);
+		}
+
+		if (Raw != NULL) {
+			Raw[Step->Result] = Data;
+		}
+
+		if (Value == NULL) {
+			continue;
+		}
+
+		switch (Step->Reg->Decode) {
+		case DRIVER_DECODE_VOUT_MODE:
+			Mode.Format = (Data >> 5) & 0x3;
+			Mode.Exponent = (signed char)(Data << 3) >> 3;
+			Value[Step->Result] = Mode.Exponent;
+			break;
+		case DRIVER_DECODE_VOUT:
+			Value[Step->Result] = Driver_PMBus_Decode_Vout(
+				((Plan->Caps != NULL && Plan->Caps->Probed) ?
+				 Plan->Caps : &Mode), Data);
+			break;
+		case DRIVER_DECODE_LINEAR11:
+			Value[Step->Result] = Driver_Decode_Linear11(Data);
+			break;
+		case DRIVER_DECODE_JC42:
+			/*
+			 * Upper 3-bit are status bits.  Shift-left by 3 to drop
+			 * them, and divide by (2 ^ 4 = 16) to adjust for the
+			 * shift-left.  Resolution of each bit is 0.125 C.
+			 */
+			Value[Step->Result] = (short)(Data << 3) / 16 * 0.125;
+			break;
+		default:
+			Value[Step->Result] = Data;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Return whether a PMBus device supports the command of 'Reg'.  QUERY is
+ * used if the device implements it, otherwise the command is read once.
+ */
+static bool
+Driver_PMBus_Supports(int FD, int Address, const Driver_Reg_t *Reg, bool *Query)
+{
+	struct i2c_msg Msgs[2];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 2 };
+	unsigned char Out[3];
+	unsigned char In[2];
+
+	Msgs[0].addr = Msgs[1].addr = Address;
+	Msgs[0].flags = 0;
+	Msgs[0].buf = Out;
+	Msgs[1].flags = I2C_M_RD;
+	Msgs[1].buf = In;
+	if (*Query) {
+		/* Block write-block read process call */
+		Out[0] = PMBUS_QUERY;
+		Out[1] = 1;
+		Out[2] = Reg->Command;
+		Msgs[0].len = 3;
+		Msgs[1].len = 2;
+		if (I2C_Transfer(FD, &Msgset) >= 0 && In[0] == 1) {
+			return ((In[1] & 0x80) != 0);
+		}
+
+		SC_INFO("QUERY is not supported by device %#x", Address);
+		*Query = false;
+	}
+
+	Out[0] = Reg->Command;
+	Msgs[0].len = 1;
+	Msgs[1].len = Reg->Width;
+	return (I2C_Transfer(FD, &Msgset) >= 0);
+}
+
+/*
+ * VID code types of VOUT_MODE, by the assignment common to VR12 and VR13
+ * controllers: the voltage of code N is Base + (N - 1) * Step, and code 0 is
+ * 0 V.
+ */
+static const struct {
+	float	Base;
+	float	Step;
+} Driver_VIDs[] = {
+	[1] = { 0.25, 0.005 },	/* VR12 */
+	[2] = { 0.5, 0.01 },	/* VR13 */
+};
+
+#define DRIVER_VIDS	(int)(sizeof(Driver_VIDs) / sizeof(Driver_VIDs[0]))
+
+/*
+ * VID code types of controllers that depart from the common assignment.  The
+ * TPS53681 starts all of its DAC steps at 0.25 V, and its VOUT_MODE reads 1
+ * instead of 7 on some boards, with the format bits clear; its VOUT is always
+ * decoded as VID, by the code type in bits [4:0].  The OV and UV limits of
+ * these controllers are left as they are when VOUT is set.
+ */
+static const struct {
+	const char	*Part_Name;
+	int		Code;
+	float		Base;
+	float		Step;
+} Driver_Part_VIDs[] = {
+	{ "TPS53681", 1, 0.25, 0.005 },
+	{ "TPS53681", 4, 0.25, 0.01 },
+	{ "TPS53681", 7, 0.25, 0.005 },
+};
+
+#define DRIVER_PART_VIDS	(int)(sizeof(Driver_Part_VIDs) / sizeof(Driver_Part_VIDs[0]))
+
+/*
+ * Tell whether the VOUT of a regulator is in VID format, whatever the format
+ * bits of its VOUT_MODE.
+ */
+static bool
+Driver_PMBus_VID_Part(Voltage_t *Regulator)
+{
+	for (int i = 0; i < DRIVER_PART_VIDS; i++) {
+		if (strcmp(Regulator->Part_Name, Driver_Part_VIDs[i].Part_Name) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Resolve the VID code type 'Code' of a regulator into the voltage of code 1
+ * and the step between codes.
+ */
+static void
+Driver_PMBus_VID(Voltage_t *Regulator, int Code, PMBus_Caps_t *Caps)
+{
+	for (int i = 0; i < DRIVER_PART_VIDS; i++) {
+		if (strcmp(Regulator->Part_Name, Driver_Part_VIDs[i].Part_Name) == 0 &&
+		    Code == Driver_Part_VIDs[i].Code) {
+			Caps->VID_Base = Driver_Part_VIDs[i].Base;
+			Caps->VID_Step = Driver_Part_VIDs[i].Step;
+			Caps->Fixed_Limits = true;
+			return;
+		}
+	}
+
+	if (Code < DRIVER_VIDS) {
+		Caps->VID_Base = Driver_VIDs[Code].Base;
+		Caps->VID_Step = Driver_VIDs[Code].Step;
+	}
+
+	if (Caps->VID_Step == 0) {
+		SC_ERR("VID code type %d of %s is not supported", Code, Regulator->Name);
+	}
+}
+
+/*
+ * Decode VOUT_COMMAND, READ_VOUT, or a VOUT limit in the VOUT format of the
+ * regulator.  NAN is returned if the format cannot be decoded.
+ */
+float
+Driver_PMBus_Decode_Vout(const PMBus_Caps_t *Caps, unsigned int Data)
+{
+	int Exponent;
+
+	switch (Caps->Format) {
+	case PMBUS_FORMAT_LINEAR16:
+		return (Data & 0xFFFF) * pow(2, Caps->Exponent);
+	case PMBUS_FORMAT_VID:
+		if (Caps->VID_Step == 0) {
+			return NAN;
+		}
+
+		Data &= 0xFF;
+		return ((Data == 0) ? 0 : (Caps->VID_Base + ((Data - 1) * Caps->VID_Step)));
+	case PMBUS_FORMAT_DIRECT:
+		if (Caps->M == 0) {
+			return NAN;
+		}
+
+		return (((short)Data * pow(10, -Caps->R)) - Caps->B) / Caps->M;
+	case PMBUS_FORMAT_IEEE_HALF:
+		Exponent = (Data >> 10) & 0x1F;
+		if (Exponent == 0x1F) {
+			return NAN;
+		}
+
+		return (((Data & 0x8000) ? -1 : 1) *
+			((Exponent == 0) ? ldexp((Data & 0x3FF), -24) :
+			 ldexp((0x400 | (Data & 0x3FF)), (Exponent - 25))));
+	default:
+		return NAN;
+	}
+}
+
+/*
+ * Encode 'Voltage' in the VOUT format of the regulator.
+ */
+int
+Driver_PMBus_Encode_Vout(const PMBus_Caps_t *Caps, float Voltage, unsigned int *Data)
+{
+	double Value = -1;
+	int Exponent;
+
+	switch (Caps->Format) {
+	case PMBUS_FORMAT_LINEAR16:
+		Value = round(Voltage / pow(2, Caps->Exponent));
+		if (Value > 0xFFFF) {
+			Value = -1;
+		}
+
+		break;
+	case PMBUS_FORMAT_VID:
+		if (Caps->VID_Step == 0) {
+			break;
+		}
+
+		Value = (Voltage == 0) ? 0 :
+			(round((Voltage - Caps->VID_Base) / Caps->VID_Step) + 1);
+		if (Value < 0 || Value > 0xFF) {
+			Value = -1;
+		}
+
+		break;
+	case PMBUS_FORMAT_DIRECT:
+		if (Caps->M == 0) {
+			break;
+		}
+
+		Value = round(((Caps->M * Voltage) + Caps->B) * pow(10, Caps->R));
+		if (Value < SHRT_MIN || Value > SHRT_MAX) {
+			Value = -1;
+			break;
+		}
+
+		Value = (unsigned short)Value;
+		break;
+	case PMBUS_FORMAT_IEEE_HALF:
+		if (Voltage < 0) {
+			break;
+		}
+
+		if (Voltage == 0) {
+			Value = 0;
+			break;
+		}
+
+		/* Voltage = 1.Fraction * 2 ^ (Exponent - 15) */
+		Value = frexp(Voltage, &Exponent);
+		Value = round(((2 * Value) - 1) * 1024);
+		Exponent += 14;
+		if (Value == 1024) {
+			Value = 0;
+			Exponent++;
+		}
+
+		Value = (Exponent <= 0 || Exponent >= 0x1F) ? -1 :
+			((Exponent << 10) | (unsigned int)Value);
+		break;
+	default:
+		break;
+	}
+
+	if (Value < 0) {
+		SC_ERR("%.3f V cannot be encoded in the VOUT format", Voltage);
+		return -1;
+	}
+
+	*Data = (unsigned int)Value;
+	return 0;
+}
+
+/*
+ * Read 'Length' bytes of 'Command' from a PMBus device.
+ */
+static int
+Driver_PMBus_Read(int FD, int Address, unsigned char Command, unsigned char *In,
+		  int Length)
+{
+	struct i2c_msg Msgs[2];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 2 };
+
+	Msgs[0].addr = Msgs[1].addr = Address;
+	Msgs[0].flags = 0;
+	Msgs[0].len = 1;
+	Msgs[0].buf = &Command;
+	Msgs[1].flags = I2C_M_RD;
+	Msgs[1].len = Length;
+	Msgs[1].buf = In;
+	return ((I2C_Transfer(FD, &Msgset) < 0) ? -1 : 0);
+}
+
+/*
+ * Read the printable characters of a block read string, such as MFR_ID.
+ */
+static void
+Driver_PMBus_Read_String(int FD, int Address, unsigned char Command, char *String)
+{
+	unsigned char In[I2C_SMBUS_BLOCK_MAX + 1];
+	int Length = 0;
+
+	String[0] = '\0';
+	if (Driver_PMBus_Read(FD, Address, Command, In, sizeof(In)) != 0) {
+		return;
+	}
+
+	for (int i = 1; i <= In[0] && i < (int)sizeof(In) && Length < (STRLEN_MAX - 1); i++) {
+		if (isprint(In[i])) {
+			String[Length++] = In[i];
+		}
+	}
+
+	String[Length] = '\0';
+}
+
+/*
+ * Read the capabilities of a PMBus regulator on 'FD', an open file
+ * descriptor of its I2C bus: the VOUT format, with the coefficients of the
+ * DIRECT format, the revision and the manufacturer of the device, and the
+ * telemetry commands that it supports.  Must be called with the bus held.
+ */
+static int
+Driver_PMBus_Read_Caps(Voltage_t *Regulator, int FD, PMBus_Caps_t *Caps_p)
+{
+	const Driver_Op_t *Op = &Driver_Ops[DRIVER_PMBUS_TELEMETRY];
+	PMBus_Caps_t Caps = { 0 };
+	struct i2c_msg Msgs[2];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 1 };
+	int Address = Regulator->I2C_Address;
+	unsigned char Out[4];
+	unsigned char In[6];
+	bool Query = true;
+
+	Msgs[0].addr = Msgs[1].addr = Address;
+	Msgs[0].flags = 0;
+	Msgs[0].buf = Out;
+	if (Regulator->Page_Select != -1) {
+		Out[0] = PMBUS_PAGE;
+		Out[1] = Regulator->Page_Select;
+		Msgs[0].len = 2;
+		if (I2C_Transfer(FD, &Msgset) < 0) {
+			SC_ERR("unable to probe %s: %m", Regulator->Name);
+			return -1;
+		}
+	}
+
+	/* For non-compliant regulators, use exponent value -8 */
+	Caps.Format = PMBUS_FORMAT_LINEAR16;
+	Caps.Exponent = -8;
+	if (Regulator->PMBus_VOUT_MODE) {
+		if (Driver_PMBus_Read(FD, Address, PMBUS_VOUT_MODE, In, 1) != 0) {
+			SC_ERR("unable to probe %s: %m", Regulator->Name);
+			return -1;
+		}
+
+		Caps.Relative = ((In[0] & 0x80) != 0);
+		Caps.Fixed_Limits = Caps.Relative;
+		Caps.Format = (In[0] >> 5) & 0x3;
+		Caps.Exponent = (signed char)(In[0] << 3) >> 3;
+		if (Caps.Format == PMBUS_FORMAT_VID || Driver_PMBus_VID_Part(Regulator)) {
+			Caps.Format = PMBUS_FORMAT_VID;
+			Driver_PMBus_VID(Regulator, (In[0] & 0x1F), &Caps);
+		}
+	}
+
+	/* Block write-block read process call of the coefficients of READ_VOUT */
+	if (Caps.Format == PMBUS_FORMAT_DIRECT) {
+		Out[0] = PMBUS_COEFFICIENTS;
+		Out[1] = 2;
+		Out[2] = PMBUS_READ_VOUT;
+		Out[3] = 1;
+		Msgs[0].len = 4;
+		Msgs[1].flags = I2C_M_RD;
+		Msgs[1].len = 6;
+		Msgs[1].buf = In;
+		Msgset.nmsgs = 2;
+		if (I2C_Transfer(FD, &Msgset) >= 0 && In[0] == 5) {
+			Caps.M = (short)((In[2] << 8) | In[1]);
+			Caps.B = (short)((In[4] << 8) | In[3]);
+			Caps.R = (signed char)In[5];
+		} else {
+			SC_ERR("coefficients of %s are not available", Regulator->Name);
+		}
+	}
+
+	Caps.Revision = -1;
+	if (Driver_PMBus_Read(FD, Address, PMBUS_REVISION, In, 1) == 0) {
+		Caps.Revision = In[0];
+	}
+
+	Driver_PMBus_Read_String(FD, Address, PMBUS_MFR_ID, Caps.MFR_ID);
+	Driver_PMBus_Read_String(FD, Address, PMBUS_MFR_MODEL, Caps.MFR_Model);
+	for (int i = PMBUS_TELEMETRY_VIN; i < Op->Numbers; i++) {
+		if (Driver_PMBus_Supports(FD, Address, &Op->Driver->Reg[Op->Reg[i]],
+					  &Query)) {
+			Caps.Telemetry |= (1 << i);
+		}
+	}
+
+	/* Nothing answered, so the device may be absent; probe it again */
+	if (!Regulator->PMBus_VOUT_MODE && Caps.Telemetry == 0) {
+		SC_ERR("unable to probe %s", Regulator->Name);
+		return -1;
+	}
+
+	SC_INFO("%s: VOUT format %d, exponent %d, revision %#x, %s %s, telemetry %#x",
+		Regulator->Name, Caps.Format, Caps.Exponent, Caps.Revision,
+		Caps.MFR_ID, Caps.MFR_Model, Caps.Telemetry);
+	Caps.Probed = true;
+	*Caps_p = Caps;
+	return 0;
+}
+
+/*
+ * Probe the capabilities of a PMBus regulator on 'FD', an open file
+ * descriptor of its I2C bus, unless they are known already.
+ */
+static int
+Driver_PMBus_Probe_Regulator(Voltage_t *Regulator, int FD)
+{
+	PMBus_Caps_t Caps;
+	int Ret;
+
+	if (Regulator->PMBus_Caps.Probed) {
+		return 0;
+	}
+
+	if (I2C_Bus_Lock(Regulator->I2C_Bus) != 0) {
+		return -1;
+	}
+
+	Ret = Driver_PMBus_Read_Caps(Regulator, FD, &Caps);
+	I2C_Bus_Unlock(Regulator->I2C_Bus);
+	if (Ret == 0) {
+		Regulator->PMBus_Caps = Caps;
+	}
+
+	return Ret;
+}
+
+/*
+ * Return the capabilities of a PMBus regulator, probing them the first time.
+ */
+PMBus_Caps_t *
+Driver_PMBus_Caps(Voltage_t *Regulator)
+{
+	int FD;
+	int Ret;
+
+	if (Regulator->PMBus_Caps.Probed) {
+		return &Regulator->PMBus_Caps;
+	}
+
+	FD = I2C_Open(Regulator->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", Regulator->I2C_Bus);
+		return NULL;
+	}
+
+	Ret = Driver_PMBus_Probe_Regulator(Regulator, FD);
+	(void) close(FD);
+	return ((Ret == 0) ? &Regulator->PMBus_Caps : NULL);
+}
+
+/*
+ * Probe the capabilities of all regulators of the board, over one open file
+ * descriptor per I2C bus.  Regulators that do not answer, e.g. since they are
+ * not powered yet, are probed again when they are first accessed.
+ */
+int
+Driver_PMBus_Probe(void)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	bool Done[LITEMS_MAX] = { false };
+	int FD;
+
+	for (int i = 0; Voltages != NULL && i < Voltages->Numbers; i++) {
+		if (Done[i]) {
+			continue;
+		}
+
+		FD = I2C_Open(Voltages->Voltage[i].I2C_Bus);
+		for (int j = i; j < Voltages->Numbers; j++) {
+			if (Done[j] || strcmp(Voltages->Voltage[j].I2C_Bus,
+					      Voltages->Voltage[i].I2C_Bus) != 0) {
+				continue;
+			}
+
+			Done[j] = true;
+			if (FD >= 0) {
+				(void) Driver_PMBus_Probe_Regulator(&Voltages->Voltage[j], FD);
+			}
+		}
+
+		if (FD < 0) {
+			SC_ERR("unable to access I2C bus %s: %m", Voltages->Voltage[i].I2C_Bus);
+			continue;
+		}
+
+		(void) close(FD);
+	}
+
+	return 0;
+}
+
+/*
+ * Return the telemetry plan of a PMBus regulator, compiled the first time to
+ * read only the telemetry commands that the regulator supports.  'FD' is an
+ * open file descriptor of its I2C bus.  The results of unsupported commands
+ * are left as they are.  The plan selects the page of the regulator, so it is
+ * run with the bus held.
+ */
+Driver_Plan_t *
+Driver_PMBus_Telemetry_Plan(Voltage_t *Regulator, int FD)
+{
+	const Driver_Op_t *Op = &Driver_Ops[DRIVER_PMBUS_TELEMETRY];
+	long Index = Regulator - Plat_Devs->Voltages->Voltage;
+	Driver_Plan_t **Plan = &Driver_Plans[DRIVER_PMBUS_TELEMETRY][Index];
+	PMBus_Caps_t *Caps = &Regulator->PMBus_Caps;
+
+	if (*Plan != NULL) {
+		return *Plan;
+	}
+
+	if (Driver_PMBus_Probe_Regulator(Regulator, FD) != 0) {
+		return NULL;
+	}
+
+	if (Caps->Telemetry == 0) {
+		SC_ERR("no telemetry is available from %s", Regulator->Name);
+		return NULL;
+	}
+
+	/* VOUT_MODE is cached */
+	*Plan = Driver_Compile_Plan(Op, Regulator->I2C_Bus, Regulator->I2C_Address,
+				    Regulator->Page_Select,
+				    (~Caps->Telemetry & ((1 << Op->Numbers) - 1)));
+	if (*Plan != NULL) {
+		(*Plan)->Caps = Caps;
+	}
+
+	return *Plan;
+}
+
+/*
+ * Read the VOUT limit 'Command' of a PMBus regulator in volts, on 'FD' with
+ * its page selected and the bus held.  A relative limit is a ratio of 'Vout'.
+ */
+int
+Driver_PMBus_Read_Limit(Voltage_t *Regulator, int FD, unsigned char Command,
+			float Vout, float *Limit)
+{
+	PMBus_Caps_t *Caps = &Regulator->PMBus_Caps;
+	unsigned char In[2];
+
+	if (!Caps->Probed ||
+	    Driver_PMBus_Read(FD, Regulator->I2C_Address, Command, In, 2) != 0) {
+		return -1;
+	}
+
+	*Limit = Driver_PMBus_Decode_Vout(Caps, ((In[1] << 8) | In[0]));
+	if (Caps->Relative) {
+		*Limit *= Vout;
+	}
+
+	return 0;
+}
+
+/*
+ * Read the output current and temperature of each phase of a multi-phase
+ * controller into Current[] and Temperature[], which have room for
+ * 'Phases' of the regulator.  A phase is selected with PHASE, on the page
+ * of the regulator, and all phases are selected again at the end.  The
+ * results of the phases that do not answer are NAN.
+ */
+int
+Driver_PMBus_Phases(Voltage_t *Regulator, float *Current, float *Temperature)
+{
+	struct i2c_msg Msgs[1];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 1 };
+	int Address = Regulator->I2C_Address;
+	unsigned char Out[2];
+	unsigned char In[2];
+	int FD;
+	int Ret = 0;
+
+	if (Regulator->Phases <= 0) {
+		SC_ERR("%s is not a multi-phase controller", Regulator->Name);
+		return -1;
+	}
+
+	FD = I2C_Open(Regulator->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", Regulator->I2C_Bus);
+		return -1;
+	}
+
+	if (I2C_Bus_Lock(Regulator->I2C_Bus) != 0) {
+		(void) close(FD);
+		return -1;
+	}
+
+	Msgs[0].addr = Address;
+	Msgs[0].flags = 0;
+	Msgs[0].len = 2;
+	Msgs[0].buf = Out;
+	if (Regulator->Page_Select != -1) {
+		Out[0] = PMBUS_PAGE;
+		Out[1] = Regulator->Page_Select;
+		if (I2C_Transfer(FD, &Msgset) < 0) {
+			SC_ERR("unable to access %s: %m", Regulator->Name);
+			I2C_Bus_Unlock(Regulator->I2C_Bus);
+			(void) close(FD);
+			return -1;
+		}
+	}
+
+	Out[0] = PMBUS_PHASE;
+	for (int i = 0; i < Regulator->Phases; i++) {
+		Current[i] = Temperature[i] = NAN;
+		Out[1] = i;
+		if (I2C_Transfer(FD, &Msgset) < 0) {
+			SC_ERR("unable to select phase %d of %s: %m", i, Regulator->Name);
+			Ret = -1;
+			break;
+		}
+
+		if (Driver_PMBus_Read(FD, Address, PMBUS_READ_IOUT, In, 2) == 0) {
+			Current[i] = Driver_Decode_Linear11((In[1] << 8) | In[0]);
+		}
+
+		if (Driver_PMBus_Read(FD, Address, PMBUS_READ_TEMPERATURE_1, In, 2) == 0) {
+			Temperature[i] = Driver_Decode_Linear11((In[1] << 8) | In[0]);
+		}
+	}
+
+	Out[1] = 0xFF;
+	if (I2C_Transfer(FD, &Msgset) < 0) {
+		SC_ERR("unable to select all phases of %s: %m", Regulator->Name);
+		Ret = -1;
+	}
+
+	I2C_Bus_Unlock(Regulator->I2C_Bus);
+	(void) close(FD);
+	return Ret;
+}
+
+/*
+ * Stop, or resume, tracing the plans run by the calling thread, and
+ * reporting their failures.
+ */
+void
+Driver_Quiet(bool Enable)
+{
+	Quiet = Enable;
+}
+
+/*
+ * Run a compiled plan.
+ */
+int
+Driver_Run(Driver_Plan_t *Plan, unsigned int *Raw, float *Value)
+{
+	int FD;
+	int Ret;
+
+	FD = I2C_Open(Plan->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", Plan->I2C_Bus);
+		return -1;
+	}
+
+	Ret = Driver_Execute(Plan, FD, Raw, Value);
+	(void) close(FD);
+	return Ret;
+}
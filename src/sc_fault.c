@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+
+/*
+ * PMBus Fault Monitor
+ *
+ * A thread reads STATUS_WORD of every regulator page with background I2C
+ * priority, at an interval of 'Fault_Interval' milliseconds from the config
+ * file, which is 0 to disable polling.  The pages of a regulator that
+ * declares an 'SMBALERT_Line' in the board JSON are not polled; they are read
+ * when the line is asserted instead.  The detailed STATUS_* bytes are read
+ * only for the summary bits that are set.  Every change of the status of a
+ * page is recorded, with its time, in a log of the last FAULT_LOG_MAX changes.
+ *
+ * SMBALERT# stays asserted as long as any fault is latched, and only its
+ * falling edge is watched, so a page that was read with latched faults is sent
+ * CLEAR_FAULTS and read again after an interval, until it reads clear.  A
+ * fault that persists is latched again, and is seen by the next read.
+ */
+#define FAULT_INTERVAL		1000	// ms
+#define FAULT_LOG_MAX		64
+
+/* STATUS_WORD bits that report the state rather than a latched fault */
+#define FAULT_NOT_LATCHED	0x0840	// POWER_GOOD#, OFF
+
+/* Detailed status registers, and the STATUS_WORD bits that summarize them */
+static const struct {
+	const char	*Name;
+	unsigned char	Command;
+	unsigned short	Summary;
+} Fault_Details[] = {
+	{ "STATUS_VOUT", 0x7A, 0x8000 },
+	{ "STATUS_IOUT", 0x7B, 0x4000 },
+	{ "STATUS_INPUT", 0x7C, 0x2000 },
+	{ "STATUS_TEMPERATURE", 0x7D, 0x0004 },
+	{ "STATUS_CML", 0x7E, 0x0002 },
+};
+
+#define FAULT_DETAILS	(int)(sizeof(Fault_Details) / sizeof(Fault_Details[0]))
+
+static const char *Fault_Bits[16] = {
+	"NONE_OF_THE_ABOVE", "CML", "TEMPERATURE", "VIN_UV", "IOUT_OC",
+	"VOUT_OV", "OFF", "BUSY", "UNKNOWN", "OTHER", "FANS", "POWER_GOOD#",
+	"MFR", "INPUT", "IOUT/POUT", "VOUT",
+};
+
+typedef struct {
+	unsigned short	Status_Word;
+	unsigned char	Status[FAULT_DETAILS];
+} Fault_Status_t;
+
+typedef struct {
+	Voltage_t	*Regulator;	// first regulator on the page
+	bool		Alerted;
+	bool		Recheck;	// faults were cleared, read again
+	bool		Valid;
+	Fault_Status_t	Status;
+	struct timespec	Since;
+} Fault_Page_t;
+
+static struct {
+	pthread_mutex_t	Lock;
+	pthread_cond_t	Cond;
+	bool		Running;
+	int		Interval;
+	int		Numbers;
+	Fault_Page_t	Page[LITEMS_MAX];
+	int		Log_Numbers;	// total number of changes
+	struct {
+		struct timespec	Time;
+		int		Page;
+		Fault_Status_t	Status;
+	} Log[FAULT_LOG_MAX];
+} Faults = {
+	.Lock = PTHREAD_MUTEX_INITIALIZER,
+	.Cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* Serializes the polls of the thread and of the commands */
+static pthread_mutex_t Fault_Poll_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool
+Fault_Same_Page(Voltage_t *Regulator1, Voltage_t *Regulator2)
+{
+	return (strcmp(Regulator1->I2C_Bus, Regulator2->I2C_Bus) == 0 &&
+		Regulator1->I2C_Address == Regulator2->I2C_Address &&
+		Regulator1->Page_Select == Regulator2->Page_Select);
+}
+
+/*
+ * Queue the reads of 'Command' on the pages that are selected, one sequence
+ * per I2C bus as long as it has room.  A 'Length' of 0 sends the command
+ * without reading.  The op of each page is returned in 'Ops', or -1 if the
+ * page is not selected.
+ */
+static int
+Fault_Submit(bool *Selected, unsigned char Command, int Length,
+	     I2C_Sequence_t **Sequences, I2C_Sequence_t **Of, int *Ops)
+{
+	Voltage_t *Regulator;
+	I2C_Sequence_t *Sequence;
+	unsigned char Buffer[2];
+	int Numbers = 0;
+
+	for (int i = 0; i < Faults.Numbers; i++) {
+		Ops[i] = -1;
+	}
+
+	for (int i = 0; i < Faults.Numbers; i++) {
+		if (!Selected[i]) {
+			continue;
+		}
+
+		Regulator = Faults.Page[i].Regulator;
+		Sequence = NULL;
+		for (int j = 0; j < Numbers; j++) {
+			if (strcmp(Sequences[j]->I2C_Bus, Regulator->I2C_Bus) == 0 &&
+			    (Sequences[j]->Numbers + 2) <= ITEMS_MAX) {
+				Sequence = Sequences[j];
+			}
+		}
+
+		if (Sequence == NULL) {
+			Sequence = (I2C_Sequence_t *)calloc(1, sizeof(I2C_Sequence_t));
+			if (Sequence == NULL) {
+				SC_ERR("failed to allocate fault sequence: %m");
+				break;
+			}
+
+			Sequence->I2C_Bus = Regulator->I2C_Bus;
+			Sequence->Priority = I2C_PRIORITY_BACKGROUND;
+			Sequences[Numbers++] = Sequence;
+		}
+
+		if (Regulator->Page_Select != -1) {
+			Buffer[0] = PMBUS_PAGE;
+			Buffer[1] = Regulator->Page_Select;
+			(void) I2C_Sequence_Add(Sequence, I2C_OP_WRITE,
+						Regulator->I2C_Address, 2, Buffer, 0);
+		}
+
+		Buffer[0] = Command;
+		Ops[i] = I2C_Sequence_Add(Sequence, ((Length == 0) ? I2C_OP_WRITE :
+						     I2C_OP_READ),
+					  Regulator->I2C_Address, 1, Buffer, Length);
+		Of[i] = Sequence;
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		if (I2C_Submit(Sequences[i]) != 0) {
+			Sequences[i]->Status = -1;
+			Sequences[i]->Failed_Op = -1;
+			Sequences[i]->Completed = true;
+		}
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		(void) I2C_Wait(Sequences[i]);
+	}
+
+	return Numbers;
+}
+
+/*
+ * Read the status of the selected pages and log the changes.  When 'Clear'
+ * is set, the latched faults of the pages with an SMBALERT line are cleared,
+ * and the pages are marked to be read again.
+ */
+static void
+Fault_Poll(bool *Selected, bool Clear)
+{
+	I2C_Sequence_t *Sequences[LITEMS_MAX];
+	I2C_Sequence_t *Of[LITEMS_MAX];
+	int Ops[LITEMS_MAX];
+	Fault_Status_t Status[LITEMS_MAX] = { 0 };
+	bool Read[LITEMS_MAX] = { false };
+	bool Detail[LITEMS_MAX];
+	bool Latched[LITEMS_MAX];
+	struct timespec Now;
+	Fault_Page_t *Page;
+	int Numbers;
+
+	(void) pthread_mutex_lock(&Fault_Poll_Lock);
+	Numbers = Fault_Submit(Selected, PMBUS_STATUS_WORD, 2, Sequences, Of, Ops);
+	for (int i = 0; i < Faults.Numbers; i++) {
+		if (Ops[i] == -1 || I2C_Op_Failed(Of[i], Ops[i])) {
+			continue;
+		}
+
+		Read[i] = true;
+		Status[i].Status_Word = (Of[i]->Op[Ops[i]].In[1] << 8) |
+					Of[i]->Op[Ops[i]].In[0];
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		free(Sequences[i]);
+	}
+
+	for (int j = 0; j < FAULT_DETAILS; j++) {
+		for (int i = 0; i < Faults.Numbers; i++) {
+			Detail[i] = (Read[i] && (Status[i].Status_Word &
+						 Fault_Details[j].Summary));
+		}
+
+		Numbers = Fault_Submit(Detail, Fault_Details[j].Command, 1,
+				       Sequences, Of, Ops);
+		for (int i = 0; i < Faults.Numbers; i++) {
+			if (Ops[i] != -1 && !I2C_Op_Failed(Of[i], Ops[i])) {
+				Status[i].Status[j] = Of[i]->Op[Ops[i]].In[0];
+			}
+		}
+
+		for (int i = 0; i < Numbers; i++) {
+			free(Sequences[i]);
+		}
+	}
+
+	for (int i = 0; i < Faults.Numbers; i++) {
+		Latched[i] = (Clear && Read[i] &&
+			      Faults.Page[i].Regulator->SMBALERT_Line != NULL &&
+			      (Status[i].Status_Word & ~FAULT_NOT_LATCHED));
+	}
+
+	Numbers = Fault_Submit(Latched, PMBUS_CLEAR_FAULTS, 0, Sequences, Of, Ops);
+	for (int i = 0; i < Numbers; i++) {
+		free(Sequences[i]);
+	}
+
+	(void) clock_gettime(CLOCK_REALTIME, &Now);
+	(void) pthread_mutex_lock(&Faults.Lock);
+	for (int i = 0; i < Faults.Numbers; i++) {
+		Page = &Faults.Page[i];
+		if (Clear && Selected[i] && Page->Regulator->SMBALERT_Line != NULL) {
+			Page->Recheck = (Latched[i] || !Read[i]);
+		}
+
+		if (!Read[i]) {
+			if (Selected[i]) {
+				SC_INFO("failed to read status of %s", Page->Regulator->Name);
+			}
+
+			continue;
+		}
+
+		if (Page->Valid &&
+		    memcmp(&Page->Status, &Status[i], sizeof(Fault_Status_t)) == 0) {
+			continue;
+		}
+
+		Page->Valid = true;
+		Page->Status = Status[i];
+		Page->Since = Now;
+		Faults.Log[Faults.Log_Numbers % FAULT_LOG_MAX].Time = Now;
+		Faults.Log[Faults.Log_Numbers % FAULT_LOG_MAX].Page = i;
+		Faults.Log[Faults.Log_Numbers % FAULT_LOG_MAX].Status = Status[i];
+		Faults.Log_Numbers++;
+	}
+
+	(void) pthread_mutex_unlock(&Faults.Lock);
+	(void) pthread_mutex_unlock(&Fault_Poll_Lock);
+}
+
+static void
+Fault_Alert(void *Arg, unsigned long long Time)
+{
+	(void) Time;
+	(void) pthread_mutex_lock(&Faults.Lock);
+	for (int i = 0; i < Faults.Numbers; i++) {
+		if (Faults.Page[i].Regulator->SMBALERT_Line != NULL &&
+		    strcmp(Faults.Page[i].Regulator->SMBALERT_Line, (char *)Arg) == 0) {
+			Faults.Page[i].Alerted = true;
+		}
+	}
+
+	(void) pthread_cond_signal(&Faults.Cond);
+	(void) pthread_mutex_unlock(&Faults.Lock);
+}
+
+static void *
+Fault_Monitor(void *Arg)
+{
+	bool Selected[LITEMS_MAX];
+	struct timespec Timeout;
+	bool Poll;
+	int Base;
+	int Interval;
+	int Ret;
+
+	(void) Arg;
+	for (int i = 0; i < Faults.Numbers; i++) {
+		Selected[i] = true;
+	}
+
+	Fault_Poll(Selected, true);
+	while (1) {
+		/* The pages whose faults were cleared are read even without polling */
+		Base = Faults.Interval;
+		for (int i = 0; Base <= 0 && i < Faults.Numbers; i++) {
+			if (Faults.Page[i].Recheck) {
+				Base = FAULT_INTERVAL;
+			}
+		}
+
+		/* Back off when any of the buses is busy */
+		Interval = Base;
+		for (int i = 0; Interval > 0 && i < Faults.Numbers; i++) {
+			Ret = I2C_Background_Interval(Faults.Page[i].Regulator->I2C_Bus,
+						      Base);
+			if (Ret > Interval) {
+				Interval = Ret;
+			}
+		}
+
+		(void) clock_gettime(CLOCK_REALTIME, &Timeout);
+		Timeout.tv_sec += Interval / 1000;
+		Timeout.tv_nsec += (long)(Interval % 1000) * 1000000;
+		if (Timeout.tv_nsec >= 1000000000) {
+			Timeout.tv_sec++;
+			Timeout.tv_nsec -= 1000000000;
+		}
+
+		(void) pthread_mutex_lock(&Faults.Lock);
+		Poll = false;
+		Ret = 0;
+		while (!Poll && Ret == 0) {
+			for (int i = 0; i < Faults.Numbers; i++) {
+				Poll |= Faults.Page[i].Alerted;
+			}
+
+			if (Poll) {
+				break;
+			}
+
+			if (Interval > 0) {
+				Ret = pthread_cond_timedwait(&Faults.Cond, &Faults.Lock,
+							     &Timeout);
+			} else {
+				(void) pthread_cond_wait(&Faults.Cond, &Faults.Lock);
+			}
+		}
+
+		for (int i = 0; i < Faults.Numbers; i++) {
+			Selected[i] = (Faults.Page[i].Alerted ||
+				       (Ret != 0 &&
+					((Faults.Interval > 0 &&
+					  Faults.Page[i].Regulator->SMBALERT_Line == NULL) ||
+					 Faults.Page[i].Recheck)));
+			Faults.Page[i].Alerted = false;
+		}
+
+		(void) pthread_mutex_unlock(&Faults.Lock);
+		Fault_Poll(Selected, true);
+	}
+
+	return NULL;
+}
+
+/*
+ * Find the pages of the regulators, and start monitoring them.
+ */
+int
+Fault_Monitor_Start(void)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	Voltage_t *Regulator;
+	char Value[LSTRLEN_MAX];
+	pthread_t Thread;
+	bool Alerts = false;
+	bool Watched;
+	int Found = 0;
+	int i;
+
+	if (Voltages == NULL) {
+		return 0;
+	}
+
+	if (Check_Config_File("Fault_Interval", Value, &Found) != 0) {
+		return -1;
+	}
+
+	Faults.Interval = (Found ? atoi(Value) : FAULT_INTERVAL);
+	for (int j = 0; j < Voltages->Numbers; j++) {
+		Regulator = &Voltages->Voltage[j];
+		for (i = 0; i < Faults.Numbers; i++) {
+			if (Fault_Same_Page(Faults.Page[i].Regulator, Regulator)) {
+				break;
+			}
+		}
+
+		if (i < Faults.Numbers) {
+			continue;
+		}
+
+		Faults.Page[Faults.Numbers++].Regulator = Regulator;
+		if (Regulator->SMBALERT_Line == NULL) {
+			continue;
+		}
+
+		/* Regulators often share an alert line, which is watched once */
+		Watched = false;
+		for (i = 0; i < j; i++) {
+			if (Voltages->Voltage[i].SMBALERT_Line != NULL &&
+			    strcmp(Voltages->Voltage[i].SMBALERT_Line,
+				   Regulator->SMBALERT_Line) == 0) {
+				Watched = true;
+			}
+		}
+
+		if (!Watched && Watch_GPIO(Regulator->SMBALERT_Line, true, Fault_Alert,
+					   Regulator->SMBALERT_Line) != 0) {
+			SC_ERR("failed to watch SMBALERT line of %s", Regulator->Name);
+			return -1;
+		}
+
+		Alerts = true;
+	}
+
+	if (Faults.Numbers == 0 || (Faults.Interval <= 0 && !Alerts)) {
+		SC_INFO("fault monitor is disabled");
+		return 0;
+	}
+
+	if (pthread_create(&Thread, NULL, Fault_Monitor, NULL) != 0) {
+		SC_ERR("failed to start fault monitor: %m");
+		return -1;
+	}
+
+	(void) pthread_detach(Thread);
+	Faults.Running = true;
+	return 0;
+}
+
+static void
+Fault_Print_Status(const char *Time, Voltage_t *Regulator, Fault_Status_t *Status)
+{
+	char Line[SYSCMD_MAX];
+	int Length;
+
+	Length = snprintf(Line, sizeof(Line), "%s\t%s\t%#06x", Time, Regulator->Name,
+			  Status->Status_Word);
+	for (int i = 15; i >= 0; i--) {
+		if (Status->Status_Word & (1 << i)) {
+			Length += snprintf(&Line[Length], (sizeof(Line) - Length), " %s",
+					   Fault_Bits[i]);
+		}
+	}
+
+	for (int i = 0; i < FAULT_DETAILS; i++) {
+		if (Status->Status_Word & Fault_Details[i].Summary) {
+			Length += snprintf(&Line[Length], (sizeof(Line) - Length),
+					   " %s=%#04x", Fault_Details[i].Name,
+					   Status->Status[i]);
+		}
+	}
+
+	SC_PRINT("%s", Line);
+}
+
+static void
+Fault_Time(struct timespec *TS, char *Time, int Length)
+{
+	struct tm TM;
+	int Count;
+
+	(void) localtime_r(&TS->tv_sec, &TM);
+	Count = strftime(Time, Length, "%F %T", &TM);
+	(void) snprintf(&Time[Count], (Length - Count), ".%03ld",
+			TS->tv_nsec / 1000000);
+}
+
+/*
+ * Print the status of the page of 'Target' regulator, or of all pages, with
+ * the time it was first seen.  The status is read now if it is not monitored.
+ */
+int
+Fault_Print_State(char *Target)
+{
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	bool Selected[LITEMS_MAX] = { false };
+	char Time[STRLEN_MAX];
+	int Numbers = 0;
+
+	for (int i = 0; i < Faults.Numbers; i++) {
+		for (int j = 0; j < Voltages->Numbers; j++) {
+			if ((strcmp(Target, "all") == 0 ||
+			     strcmp(Target, Voltages->Voltage[j].Name) == 0) &&
+			    Fault_Same_Page(Faults.Page[i].Regulator,
+					    &Voltages->Voltage[j])) {
+				Selected[i] = true;
+			}
+		}
+
+		Numbers += Selected[i];
+	}
+
+	if (Numbers == 0) {
+		SC_ERR("invalid regulator target");
+		return -1;
+	}
+
+	if (!Faults.Running) {
+		Fault_Poll(Selected, false);
+	}
+
+	SC_PRINT("Since\tTarget\tSTATUS_WORD");
+	(void) pthread_mutex_lock(&Faults.Lock);
+	for (int i = 0; i < Faults.Numbers; i++) {
+		if (!Selected[i]) {
+			continue;
+		}
+
+		if (!Faults.Page[i].Valid) {
+			SC_PRINT("N/A\t%s\tN/A", Faults.Page[i].Regulator->Name);
+			continue;
+		}
+
+		Fault_Time(&Faults.Page[i].Since, Time, sizeof(Time));
+		Fault_Print_Status(Time, Faults.Page[i].Regulator,
+				   &Faults.Page[i].Status);
+	}
+
+	(void) pthread_mutex_unlock(&Faults.Lock);
+	return 0;
+}
+
+/*
+ * Print the log of status changes, oldest first.
+ */
+int
+Fault_Print_Log(void)
+{
+	char Time[STRLEN_MAX];
+	int First;
+
+	(void) pthread_mutex_lock(&Faults.Lock);
+	First = ((Faults.Log_Numbers > FAULT_LOG_MAX) ?
+		 (Faults.Log_Numbers - FAULT_LOG_MAX) : 0);
+	SC_PRINT("Time\tTarget\tSTATUS_WORD");
+	for (int i = First; i < Faults.Log_Numbers; i++) {
+		Fault_Time(&Faults.Log[i % FAULT_LOG_MAX].Time, Time, sizeof(Time));
+		Fault_Print_Status(Time,
+				   Faults.Page[Faults.Log[i % FAULT_LOG_MAX].Page].Regulator,
+				   &Faults.Log[i % FAULT_LOG_MAX].Status);
+	}
+
+	(void) pthread_mutex_unlock(&Faults.Lock);
+	return 0;
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <dirent.h>
+#include <limits.h>
+#include <libgen.h>
+#include "sc_app.h"
+
+/*
+ * hwmon Fast Path
+ *
+ * When a kernel driver such as ina2xx, pmbus, or jc42 is bound to a device
+ * that sc_appd also accesses, reading the device through /dev/i2c-N with
+ * I2C_SLAVE_FORCE competes with the driver.  At startup, the hwmon devices
+ * are discovered and mapped by bus and address, so that the sensors of those
+ * devices are read from their hwmon attributes instead.  The attributes are
+ * kept open and re-read in batches with Sysfs_Read().  Raw I2C access is used
+ * only for the devices with no bound driver.
+ */
+#define HWMON_DIR		"/sys/class/hwmon"
+#define HWMON_MAX		ITEMS_MAX
+#define HWMON_ATTRS_MAX		16
+#define HWMON_CHANNELS_MAX	32
+
+typedef struct {
+	char	Key[STRLEN_MAX];	/* attribute or channel label */
+	int	FD;
+} Hwmon_Attr_t;
+
+typedef struct {
+	char		Path[PATH_MAX];
+	char		Name[STRLEN_MAX];
+	int		Bus;
+	int		Address;
+	int		Numbers;
+	Hwmon_Attr_t	Attr[HWMON_ATTRS_MAX];
+} Hwmon_t;
+
+static struct {
+	int	Numbers;
+	Hwmon_t	Hwmon[HWMON_MAX];
+} Hwmons;
+
+static Hwmon_t *
+Hwmon_Find(const char *I2C_Bus, int Address, const char *Driver)
+{
+	int Bus = I2C_Bus_Number(I2C_Bus);
+
+	for (int i = 0; i < Hwmons.Numbers; i++) {
+		if (Hwmons.Hwmon[i].Bus == Bus &&
+		    Hwmons.Hwmon[i].Address == Address &&
+		    (Driver == NULL ||
+		     strncmp(Hwmons.Hwmon[i].Name, Driver, strlen(Driver)) == 0)) {
+			return &Hwmons.Hwmon[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int
+Hwmon_Read_File(const char *Path, char *Buffer, int Length)
+{
+	int FD;
+	ssize_t Count;
+
+	FD = open(Path, O_RDONLY);
+	if (FD < 0) {
+		return -1;
+	}
+
+	Count = read(FD, Buffer, Length - 1);
+	(void) close(FD);
+	if (Count <= 0) {
+		return -1;
+	}
+
+	Buffer[Count] = '\0';
+	Buffer[strcspn(Buffer, "\n")] = '\0';
+	return 0;
+}
+
+/*
+ * Return the persistent FD of attribute 'Attribute' of the hwmon device.  If
+ * 'Label' is given instead, the voltage, current, or power input channel
+ * whose label matches it is looked up, e.g. 'vout2' for page 1 of a PMBus
+ * regulator.
+ */
+static int
+Hwmon_Attribute(Hwmon_t *Hwmon, const char *Attribute, const char *Label)
+{
+	const char *Key = ((Label != NULL) ? Label : Attribute);
+	const char *Types[] = { "in", "curr", "power" };
+	char Path[PATH_MAX + STRLEN_MAX];
+	char Buffer[STRLEN_MAX];
+	int FD = -1;
+
+	for (int i = 0; i < Hwmon->Numbers; i++) {
+		if (strcmp(Hwmon->Attr[i].Key, Key) == 0) {
+			return Hwmon->Attr[i].FD;
+		}
+	}
+
+	if (Hwmon->Numbers == HWMON_ATTRS_MAX) {
+		return -1;
+	}
+
+	if (Label == NULL) {
+		(void) snprintf(Path, sizeof(Path), "%s/%s", Hwmon->Path, Attribute);
+		FD = open(Path, O_RDONLY | O_CLOEXEC);
+	} else {
+		for (int i = 0; i <= (HWMON_CHANNELS_MAX * 3) && FD < 0; i++) {
+			(void) snprintf(Path, sizeof(Path), "%s/%s%d_label",
+					Hwmon->Path, Types[i % 3], (i / 3));
+			if (Hwmon_Read_File(Path, Buffer, sizeof(Buffer)) != 0 ||
+			    strcmp(Buffer, Label) != 0) {
+				continue;
+			}
+
+			(void) snprintf(Path, sizeof(Path), "%s/%s%d_input",
+					Hwmon->Path, Types[i % 3], (i / 3));
+			FD = open(Path, O_RDONLY | O_CLOEXEC);
+		}
+	}
+
+	/* Remember missing attributes as well, so they are not looked up again */
+	(void) strncpy(Hwmon->Attr[Hwmon->Numbers].Key, Key, STRLEN_MAX - 1);
+	Hwmon->Attr[Hwmon->Numbers].FD = FD;
+	Hwmon->Numbers++;
+	return FD;
+}
+
+/*
+ * Read the attributes, or the labelled input channels, of the hwmon device
+ * in one batch.
+ */
+static int
+Hwmon_Read(Hwmon_t *Hwmon, int Numbers, const char **Attributes,
+	   const char **Labels, long *Values)
+{
+	Sysfs_Attr_t Attrs[HWMON_ATTRS_MAX];
+	char Buffer[HWMON_ATTRS_MAX][STRLEN_MAX];
+	char *End_p;
+
+	for (int i = 0; i < Numbers; i++) {
+		Attrs[i].Path = NULL;
+		Attrs[i].FD = Hwmon_Attribute(Hwmon, ((Attributes != NULL) ?
+					      Attributes[i] : NULL),
+					      ((Labels != NULL) ? Labels[i] : NULL));
+		if (Attrs[i].FD < 0) {
+			return -1;
+		}
+
+		Attrs[i].Buffer = Buffer[i];
+		Attrs[i].Length = STRLEN_MAX;
+	}
+
+	if (Sysfs_Read(Attrs, Numbers) != 0) {
+		SC_INFO("failed to read attributes of %s", Hwmon->Path);
+		return -1;
+	}
+
+	for (int i = 0; i < Numbers; i++) {
+		Values[i] = strtol(Buffer[i], &End_p, 10);
+		if (End_p == Buffer[i]) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Discover the hwmon devices that are bound to I2C devices.
+ */
+int
+Hwmon_Init(void)
+{
+	DIR *Dir;
+	struct dirent *Entry;
+	Hwmon_t *Hwmon;
+	char Path[PATH_MAX + STRLEN_MAX];
+	char Device[PATH_MAX];
+	char Value[LSTRLEN_MAX];
+	int Found = 0;
+
+	/* Replayed I2C traffic must not be mixed with live sensor readings */
+	if (Check_Config_File("I2C_Replay", Value, &Found) != 0) {
+		return -1;
+	}
+
+	if (Found) {
+		return 0;
+	}
+
+	Dir = opendir(HWMON_DIR);
+	if (Dir == NULL) {
+		SC_INFO("no hwmon device is available: %m");
+		return 0;
+	}
+
+	while ((Entry = readdir(Dir)) != NULL && Hwmons.Numbers < HWMON_MAX) {
+		if (strncmp(Entry->d_name, "hwmon", 5) != 0) {
+			continue;
+		}
+
+		Hwmon = &Hwmons.Hwmon[Hwmons.Numbers];
+		(void) memset(Hwmon, 0, sizeof(Hwmon_t));
+		(void) snprintf(Hwmon->Path, sizeof(Hwmon->Path), "%s/%s", HWMON_DIR,
+				Entry->d_name);
+
+		/* The device of an I2C client is named <bus>-<4-digit address> */
+		(void) snprintf(Path, sizeof(Path), "%s/device", Hwmon->Path);
+		if (realpath(Path, Device) == NULL ||
+		    sscanf(basename(Device), "%d-%4x", &Hwmon->Bus,
+			   &Hwmon->Address) != 2) {
+			continue;
+		}
+
+		(void) snprintf(Path, sizeof(Path), "%s/name", Hwmon->Path);
+		if (Hwmon_Read_File(Path, Hwmon->Name, sizeof(Hwmon->Name)) != 0) {
+			continue;
+		}
+
+		SC_INFO("%s: %s on bus %d at %#x", Hwmon->Path, Hwmon->Name,
+			Hwmon->Bus, Hwmon->Address);
+		Hwmons.Numbers++;
+	}
+
+	(void) closedir(Dir);
+	return 0;
+}
+
+/*
+ * Get voltage, current, and power of an INA226 bound to the ina2xx driver.
+ */
+int
+Hwmon_Get_Power(INA226_t *INA226, float *Voltage, float *Current, float *Power)
+{
+	Hwmon_t *Hwmon;
+	const char *Attributes[] = { "in1_input", "curr1_input", "power1_input" };
+	long Values[3];
+
+	Hwmon = Hwmon_Find(INA226->I2C_Bus, INA226->I2C_Address, "ina2");
+	if (Hwmon == NULL) {
+		return -1;
+	}
+
+	/* Bus voltage in mV, current in mA, and power in uW */
+	if (Hwmon_Read(Hwmon, 3, Attributes, NULL, Values) != 0) {
+		return -1;
+	}
+
+	/* if Current is negative, use its absolute value */
+	*Voltage = (float)Values[0] / 1000;
+	*Current = ((float)labs(Values[1]) / 1000) * INA226->Phase_Multiplier;
+	*Power = ((float)Values[2] / 1000000) * INA226->Phase_Multiplier;
+	return 0;
+}
+
+/*
+ * Get the output voltage of a regulator bound to a PMBus driver.
+ */
+int
+Hwmon_Get_Voltage(Voltage_t *Regulator, float *Voltage)
+{
+	Hwmon_t *Hwmon;
+	char Label[STRLEN_MAX];
+	const char *Labels[] = { Label };
+	long Voltage_mV;
+
+	Hwmon = Hwmon_Find(Regulator->I2C_Bus, Regulator->I2C_Address, NULL);
+	if (Hwmon == NULL) {
+		return -1;
+	}
+
+	(void) sprintf(Label, "vout%d", ((Regulator->Page_Select == -1) ? 1 :
+		       (Regulator->Page_Select + 1)));
+	if (Hwmon_Read(Hwmon, 1, NULL, Labels, &Voltage_mV) != 0) {
+		return -1;
+	}
+
+	*Voltage = (float)Voltage_mV / 1000;
+	return 0;
+}
+
+/*
+ * Get the telemetry of a regulator bound to a PMBus driver.  Values that the
+ * driver does not report are left as they are.
+ */
+int
+Hwmon_Get_Telemetry(Voltage_t *Regulator, float *Values)
+{
+	Hwmon_t *Hwmon;
+	char Labels[PMBUS_TELEMETRIES][STRLEN_MAX] = { "", "vin", "", "", "", "", "pin" };
+	const char *Label;
+	const char *Attribute;
+	int Page;
+	long Value;
+
+	Hwmon = Hwmon_Find(Regulator->I2C_Bus, Regulator->I2C_Address, NULL);
+	if (Hwmon == NULL) {
+		return -1;
+	}
+
+	Page = ((Regulator->Page_Select == -1) ? 1 : (Regulator->Page_Select + 1));
+	(void) sprintf(Labels[PMBUS_TELEMETRY_VOUT], "vout%d", Page);
+	(void) sprintf(Labels[PMBUS_TELEMETRY_IOUT], "iout%d", Page);
+	(void) sprintf(Labels[PMBUS_TELEMETRY_POUT], "pout%d", Page);
+	for (int i = PMBUS_TELEMETRY_VIN; i < PMBUS_TELEMETRIES; i++) {
+		Label = Labels[i];
+		Attribute = NULL;
+
+		/* Temperatures are not labelled, so only that of page 0 is known */
+		if (i == PMBUS_TELEMETRY_TEMPERATURE) {
+			if (Page != 1) {
+				continue;
+			}
+
+			Label = NULL;
+			Attribute = "temp1_input";
+		}
+
+		if (Hwmon_Read(Hwmon, 1, &Attribute, &Label, &Value) != 0) {
+			continue;
+		}
+
+		/* Voltage in mV, current in mA, temperature in mC, and power in uW */
+		Values[i] = (float)Value / (((i == PMBUS_TELEMETRY_POUT) ||
+					     (i == PMBUS_TELEMETRY_PIN)) ? 1000000 : 1000);
+	}
+
+	return 0;
+}
+
+/*
+ * Get the temperature of a DIMM thermal sensor bound to the jc42 driver.
+ */
+int
+Hwmon_Get_Temperature(DIMM_t *DIMM, float *Temperature)
+{
+	Hwmon_t *Hwmon;
+	const char *Attributes[] = { "temp1_input" };
+	long Temperature_mC;
+
+	Hwmon = Hwmon_Find(DIMM->I2C_Bus, DIMM->I2C_Address_Thermal, "jc42");
+	if (Hwmon == NULL) {
+		return -1;
+	}
+
+	if (Hwmon_Read(Hwmon, 1, Attributes, NULL, &Temperature_mC) != 0) {
+		return -1;
+	}
+
+	*Temperature = (float)Temperature_mC / 1000;
+	return 0;
+}
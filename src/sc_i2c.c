@@ -0,0 +1,1513 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+
+/*
+ * I2C Access Layer
+ *
+ * All I2C transactions issued by sc_appd go through the routines in this
+ * file.  When 'I2C_Trace: <file>' is defined in CONFIGFILE, every transaction
+ * is recorded to <file> in a compact binary form.  When 'I2C_Replay: <file>'
+ * is defined instead, no hardware is accessed and the transactions are
+ * served from a previously recorded trace.  If 'I2C_Replay_Timing: real' is
+ * also defined, the recorded latency of each transaction is reproduced.
+ *
+ * Trace file layout:
+ *
+ *	I2C_Trace_Header_t
+ *	I2C_Trace_Record_t, followed by 'Out_Length' bytes sent to the device
+ *	and 'In_Length' bytes received from the device
+ *	...
+ */
+#define I2C_TRACE_MAGIC		"SCI2CTRC"
+#define I2C_TRACE_VERSION	1
+#define I2C_FDS_MAX		256
+
+typedef enum {
+	I2C_TRACE_XFER,		/* I2C_RDWR: write followed by read */
+	I2C_TRACE_ADDRESS,	/* I2C_SLAVE_FORCE */
+	I2C_TRACE_WRITE,	/* raw write(2) */
+	I2C_TRACE_READ,		/* raw read(2) */
+} I2C_Trace_Direction;
+
+typedef struct {
+	char		Magic[8];
+	uint32_t	Version;
+	uint32_t	Record_Size;
+} __attribute__((packed)) I2C_Trace_Header_t;
+
+typedef struct {
+	uint64_t	Timestamp;	/* CLOCK_MONOTONIC in ns */
+	uint32_t	Latency;	/* ns */
+	uint8_t		Bus;		/* N of /dev/i2c-N, 0xFF if unknown */
+	uint8_t		Address;
+	uint8_t		Direction;
+	uint8_t		Errno;
+	uint16_t	Out_Length;
+	uint16_t	In_Length;
+} __attribute__((packed)) I2C_Trace_Record_t;
+
+typedef enum {
+	I2C_MODE_HW,
+	I2C_MODE_TRACE,
+	I2C_MODE_REPLAY,
+} I2C_Mode;
+
+static I2C_Mode Mode = I2C_MODE_HW;
+static int Trace_FD = -1;
+static int Replay_Timing;
+static char *Replay_Data;
+static I2C_Trace_Record_t **Replay_Records;
+static int Replay_Numbers;
+static int Replay_Cursor;
+static pthread_mutex_t Replay_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Bus number and selected device address for each open I2C file descriptor */
+static struct {
+	int	Bus;
+	int	Address;
+} I2C_FDs[I2C_FDS_MAX];
+
+/*
+ * Return the number of an I2C bus from its device path, e.g. 1 for
+ * '/dev/i2c-1', or 0xFF if it has none.
+ */
+int
+I2C_Bus_Number(const char *I2C_Bus)
+{
+	const char *Char_p;
+
+	Char_p = strrchr(I2C_Bus, '-');
+	if (Char_p == NULL || *(Char_p + 1) == '\0') {
+		return 0xFF;
+	}
+
+	return (atoi(Char_p + 1) & 0xFF);
+}
+
+static int
+I2C_FD_Bus(int FD)
+{
+	return ((FD >= 0 && FD < I2C_FDS_MAX) ? I2C_FDs[FD].Bus : 0xFF);
+}
+
+static int
+I2C_FD_Address(int FD)
+{
+	return ((FD >= 0 && FD < I2C_FDS_MAX) ? I2C_FDs[FD].Address : 0);
+}
+
+static void
+I2C_Trace_Record(int FD, int Address, int Direction, uint64_t Start,
+		 int Error, const void *Out, int Out_Length, const void *In,
+		 int In_Length)
+{
+	I2C_Trace_Record_t Record;
+	struct iovec IOV[3];
+
+	Record.Timestamp = Start;
+	Record.Latency = (uint32_t)(Monotonic_Nanoseconds() - Start);
+	Record.Bus = I2C_FD_Bus(FD);
+	Record.Address = Address;
+	Record.Direction = Direction;
+	Record.Errno = Error;
+	Record.Out_Length = Out_Length;
+	Record.In_Length = (Error == 0) ? In_Length : 0;
+
+	IOV[0].iov_base = &Record;
+	IOV[0].iov_len = sizeof(Record);
+	IOV[1].iov_base = (void *)Out;
+	IOV[1].iov_len = Record.Out_Length;
+	IOV[2].iov_base = (void *)In;
+	IOV[2].iov_len = Record.In_Length;
+	if (writev(Trace_FD, IOV, 3) == -1) {
+		SC_INFO("failed to record I2C trace: %m");
+	}
+}
+
+/*
+ * Look up the next recorded transaction that matches the request.  The
+ * search starts from where the previous match was found so that repeated
+ * accesses to the same register are replayed in their recorded order.
+ */
+static I2C_Trace_Record_t *
+I2C_Replay_Match(int FD, int Address, int Direction, const void *Out,
+		 int Out_Length, int In_Length)
+{
+	I2C_Trace_Record_t *Record;
+	int Bus, Index;
+
+	Bus = I2C_FD_Bus(FD);
+	(void) pthread_mutex_lock(&Replay_Lock);
+	for (int i = 0; i < Replay_Numbers; i++) {
+		Index = (Replay_Cursor + i) % Replay_Numbers;
+		Record = Replay_Records[Index];
+		if (Record->Bus != Bus || Record->Address != Address ||
+		    Record->Direction != Direction) {
+			continue;
+		}
+
+		if (Direction == I2C_TRACE_READ && Record->Errno == 0 &&
+		    Record->In_Length != In_Length) {
+			continue;
+		}
+
+		if (Record->Out_Length != Out_Length ||
+		    (Out_Length != 0 &&
+		     memcmp((char *)Record + sizeof(I2C_Trace_Record_t), Out,
+			    Out_Length) != 0)) {
+			continue;
+		}
+
+		Replay_Cursor = (Index + 1) % Replay_Numbers;
+		(void) pthread_mutex_unlock(&Replay_Lock);
+		if (Replay_Timing) {
+			struct timespec Delay = {
+				.tv_sec = Record->Latency / 1000000000,
+				.tv_nsec = Record->Latency % 1000000000,
+			};
+			(void) nanosleep(&Delay, NULL);
+		}
+
+		return Record;
+	}
+
+	(void) pthread_mutex_unlock(&Replay_Lock);
+	SC_INFO("no recorded I2C transaction for bus %d, address %#x",
+		Bus, Address);
+	return NULL;
+}
+
+static void
+I2C_Replay_Free(void)
+{
+	free(Replay_Records);
+	free(Replay_Data);
+	Replay_Records = NULL;
+	Replay_Data = NULL;
+	Replay_Numbers = 0;
+}
+
+static int
+I2C_Replay_Load(const char *Filename)
+{
+	int FD;
+	off_t Size, Offset;
+	I2C_Trace_Header_t *Header;
+	I2C_Trace_Record_t *Record;
+	I2C_Trace_Record_t **Records;
+
+	FD = open(Filename, O_RDONLY);
+	if (FD < 0) {
+		SC_ERR("failed to open I2C trace %s: %m", Filename);
+		return -1;
+	}
+
+	Size = lseek(FD, 0, SEEK_END);
+	if (Size < (off_t)sizeof(I2C_Trace_Header_t)) {
+		SC_ERR("invalid I2C trace %s", Filename);
+		(void) close(FD);
+		return -1;
+	}
+
+	Replay_Data = (char *)malloc(Size);
+	if (Replay_Data == NULL ||
+	    pread(FD, Replay_Data, Size, 0) != Size) {
+		SC_ERR("failed to read I2C trace %s: %m", Filename);
+		(void) close(FD);
+		I2C_Replay_Free();
+		return -1;
+	}
+
+	(void) close(FD);
+	Header = (I2C_Trace_Header_t *)Replay_Data;
+	if (memcmp(Header->Magic, I2C_TRACE_MAGIC, sizeof(Header->Magic)) != 0 ||
+	    Header->Version != I2C_TRACE_VERSION ||
+	    Header->Record_Size != sizeof(I2C_Trace_Record_t)) {
+		SC_ERR("unsupported I2C trace %s", Filename);
+		I2C_Replay_Free();
+		return -1;
+	}
+
+	Offset = sizeof(I2C_Trace_Header_t);
+	while ((Offset + (off_t)sizeof(I2C_Trace_Record_t)) <= Size) {
+		Record = (I2C_Trace_Record_t *)(Replay_Data + Offset);
+		Offset += sizeof(I2C_Trace_Record_t) + Record->Out_Length +
+			  Record->In_Length;
+		if (Offset > Size) {
+			break;
+		}
+
+		if ((Replay_Numbers % LITEMS_MAX) == 0) {
+			Records = realloc(Replay_Records,
+			    (Replay_Numbers + LITEMS_MAX) * sizeof(Record));
+			if (Records == NULL) {
+				SC_ERR("failed to allocate I2C trace index: %m");
+				I2C_Replay_Free();
+				return -1;
+			}
+
+			Replay_Records = Records;
+		}
+
+		Replay_Records[Replay_Numbers++] = Record;
+	}
+
+	SC_INFO("Replaying %d I2C transactions from %s", Replay_Numbers,
+		Filename);
+	return 0;
+}
+
+/*
+ * I2C Bus Accounting
+ *
+ * The time spent in transactions is accounted per bus and per class of
+ * traffic over a sliding window of I2C_WINDOW_NS.  Transactions issued
+ * directly by command handlers, or by sequences submitted with
+ * I2C_PRIORITY_INTERACTIVE, are interactive; sequences submitted with
+ * I2C_PRIORITY_BACKGROUND are background.  The share of bus time that
+ * background traffic may use is set by 'I2C_Background_Budget: <percent>'
+ * in CONFIGFILE.
+ *
+ * The health of each bus is tracked as well.  Timeouts, lost arbitration
+ * and transactions much slower than usual are bus faults; a NAK from an
+ * absent device is not.  After 'I2C_Fault_Threshold' (default 3)
+ * consecutive faults the bus is marked as failed: its transactions fail
+ * immediately with ENOLINK instead of waiting for another timeout, and the
+ * recovery action declared for it in the board's "I2C Buses" is run by the
+ * worker of the bus, so that the thread that hit the fault is not held up.
+ * The worker then probes the bus by reading from the last device that
+ * responded on it, and re-probes it with an exponential backoff until it
+ * returns to service.  While the bus is probed, only the probe goes through.
+ */
+#define I2C_WINDOW_NS		1000000000ULL
+#define I2C_SLOW_NS		20000000ULL
+#define I2C_BACKOFF_MIN_NS	1000000000ULL
+#define I2C_BACKOFF_MAX_NS	(32 * I2C_BACKOFF_MIN_NS)
+
+typedef struct {
+	char		*I2C_Bus;
+	uint64_t	Transactions;
+	uint64_t	Errors;
+	uint64_t	Busy_Time;
+	uint64_t	Window_Start;
+	uint64_t	Window_Busy[I2C_PRIORITIES];
+	uint64_t	Last_Busy[I2C_PRIORITIES];
+	I2C_Bus_State	State;
+	int		Faults;
+	uint64_t	Latency_Average;
+	uint64_t	Retry_Time;
+	uint64_t	Backoff;
+	unsigned long	Recoveries;
+	int		Last_Address;
+	int		Generation;
+} I2C_Bus_Account_t;
+
+static I2C_Bus_Account_t Bus_Accounts[I2C_FDS_MAX];
+static pthread_mutex_t Account_Lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread int Current_Priority = I2C_PRIORITY_INTERACTIVE;
+static __thread bool Probing;
+static int Background_Budget = 50;
+static int Fault_Threshold = 3;
+
+/* Must be called with Account_Lock held */
+static void
+I2C_Window_Update(I2C_Bus_Account_t *Account, uint64_t Now)
+{
+	if ((Now - Account->Window_Start) < I2C_WINDOW_NS) {
+		return;
+	}
+
+	for (int i = 0; i < I2C_PRIORITIES; i++) {
+		Account->Last_Busy[i] = ((Now - Account->Window_Start) <
+					 (2 * I2C_WINDOW_NS)) ?
+					Account->Window_Busy[i] : 0;
+		Account->Window_Busy[i] = 0;
+	}
+
+	Account->Window_Start = Now;
+}
+
+/* Must be called with Account_Lock held */
+static float
+I2C_Window_Share(I2C_Bus_Account_t *Account, int Priority, uint64_t Now)
+{
+	uint64_t Busy = 0;
+
+	I2C_Window_Update(Account, Now);
+	for (int i = 0; i < I2C_PRIORITIES; i++) {
+		if (Priority == -1 || Priority == i) {
+			Busy += Account->Last_Busy[i] + Account->Window_Busy[i];
+		}
+	}
+
+	return (Busy * 100.0) / (I2C_WINDOW_NS + (Now - Account->Window_Start));
+}
+
+static bool
+I2C_Bus_Fault(int Error)
+{
+	return (Error == ETIMEDOUT || Error == EAGAIN || Error == EBUSY);
+}
+
+/*
+ * Account a completed transaction.  Returns true if the bus has just
+ * failed and needs to be recovered.
+ */
+static bool
+I2C_Account(int Bus, int Address, uint64_t Start, int Error, bool Health)
+{
+	I2C_Bus_Account_t *Account = &Bus_Accounts[Bus & 0xFF];
+	uint64_t Now = Monotonic_Nanoseconds();
+	uint64_t Latency = Now - Start;
+	bool Fault, Recover = false;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	I2C_Window_Update(Account, Now);
+	Account->Transactions++;
+	Account->Errors += (Error != 0);
+	Account->Busy_Time += Latency;
+	Account->Window_Busy[Current_Priority] += Latency;
+	if (!Health) {
+		goto Out;
+	}
+
+	Fault = I2C_Bus_Fault(Error) ||
+		((Account->Latency_Average != 0) && (Latency > I2C_SLOW_NS) &&
+		 (Latency > (8 * Account->Latency_Average)));
+	if (!Fault) {
+		if (Error == 0) {
+			Account->Last_Address = Address;
+			Account->Latency_Average = (Account->Latency_Average == 0) ?
+				Latency : ((7 * Account->Latency_Average + Latency) / 8);
+		}
+
+		Account->Faults = 0;
+		Account->Backoff = 0;
+		Account->State = I2C_BUS_HEALTHY;
+		goto Out;
+	}
+
+	Account->Faults++;
+	if (Account->State == I2C_BUS_PROBING) {
+		/* The bus is still sick, back off further */
+		Account->Backoff = MIN(2 * Account->Backoff, I2C_BACKOFF_MAX_NS);
+		Account->Retry_Time = Now + Account->Backoff;
+		Account->State = I2C_BUS_FAILED;
+	} else if (Account->State != I2C_BUS_FAILED) {
+		if (Account->Faults >= Fault_Threshold) {
+			Account->Backoff = I2C_BACKOFF_MIN_NS;
+			Account->Retry_Time = Now + Account->Backoff;
+			Account->State = I2C_BUS_FAILED;
+			Recover = true;
+		} else {
+			Account->State = I2C_BUS_DEGRADED;
+		}
+	}
+
+Out:
+	(void) pthread_mutex_unlock(&Account_Lock);
+	return Recover;
+}
+
+static void I2C_Bus_Schedule(int Bus, bool Recover);
+
+/*
+ * Check whether a transaction may be issued on the bus.  A failed bus
+ * rejects transactions; once its backoff expires, a probe of the bus is
+ * scheduled on its worker.  Only the probe is let through until the bus
+ * is back in service.
+ */
+static int
+I2C_Bus_Gate(int Bus)
+{
+	I2C_Bus_Account_t *Account = &Bus_Accounts[Bus & 0xFF];
+	bool Probe = false;
+	int Ret = 0;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	if (Account->State == I2C_BUS_FAILED) {
+		if (Monotonic_Nanoseconds() >= Account->Retry_Time) {
+			Account->State = I2C_BUS_PROBING;
+			Probe = true;
+		}
+
+		Ret = -1;
+	} else if (Account->State == I2C_BUS_PROBING && !Probing) {
+		Ret = -1;
+	}
+
+	(void) pthread_mutex_unlock(&Account_Lock);
+	if (Probe) {
+		I2C_Bus_Schedule(Bus, false);
+	}
+
+	if (Ret != 0) {
+		errno = ENOLINK;
+	}
+
+	return Ret;
+}
+
+/*
+ * Unbind and bind again the driver of the I2C adapter.
+ */
+static int
+I2C_Rebind_Adapter(const char *Device)
+{
+	char Path[PATH_MAX + STRLEN_MAX];
+	char Driver[PATH_MAX];
+	int FD, Ret = 0;
+
+	(void) snprintf(Path, sizeof(Path), "/sys/bus/platform/devices/%s/driver",
+			Device);
+	if (realpath(Path, Driver) == NULL) {
+		SC_INFO("failed to find driver of %s: %m", Device);
+		return -1;
+	}
+
+	for (int i = 0; i < 2 && Ret == 0; i++) {
+		(void) snprintf(Path, sizeof(Path), "%s/%s", Driver,
+				((i == 0) ? "unbind" : "bind"));
+		FD = open(Path, O_WRONLY);
+		if (FD < 0 ||
+		    write(FD, Device, strlen(Device)) != (ssize_t)strlen(Device)) {
+			SC_INFO("failed to write %s: %m", Path);
+			Ret = -1;
+		}
+
+		if (FD >= 0) {
+			(void) close(FD);
+		}
+	}
+
+	return Ret;
+}
+
+/*
+ * Run the recovery action declared for a failed bus.  Returns 0 if the bus
+ * is to be probed right away.
+ */
+static int
+I2C_Bus_Recover(int Bus)
+{
+	I2C_Bus_Account_t *Account = &Bus_Accounts[Bus & 0xFF];
+	I2C_Buses_t *I2C_Buses;
+	I2C_Bus_t *I2C_Bus = NULL;
+
+	SC_INFO("I2C bus %d failed after %d consecutive faults", Bus,
+		Account->Faults);
+	I2C_Buses = ((Plat_Devs != NULL) ? Plat_Devs->I2C_Buses : NULL);
+	if (I2C_Buses == NULL || Account->I2C_Bus == NULL) {
+		return -1;
+	}
+
+	for (int i = 0; i < I2C_Buses->Numbers; i++) {
+		if (strcmp(I2C_Buses->Bus[i].I2C_Bus, Account->I2C_Bus) == 0) {
+			I2C_Bus = &I2C_Buses->Bus[i];
+			break;
+		}
+	}
+
+	if (I2C_Bus == NULL) {
+		return -1;
+	}
+
+	SC_INFO("Recovering I2C bus %s: %s %s", I2C_Bus->I2C_Bus,
+		I2C_Bus->Recovery, I2C_Bus->Recovery_Target);
+	if (strcmp(I2C_Bus->Recovery, "GPIO") == 0) {
+		/* Pulse the active-low reset of the bus mux */
+		if (Set_GPIO(I2C_Bus->Recovery_Target, 0) != 0) {
+			return -1;
+		}
+
+		(void) usleep(1000);
+		if (Set_GPIO(I2C_Bus->Recovery_Target, 1) != 0) {
+			return -1;
+		}
+	} else if (strcmp(I2C_Bus->Recovery, "Rebind") == 0) {
+		if (I2C_Rebind_Adapter(I2C_Bus->Recovery_Target) != 0) {
+			return -1;
+		}
+	} else {
+		SC_INFO("unsupported I2C bus recovery %s", I2C_Bus->Recovery);
+		return -1;
+	}
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	Account->Recoveries++;
+	Account->Generation++;
+	Account->State = I2C_BUS_PROBING;
+	(void) pthread_mutex_unlock(&Account_Lock);
+	return 0;
+}
+
+/*
+ * Return the number of times the bus has been recovered.  A bus file
+ * descriptor held across a recovery needs to be reopened.
+ */
+int
+I2C_Bus_Generation(const char *I2C_Bus)
+{
+	int Generation;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	Generation = Bus_Accounts[I2C_Bus_Number(I2C_Bus)].Generation;
+	(void) pthread_mutex_unlock(&Account_Lock);
+	return Generation;
+}
+
+static bool
+I2C_Over_Budget(int Bus)
+{
+	bool Over;
+
+	if (Background_Budget == 100) {
+		return false;
+	}
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	Over = (I2C_Window_Share(&Bus_Accounts[Bus & 0xFF],
+				 I2C_PRIORITY_BACKGROUND, Monotonic_Nanoseconds()) >=
+		Background_Budget);
+	(void) pthread_mutex_unlock(&Account_Lock);
+	return Over;
+}
+
+/*
+ * Return the interval that a background poller of 'I2C_Bus' should use
+ * instead of its nominal 'Interval', so that it backs off automatically
+ * when the bus is busy.
+ */
+int
+I2C_Background_Interval(const char *I2C_Bus, int Interval)
+{
+	float Share;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	Share = I2C_Window_Share(&Bus_Accounts[I2C_Bus_Number(I2C_Bus)], -1,
+				 Monotonic_Nanoseconds());
+	(void) pthread_mutex_unlock(&Account_Lock);
+	if (Share <= Background_Budget) {
+		return Interval;
+	}
+
+	return (int)(Interval * (Share / Background_Budget));
+}
+
+/*
+ * Return the statistics of up to 'Max' buses that have seen any traffic.
+ */
+int
+I2C_Get_Stats(I2C_Stats_t *Stats, int Max)
+{
+	I2C_Bus_Account_t *Account;
+	uint64_t Now = Monotonic_Nanoseconds();
+	int Numbers = 0;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	for (int i = 0; i < I2C_FDS_MAX && Numbers < Max; i++) {
+		Account = &Bus_Accounts[i];
+		if (Account->Transactions == 0) {
+			continue;
+		}
+
+		Stats[Numbers].Bus = i;
+		Stats[Numbers].Transactions = Account->Transactions;
+		Stats[Numbers].Errors = Account->Errors;
+		Stats[Numbers].Busy_Time = Account->Busy_Time / 1000;
+		Stats[Numbers].Utilization = I2C_Window_Share(Account, -1, Now);
+		Stats[Numbers].Background = I2C_Window_Share(Account,
+					    I2C_PRIORITY_BACKGROUND, Now);
+		Stats[Numbers].State = Account->State;
+		Stats[Numbers].Recoveries = Account->Recoveries;
+		Numbers++;
+	}
+
+	(void) pthread_mutex_unlock(&Account_Lock);
+	return Numbers;
+}
+
+/*
+ * Presence Cache
+ *
+ * Probing an optional device that is absent costs a NAK or a timeout on
+ * every attempt.  Once a probe finds a device absent, that is remembered
+ * for 'I2C_Absent_TTL' seconds (default 30), or until a presence change
+ * is noticed on its bus.  Devices behind a module select share their bus
+ * and address, so the device name is part of the key.
+ */
+#define I2C_ABSENT_MAX		64
+
+static struct {
+	int		Bus;
+	int		Address;
+	const char	*Name;
+	uint64_t	Expiry;		/* 0 if the entry is free */
+} I2C_Absents[I2C_ABSENT_MAX];
+
+static int Absent_TTL = 30;
+static pthread_mutex_t Presence_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int
+I2C_Absent_Find(int Bus, int Address, const char *Name)
+{
+	for (int i = 0; i < I2C_ABSENT_MAX; i++) {
+		if (I2C_Absents[i].Expiry != 0 && I2C_Absents[i].Bus == Bus &&
+		    I2C_Absents[i].Address == Address &&
+		    strcmp(I2C_Absents[i].Name, Name) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * Return true if device 'Name' was recently found absent.
+ */
+bool
+I2C_Absent(const char *I2C_Bus, int Address, const char *Name)
+{
+	uint64_t Now = Monotonic_Nanoseconds();
+	bool Absent = false;
+	int Index;
+
+	(void) pthread_mutex_lock(&Presence_Lock);
+	Index = I2C_Absent_Find(I2C_Bus_Number(I2C_Bus), Address, Name);
+	if (Index != -1) {
+		if (I2C_Absents[Index].Expiry > Now) {
+			Absent = true;
+		} else {
+			I2C_Absents[Index].Expiry = 0;
+		}
+	}
+
+	(void) pthread_mutex_unlock(&Presence_Lock);
+	if (Absent) {
+		SC_INFO("%s is cached as absent", Name);
+	}
+
+	return Absent;
+}
+
+/*
+ * Record the result of probing device 'Name'.
+ */
+void
+I2C_Set_Presence(const char *I2C_Bus, int Address, const char *Name, bool Present)
+{
+	int Bus = I2C_Bus_Number(I2C_Bus);
+	int Index;
+
+	(void) pthread_mutex_lock(&Presence_Lock);
+	Index = I2C_Absent_Find(Bus, Address, Name);
+	if (Present) {
+		if (Index != -1) {
+			I2C_Absents[Index].Expiry = 0;
+		}
+
+		(void) pthread_mutex_unlock(&Presence_Lock);
+		return;
+	}
+
+	for (int i = 0; i < I2C_ABSENT_MAX && Index == -1; i++) {
+		if (I2C_Absents[i].Expiry == 0) {
+			Index = i;
+		}
+	}
+
+	if (Index != -1) {
+		I2C_Absents[Index].Bus = Bus;
+		I2C_Absents[Index].Address = Address;
+		I2C_Absents[Index].Name = Name;
+		I2C_Absents[Index].Expiry = Monotonic_Nanoseconds() +
+					    (Absent_TTL * 1000000000ULL);
+	}
+
+	(void) pthread_mutex_unlock(&Presence_Lock);
+}
+
+/*
+ * Forget the absent devices of 'I2C_Bus', or of all buses if it is NULL.
+ */
+void
+I2C_Presence_Invalidate(const char *I2C_Bus)
+{
+	int Bus = ((I2C_Bus != NULL) ? I2C_Bus_Number(I2C_Bus) : -1);
+
+	(void) pthread_mutex_lock(&Presence_Lock);
+	for (int i = 0; i < I2C_ABSENT_MAX; i++) {
+		if (Bus == -1 || I2C_Absents[i].Bus == Bus) {
+			I2C_Absents[i].Expiry = 0;
+		}
+	}
+
+	(void) pthread_mutex_unlock(&Presence_Lock);
+}
+
+/*
+ * Set up the I2C access layer as requested in CONFIGFILE.
+ */
+int
+I2C_Init(void)
+{
+	I2C_Trace_Header_t Header;
+	char Value[LSTRLEN_MAX];
+	int Found = 0;
+
+	for (int i = 0; i < I2C_FDS_MAX; i++) {
+		I2C_FDs[i].Bus = 0xFF;
+	}
+
+	if (Check_Config_File("I2C_Background_Budget", Value, &Found) != 0) {
+		return -1;
+	}
+
+	if (Found) {
+		Background_Budget = MIN(MAX(atoi(Value), 1), 100);
+	}
+
+	if (Check_Config_File("I2C_Fault_Threshold", Value, &Found) != 0) {
+		return -1;
+	}
+
+	if (Found) {
+		Fault_Threshold = MAX(atoi(Value), 1);
+	}
+
+	if (Check_Config_File("I2C_Absent_TTL", Value, &Found) != 0) {
+		return -1;
+	}
+
+	if (Found) {
+		Absent_TTL = MAX(atoi(Value), 0);
+	}
+
+	if (Check_Config_File("I2C_Replay", Value, &Found) != 0) {
+		return -1;
+	}
+
+	if (Found) {
+		if (I2C_Replay_Load(Value) != 0) {
+			return -1;
+		}
+
+		if (Check_Config_File("I2C_Replay_Timing", Value, &Found) != 0) {
+			return -1;
+		}
+
+		Replay_Timing = (Found && (strcmp(Value, "real") == 0));
+		Mode = I2C_MODE_REPLAY;
+		return 0;
+	}
+
+	if (Check_Config_File("I2C_Trace", Value, &Found) != 0) {
+		return -1;
+	}
+
+	if (!Found) {
+		return 0;
+	}
+
+	Trace_FD = open(Value, (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC), 0644);
+	if (Trace_FD < 0) {
+		SC_ERR("failed to create I2C trace %s: %m", Value);
+		return -1;
+	}
+
+	(void) memcpy(Header.Magic, I2C_TRACE_MAGIC, sizeof(Header.Magic));
+	Header.Version = I2C_TRACE_VERSION;
+	Header.Record_Size = sizeof(I2C_Trace_Record_t);
+	if (write(Trace_FD, &Header, sizeof(Header)) != sizeof(Header)) {
+		SC_ERR("failed to write I2C trace %s: %m", Value);
+		(void) close(Trace_FD);
+		Trace_FD = -1;
+		return -1;
+	}
+
+	SC_INFO("Recording I2C transactions to %s", Value);
+	Mode = I2C_MODE_TRACE;
+	return 0;
+}
+
+/*
+ * Open an I2C bus.  The returned file descriptor is released with close(2).
+ */
+int
+I2C_Open(const char *I2C_Bus)
+{
+	int FD;
+
+	if (Mode == I2C_MODE_REPLAY) {
+		FD = open("/dev/null", O_RDWR);
+	} else {
+		FD = open(I2C_Bus, O_RDWR);
+	}
+
+	if (FD >= 0 && FD < I2C_FDS_MAX) {
+		I2C_FDs[FD].Bus = I2C_Bus_Number(I2C_Bus);
+		I2C_FDs[FD].Address = 0;
+		(void) pthread_mutex_lock(&Account_Lock);
+		if (Bus_Accounts[I2C_FDs[FD].Bus].I2C_Bus == NULL) {
+			Bus_Accounts[I2C_FDs[FD].Bus].I2C_Bus = strdup(I2C_Bus);
+		}
+
+		(void) pthread_mutex_unlock(&Account_Lock);
+	}
+
+	return FD;
+}
+
+/*
+ * Account a completed transaction to its bus and record it to the trace.
+ */
+static void
+I2C_Complete(int FD, int Address, int Direction, uint64_t Start, int Ret,
+	     const void *Out, int Out_Length, const void *In, int In_Length)
+{
+	int Error = ((Ret < 0) ? errno : 0);
+
+	if (I2C_Account(I2C_FD_Bus(FD), Address, Start, Error,
+			(Direction != I2C_TRACE_ADDRESS))) {
+		I2C_Bus_Schedule(I2C_FD_Bus(FD), true);
+	}
+
+	if (Mode == I2C_MODE_TRACE) {
+		I2C_Trace_Record(FD, Address, Direction, Start, Error, Out,
+				 Out_Length, In, In_Length);
+	}
+
+	errno = Error;
+}
+
+static int
+I2C_Replay_Error(I2C_Trace_Record_t *Record)
+{
+	if (Record == NULL) {
+		errno = EIO;
+		return -1;
+	}
+
+	if (Record->Errno != 0) {
+		errno = Record->Errno;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Issue a combined write/read transaction with I2C_RDWR.
+ */
+int
+I2C_Transfer(int FD, struct i2c_rdwr_ioctl_data *Msgset)
+{
+	struct i2c_msg *Out_Msg, *In_Msg;
+	I2C_Trace_Record_t *Record;
+	uint64_t Start;
+	int Ret;
+
+	if (I2C_Bus_Gate(I2C_FD_Bus(FD)) != 0) {
+		return -1;
+	}
+
+	Out_Msg = &Msgset->msgs[0];
+	In_Msg = &Msgset->msgs[Msgset->nmsgs - 1];
+	Start = Monotonic_Nanoseconds();
+	if (Mode == I2C_MODE_REPLAY) {
+		Record = I2C_Replay_Match(FD, Out_Msg->addr, I2C_TRACE_XFER,
+					  Out_Msg->buf, Out_Msg->len, In_Msg->len);
+		Ret = I2C_Replay_Error(Record);
+		if (Ret == 0) {
+			(void) memcpy(In_Msg->buf, (char *)Record + sizeof(*Record) +
+				      Record->Out_Length,
+				      MIN(Record->In_Length, In_Msg->len));
+		}
+	} else {
+		Ret = ioctl(FD, I2C_RDWR, Msgset);
+	}
+
+	I2C_Complete(FD, Out_Msg->addr, I2C_TRACE_XFER, Start, Ret, Out_Msg->buf,
+		     Out_Msg->len, In_Msg->buf, In_Msg->len);
+	return Ret;
+}
+
+/*
+ * Select the device address used by subsequent raw reads and writes.
+ */
+int
+I2C_Set_Address(int FD, int Address)
+{
+	uint64_t Start;
+	int Ret;
+
+	if (FD >= 0 && FD < I2C_FDS_MAX) {
+		I2C_FDs[FD].Address = Address;
+	}
+
+	Start = Monotonic_Nanoseconds();
+	if (Mode == I2C_MODE_REPLAY) {
+		Ret = I2C_Replay_Error(I2C_Replay_Match(FD, Address,
+				       I2C_TRACE_ADDRESS, NULL, 0, 0));
+	} else {
+		Ret = ioctl(FD, I2C_SLAVE_FORCE, Address);
+	}
+
+	I2C_Complete(FD, Address, I2C_TRACE_ADDRESS, Start, Ret, NULL, 0, NULL, 0);
+	return Ret;
+}
+
+ssize_t
+I2C_Raw_Write(int FD, const void *Buffer, size_t Length)
+{
+	uint64_t Start;
+	ssize_t Ret;
+
+	if (I2C_Bus_Gate(I2C_FD_Bus(FD)) != 0) {
+		return -1;
+	}
+
+	Start = Monotonic_Nanoseconds();
+	if (Mode == I2C_MODE_REPLAY) {
+		Ret = I2C_Replay_Error(I2C_Replay_Match(FD, I2C_FD_Address(FD),
+				       I2C_TRACE_WRITE, Buffer, Length, 0));
+		Ret = ((Ret == 0) ? Length : Ret);
+	} else {
+		Ret = write(FD, Buffer, Length);
+	}
+
+	I2C_Complete(FD, I2C_FD_Address(FD), I2C_TRACE_WRITE, Start, Ret,
+		     Buffer, Length, NULL, 0);
+	return Ret;
+}
+
+ssize_t
+I2C_Raw_Read(int FD, void *Buffer, size_t Length)
+{
+	I2C_Trace_Record_t *Record;
+	uint64_t Start;
+	ssize_t Ret;
+
+	if (I2C_Bus_Gate(I2C_FD_Bus(FD)) != 0) {
+		return -1;
+	}
+
+	Start = Monotonic_Nanoseconds();
+	if (Mode == I2C_MODE_REPLAY) {
+		Record = I2C_Replay_Match(FD, I2C_FD_Address(FD), I2C_TRACE_READ,
+					  NULL, 0, Length);
+		Ret = I2C_Replay_Error(Record);
+		if (Ret == 0) {
+			(void) memcpy(Buffer, (char *)Record + sizeof(*Record),
+				      MIN(Record->In_Length, Length));
+			Ret = Record->In_Length;
+		}
+	} else {
+		Ret = read(FD, Buffer, Length);
+	}
+
+	I2C_Complete(FD, I2C_FD_Address(FD), I2C_TRACE_READ, Start, Ret, NULL, 0,
+		     Buffer, ((Ret < 0) ? 0 : Ret));
+	return Ret;
+}
+
+/*
+ * I2C Transaction Engine
+ *
+ * Each physical I2C bus is served by its own worker thread with a FIFO
+ * queue of transaction sequences.  A sequence is a list of operations on
+ * one bus that are executed back to back by the worker.  After every
+ * operation, the optional 'Op_Done' callback is invoked in the worker's
+ * context so that later operations can be filled in from the data just
+ * read, or skipped; it must not print to the client.  The 'Done' callback
+ * is invoked in the context of the thread that waits for the sequence.
+ * Since every bus has its own worker, sequences submitted to different
+ * buses are executed concurrently.
+ *
+ * Interactive sequences are always served first.  Background sequences are
+ * held back while background traffic exceeds its budget on the bus.
+ *
+ * A PMBus page that is selected by one thread must stay selected until the
+ * commands of that page are done.  A sequence holds its bus for as long as it
+ * runs, and a thread that accesses a paged device over its own file
+ * descriptor holds the bus with I2C_Bus_Lock() in the meantime.
+ */
+#define I2C_THROTTLE_NS	10000000
+
+typedef struct {
+	char		*I2C_Bus;
+	int		Bus;
+	int		FD;
+	int		Address;
+	int		Generation;
+	pthread_t	Thread;
+	pthread_mutex_t	Lock;
+	pthread_cond_t	Cond;
+	pthread_mutex_t	Bus_Lock;
+	I2C_Sequence_t	*Head[I2C_PRIORITIES];
+	I2C_Sequence_t	*Tail[I2C_PRIORITIES];
+	bool		Recover;
+	bool		Probe;
+} I2C_Bus_Queue_t;
+
+static I2C_Bus_Queue_t Bus_Queues[ITEMS_MAX];
+static int Bus_Queue_Numbers;
+static pthread_mutex_t Bus_Queues_Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t Done_Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t Done_Cond = PTHREAD_COND_INITIALIZER;
+
+static int
+I2C_Execute_Op(I2C_Bus_Queue_t *Queue, I2C_Op_t *Op)
+{
+	struct i2c_msg Msgs[2];
+	struct i2c_rdwr_ioctl_data Msgset[1];
+
+	if (Op->Type == I2C_OP_WRITE) {
+		if (Queue->Address != Op->Address) {
+			if (I2C_Set_Address(Queue->FD, Op->Address) < 0) {
+				Queue->Address = -1;
+				return -1;
+			}
+
+			Queue->Address = Op->Address;
+		}
+
+		return ((I2C_Raw_Write(Queue->FD, Op->Out, Op->Out_Length) ==
+			 Op->Out_Length) ? 0 : -1);
+	}
+
+	Msgs[0].addr = Op->Address;
+	Msgs[0].flags = 0;
+	Msgs[0].len = Op->Out_Length;
+	Msgs[0].buf = Op->Out;
+	Msgs[1].addr = Op->Address;
+	Msgs[1].flags = (I2C_M_RD | I2C_M_NOSTART);
+	Msgs[1].len = Op->In_Length;
+	Msgs[1].buf = Op->In;
+	Msgset[0].msgs = Msgs;
+	Msgset[0].nmsgs = 2;
+	return I2C_Transfer(Queue->FD, Msgset);
+}
+
+static void
+I2C_Execute_Sequence(I2C_Bus_Queue_t *Queue, I2C_Sequence_t *Sequence)
+{
+	Sequence->Status = 0;
+	for (int i = 0; i < Sequence->Numbers; i++) {
+		if (Sequence->Op[i].Skip) {
+			continue;
+		}
+
+		if (I2C_Execute_Op(Queue, &Sequence->Op[i]) != 0) {
+			Sequence->Status = -1;
+			Sequence->Errno = errno;
+			Sequence->Failed_Op = i;
+			break;
+		}
+
+		if (Sequence->Op_Done != NULL &&
+		    Sequence->Op_Done(Sequence, i) != 0) {
+			Sequence->Status = -1;
+			Sequence->Errno = EINVAL;
+			Sequence->Failed_Op = i;
+			break;
+		}
+	}
+}
+
+/*
+ * Pick the next sequence to execute.  Must be called with the queue lock
+ * held; returns NULL if nothing can be executed now.
+ */
+static I2C_Sequence_t *
+I2C_Dequeue(I2C_Bus_Queue_t *Queue)
+{
+	I2C_Sequence_t *Sequence;
+	int Priority = I2C_PRIORITY_INTERACTIVE;
+
+	if (Queue->Head[Priority] == NULL) {
+		Priority = I2C_PRIORITY_BACKGROUND;
+		if (Queue->Head[Priority] == NULL || I2C_Over_Budget(Queue->Bus)) {
+			return NULL;
+		}
+	}
+
+	Sequence = Queue->Head[Priority];
+	Queue->Head[Priority] = Sequence->Next;
+	if (Queue->Head[Priority] == NULL) {
+		Queue->Tail[Priority] = NULL;
+	}
+
+	return Sequence;
+}
+
+/*
+ * The bus is kept open for as long as the worker lives, unless the adapter
+ * has been rebound by a bus recovery.
+ */
+static int
+I2C_Worker_Open(I2C_Bus_Queue_t *Queue)
+{
+	if (Queue->FD >= 0 &&
+	    Queue->Generation != I2C_Bus_Generation(Queue->I2C_Bus)) {
+		(void) close(Queue->FD);
+		Queue->FD = -1;
+	}
+
+	if (Queue->FD < 0) {
+		Queue->FD = I2C_Open(Queue->I2C_Bus);
+		Queue->Address = -1;
+		Queue->Generation = I2C_Bus_Generation(Queue->I2C_Bus);
+	}
+
+	return ((Queue->FD < 0) ? -1 : 0);
+}
+
+/*
+ * Probe a failed bus by reading from the last device that responded on it.
+ * The bus returns to service if the read completes without a bus fault.
+ */
+static void
+I2C_Bus_Probe(I2C_Bus_Queue_t *Queue)
+{
+	I2C_Bus_Account_t *Account = &Bus_Accounts[Queue->Bus & 0xFF];
+	char Buffer[1];
+	int Address;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	Address = Account->Last_Address;
+	(void) pthread_mutex_unlock(&Account_Lock);
+	if (Mode != I2C_MODE_REPLAY && Address != 0 &&
+	    I2C_Worker_Open(Queue) == 0) {
+		Probing = true;
+		if (I2C_Set_Address(Queue->FD, Address) == 0) {
+			(void) I2C_Raw_Read(Queue->FD, Buffer, 1);
+		}
+
+		Probing = false;
+		Queue->Address = -1;
+	}
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	if (Mode == I2C_MODE_REPLAY || Address == 0) {
+		/* Nothing to probe with, let the traffic through */
+		Account->Faults = 0;
+		Account->Backoff = 0;
+		Account->State = I2C_BUS_HEALTHY;
+	} else if (Account->State == I2C_BUS_PROBING) {
+		Account->Backoff = MIN(2 * Account->Backoff, I2C_BACKOFF_MAX_NS);
+		Account->Retry_Time = Monotonic_Nanoseconds() + Account->Backoff;
+		Account->State = I2C_BUS_FAILED;
+	}
+
+	if (Account->State == I2C_BUS_HEALTHY) {
+		SC_INFO("I2C bus %s is back in service", Queue->I2C_Bus);
+	}
+
+	(void) pthread_mutex_unlock(&Account_Lock);
+}
+
+static void *
+I2C_Bus_Worker(void *Arg)
+{
+	I2C_Bus_Queue_t *Queue = (I2C_Bus_Queue_t *)Arg;
+	I2C_Sequence_t *Sequence;
+	struct timespec Timeout;
+	bool Recover, Probe;
+
+	while (1) {
+		(void) pthread_mutex_lock(&Queue->Lock);
+		while (!Queue->Recover && !Queue->Probe &&
+		       (Sequence = I2C_Dequeue(Queue)) == NULL) {
+			if (Queue->Head[I2C_PRIORITY_BACKGROUND] == NULL) {
+				(void) pthread_cond_wait(&Queue->Cond, &Queue->Lock);
+				continue;
+			}
+
+			/* Background work is throttled, check back shortly */
+			(void) clock_gettime(CLOCK_REALTIME, &Timeout);
+			Timeout.tv_nsec += I2C_THROTTLE_NS;
+			if (Timeout.tv_nsec >= 1000000000) {
+				Timeout.tv_sec++;
+				Timeout.tv_nsec -= 1000000000;
+			}
+
+			(void) pthread_cond_timedwait(&Queue->Cond, &Queue->Lock,
+						      &Timeout);
+		}
+
+		Recover = Queue->Recover;
+		Probe = Queue->Probe;
+		Queue->Recover = Queue->Probe = false;
+		(void) pthread_mutex_unlock(&Queue->Lock);
+		if (Recover || Probe) {
+			if (!Recover || I2C_Bus_Recover(Queue->Bus) == 0) {
+				I2C_Bus_Probe(Queue);
+			}
+
+			continue;
+		}
+
+		Current_Priority = Sequence->Priority;
+		if (I2C_Worker_Open(Queue) != 0) {
+			Sequence->Status = -1;
+			Sequence->Errno = errno;
+			Sequence->Failed_Op = -1;
+		} else {
+			(void) pthread_mutex_lock(&Queue->Bus_Lock);
+			I2C_Execute_Sequence(Queue, Sequence);
+			(void) pthread_mutex_unlock(&Queue->Bus_Lock);
+		}
+
+		(void) pthread_mutex_lock(&Done_Lock);
+		Sequence->Completed = true;
+		(void) pthread_cond_broadcast(&Done_Cond);
+		(void) pthread_mutex_unlock(&Done_Lock);
+	}
+
+	return NULL;
+}
+
+static I2C_Bus_Queue_t *
+I2C_Bus_Queue(const char *I2C_Bus)
+{
+	I2C_Bus_Queue_t *Queue = NULL;
+
+	(void) pthread_mutex_lock(&Bus_Queues_Lock);
+	for (int i = 0; i < Bus_Queue_Numbers; i++) {
+		if (strcmp(Bus_Queues[i].I2C_Bus, I2C_Bus) == 0) {
+			Queue = &Bus_Queues[i];
+			goto Out;
+		}
+	}
+
+	if (Bus_Queue_Numbers == ITEMS_MAX) {
+		SC_ERR("too many I2C buses");
+		goto Out;
+	}
+
+	Queue = &Bus_Queues[Bus_Queue_Numbers];
+	Queue->I2C_Bus = strdup(I2C_Bus);
+	Queue->Bus = I2C_Bus_Number(I2C_Bus);
+	Queue->FD = -1;
+	for (int i = 0; i < I2C_PRIORITIES; i++) {
+		Queue->Head[i] = Queue->Tail[i] = NULL;
+	}
+
+	Queue->Recover = Queue->Probe = false;
+
+	(void) pthread_mutex_init(&Queue->Lock, NULL);
+	(void) pthread_cond_init(&Queue->Cond, NULL);
+	(void) pthread_mutex_init(&Queue->Bus_Lock, NULL);
+	if (pthread_create(&Queue->Thread, NULL, I2C_Bus_Worker, Queue) != 0) {
+		SC_ERR("failed to create worker for I2C bus %s", I2C_Bus);
+		free(Queue->I2C_Bus);
+		Queue = NULL;
+		goto Out;
+	}
+
+	(void) pthread_detach(Queue->Thread);
+	Bus_Queue_Numbers++;
+Out:
+	(void) pthread_mutex_unlock(&Bus_Queues_Lock);
+	return Queue;
+}
+
+/*
+ * Have the worker of a bus recover it, or probe it.
+ */
+static void
+I2C_Bus_Schedule(int Bus, bool Recover)
+{
+	I2C_Bus_Queue_t *Queue;
+	char *I2C_Bus;
+
+	(void) pthread_mutex_lock(&Account_Lock);
+	I2C_Bus = Bus_Accounts[Bus & 0xFF].I2C_Bus;
+	(void) pthread_mutex_unlock(&Account_Lock);
+	if (I2C_Bus == NULL) {
+		return;
+	}
+
+	Queue = I2C_Bus_Queue(I2C_Bus);
+	if (Queue == NULL) {
+		return;
+	}
+
+	(void) pthread_mutex_lock(&Queue->Lock);
+	if (Recover) {
+		Queue->Recover = true;
+	} else {
+		Queue->Probe = true;
+	}
+
+	(void) pthread_cond_signal(&Queue->Cond);
+	(void) pthread_mutex_unlock(&Queue->Lock);
+}
+
+/*
+ * Append an operation to a sequence.  For a read, 'Out' holds the bytes
+ * written ahead of reading 'In_Length' bytes.  Returns the index of the
+ * operation.
+ */
+int
+I2C_Sequence_Add(I2C_Sequence_t *Sequence, I2C_Op_Type Type, int Address,
+		 int Out_Length, const void *Out, int In_Length)
+{
+	I2C_Op_t *Op;
+
+	if (Sequence->Numbers == ITEMS_MAX || Out_Length > I2C_OP_DATA_MAX ||
+	    In_Length > I2C_OP_DATA_MAX) {
+		SC_ERR("invalid I2C sequence operation");
+		return -1;
+	}
+
+	Op = &Sequence->Op[Sequence->Numbers];
+	(void) memset(Op, 0, sizeof(I2C_Op_t));
+	Op->Type = Type;
+	Op->Address = Address;
+	Op->Out_Length = Out_Length;
+	Op->In_Length = In_Length;
+	if (Out != NULL) {
+		(void) memcpy(Op->Out, Out, Out_Length);
+	}
+
+	return Sequence->Numbers++;
+}
+
+/*
+ * Tell whether the operation 'Index' of a completed sequence failed, or was
+ * not executed since an earlier operation failed.
+ */
+bool
+I2C_Op_Failed(const I2C_Sequence_t *Sequence, int Index)
+{
+	return (Sequence->Status != 0 &&
+		(Sequence->Failed_Op == -1 || Index >= Sequence->Failed_Op));
+}
+
+/*
+ * Queue a sequence on the worker of its I2C bus.
+ */
+int
+I2C_Submit(I2C_Sequence_t *Sequence)
+{
+	I2C_Bus_Queue_t *Queue;
+	int Priority;
+
+	Queue = I2C_Bus_Queue(Sequence->I2C_Bus);
+	if (Queue == NULL) {
+		return -1;
+	}
+
+	Sequence->Completed = false;
+	Sequence->Status = 0;
+	Sequence->Errno = 0;
+	Sequence->Failed_Op = -1;
+	Sequence->Next = NULL;
+	Priority = ((Sequence->Priority == I2C_PRIORITY_BACKGROUND) ?
+		    I2C_PRIORITY_BACKGROUND : I2C_PRIORITY_INTERACTIVE);
+	Sequence->Priority = Priority;
+	(void) pthread_mutex_lock(&Queue->Lock);
+	if (Queue->Tail[Priority] == NULL) {
+		Queue->Head[Priority] = Sequence;
+	} else {
+		Queue->Tail[Priority]->Next = Sequence;
+	}
+
+	Queue->Tail[Priority] = Sequence;
+	(void) pthread_cond_signal(&Queue->Cond);
+	(void) pthread_mutex_unlock(&Queue->Lock);
+	return 0;
+}
+
+/*
+ * Wait for a submitted sequence to complete and invoke its 'Done' callback.
+ */
+int
+I2C_Wait(I2C_Sequence_t *Sequence)
+{
+	(void) pthread_mutex_lock(&Done_Lock);
+	while (!Sequence->Completed) {
+		(void) pthread_cond_wait(&Done_Cond, &Done_Lock);
+	}
+
+	(void) pthread_mutex_unlock(&Done_Lock);
+	if (Sequence->Status != 0 && !Sequence->Quiet) {
+		errno = Sequence->Errno;
+		if (Sequence->Failed_Op == -1) {
+			SC_ERR("unable to access the I2C bus %s: %m",
+			       Sequence->I2C_Bus);
+		} else {
+			SC_ERR("unable to access I2C device %#x: %m",
+			       Sequence->Op[Sequence->Failed_Op].Address);
+		}
+	}
+
+	if (Sequence->Done != NULL) {
+		Sequence->Done(Sequence);
+	}
+
+	return Sequence->Status;
+}
+
+/*
+ * Execute a sequence and wait for its completion.
+ */
+int
+I2C_Run(I2C_Sequence_t *Sequence)
+{
+	if (I2C_Submit(Sequence) != 0) {
+		return -1;
+	}
+
+	return I2C_Wait(Sequence);
+}
+
+/*
+ * Hold 'I2C_Bus' against the other threads that access paged devices on it,
+ * and against the sequences of its worker.  The calling thread must not wait
+ * for a sequence on the bus until it releases it with I2C_Bus_Unlock().
+ */
+int
+I2C_Bus_Lock(const char *I2C_Bus)
+{
+	I2C_Bus_Queue_t *Queue;
+
+	Queue = I2C_Bus_Queue(I2C_Bus);
+	if (Queue == NULL) {
+		return -1;
+	}
+
+	(void) pthread_mutex_lock(&Queue->Bus_Lock);
+	return 0;
+}
+
+void
+I2C_Bus_Unlock(const char *I2C_Bus)
+{
+	I2C_Bus_Queue_t *Queue;
+
+	Queue = I2C_Bus_Queue(I2C_Bus);
+	if (Queue != NULL) {
+		(void) pthread_mutex_unlock(&Queue->Bus_Lock);
+	}
+}
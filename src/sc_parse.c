@@ -34,6 +34,10 @@ int Parse_Workaround(const char *, jsmntok_t *, int *, Workarounds_t **);
 int Parse_BIT(const char *, jsmntok_t *, int *, BITs_t **);
 int Parse_Constraint(const char *, jsmntok_t *, int *, Constraints_t **);
 int Parse_BootConfig(const char *, jsmntok_t *, int *, Default_PDI_t **);
+int Parse_I2C_Bus(const char *, jsmntok_t *, int *, I2C_Buses_t **);
+int Parse_Derived(const char *, jsmntok_t *, int *, Deriveds_t **);
+int Parse_Profile(const char *, jsmntok_t *, int *, Profiles_t **);
+int Parse_Power_Sequence(const char *, jsmntok_t *, int *, Power_Sequences_t **);
 
 const char * GPIO_Type_Str[] = { IO_TYPES };
 #define Check_Attribute(Attribute, Feature) { \
@@ -206,6 +210,26 @@ Parse_JSON(const char *Board_File, Plat_Devs_t *Dev_Parse) {
 					     &Dev_Parse->Default_PDI) != 0) {
 				return -1;
 			}
+		} else if (jsoneq(Json_File, &Tokens[i], "I2C Buses") == 0) {
+			if (Parse_I2C_Bus(Json_File, Tokens, &i,
+					  &Dev_Parse->I2C_Buses) != 0) {
+				return -1;
+			}
+		} else if (jsoneq(Json_File, &Tokens[i], "Derived Sensors") == 0) {
+			if (Parse_Derived(Json_File, Tokens, &i,
+					  &Dev_Parse->Deriveds) != 0) {
+				return -1;
+			}
+		} else if (jsoneq(Json_File, &Tokens[i], "PROFILE") == 0) {
+			if (Parse_Profile(Json_File, Tokens, &i,
+					  &Dev_Parse->Profiles) != 0) {
+				return -1;
+			}
+		} else if (jsoneq(Json_File, &Tokens[i], "Power Sequences") == 0) {
+			if (Parse_Power_Sequence(Json_File, Tokens, &i,
+						 &Dev_Parse->Power_Sequences) != 0) {
+				return -1;
+			}
 		}
 	}
 
@@ -583,6 +607,7 @@ int
 Parse_INA226(const char *Json_File, jsmntok_t *Tokens, int *Index, INA226s_t **INAs)
 {
 	char *Value_Str;
+	int *Value_Int;
 	int INA226_Items = 0;
 
 	SC_INFO("********************* INA226 *********************");
@@ -639,9 +664,52 @@ Parse_INA226(const char *Json_File, jsmntok_t *Tokens, int *Index, INA226s_t **I
 				    Tokens[*Index].end - Tokens[*Index].start);
 		(*INAs)->INA226[INA226_Items].Phase_Multiplier = atoi(Value_Str);
 		free(Value_Str);
-		SC_INFO("Phase_Multiplier: %i\n",
+		SC_INFO("Phase_Multiplier: %i",
 		        (*INAs)->INA226[INA226_Items].Phase_Multiplier);
 
+		/* Optional averaging, conversion time, and alert attributes */
+		(*INAs)->INA226[INA226_Items].Averages = 0;
+		(*INAs)->INA226[INA226_Items].Bus_Conversion_Time = 0;
+		(*INAs)->INA226[INA226_Items].Shunt_Conversion_Time = 0;
+		(*INAs)->INA226[INA226_Items].Alert_Line = NULL;
+		(*INAs)->INA226[INA226_Items].Alert_Mask = 0;
+		(*INAs)->INA226[INA226_Items].Alert_Limit = 0;
+		while (1) {
+			(*Index)++;
+			Value_Str = strndup(Json_File + Tokens[*Index].start,
+					    Tokens[*Index].end - Tokens[*Index].start);
+			if (strcmp(Value_Str, "Alert_Line") == 0) {
+				free(Value_Str);
+				(*Index)++;
+				Value_Str = strndup(Json_File + Tokens[*Index].start,
+						    Tokens[*Index].end - Tokens[*Index].start);
+				Validate_Str_Size(Value_Str, "INA226", "Alert_Line", STRLEN_MAX);
+				(*INAs)->INA226[INA226_Items].Alert_Line = Value_Str;
+				SC_INFO("Alert_Line: %s", Value_Str);
+				continue;
+			} else if (strcmp(Value_Str, "Alert_Mask") == 0) {
+				Value_Int = &(*INAs)->INA226[INA226_Items].Alert_Mask;
+			} else if (strcmp(Value_Str, "Alert_Limit") == 0) {
+				Value_Int = &(*INAs)->INA226[INA226_Items].Alert_Limit;
+			} else if (strcmp(Value_Str, "Averages") == 0) {
+				Value_Int = &(*INAs)->INA226[INA226_Items].Averages;
+			} else if (strcmp(Value_Str, "Bus_Conversion_Time") == 0) {
+				Value_Int = &(*INAs)->INA226[INA226_Items].Bus_Conversion_Time;
+			} else if (strcmp(Value_Str, "Shunt_Conversion_Time") == 0) {
+				Value_Int = &(*INAs)->INA226[INA226_Items].Shunt_Conversion_Time;
+			} else {
+				free(Value_Str);
+				(*Index)--;
+				break;
+			}
+
+			(*Index)++;
+			*Value_Int = (int)strtol(Json_File + Tokens[*Index].start, NULL, 0);
+			SC_INFO("%s: %i", Value_Str, *Value_Int);
+			free(Value_Str);
+		}
+
+		SC_INFO("");	// Add a blank line
 		INA226_Items++;
 	}
 
@@ -785,21 +853,44 @@ Parse_Voltage(const char *Json_File, jsmntok_t *Tokens, int *Index,
 		free(Value_Str);
 		SC_INFO("Page Select: %i\n", (*VCCs)->Voltage[Voltage_Items].Page_Select);
 
-		(*Index)++;
-		Value_Str = strndup(Json_File + Tokens[*Index].start,
-				    Tokens[*Index].end - Tokens[*Index].start);
-		if (strcmp(Value_Str, "Voltage_Multiplier") == 0) {
-			free(Value_Str);
+		/* Optional voltage multiplier, SMBALERT# line, and phases attributes */
+		while (1) {
 			(*Index)++;
 			Value_Str = strndup(Json_File + Tokens[*Index].start,
 					    Tokens[*Index].end - Tokens[*Index].start);
-			(*VCCs)->Voltage[Voltage_Items].Voltage_Multiplier = atoi(Value_Str);
-			free(Value_Str);
-			SC_INFO("Voltage Multiplier: %i\n",
-				(*VCCs)->Voltage[Voltage_Items].Voltage_Multiplier);
-		} else {
-			free(Value_Str);
-			(*Index)--;
+			if (strcmp(Value_Str, "Voltage_Multiplier") == 0) {
+				free(Value_Str);
+				(*Index)++;
+				Value_Str = strndup(Json_File + Tokens[*Index].start,
+						    Tokens[*Index].end - Tokens[*Index].start);
+				(*VCCs)->Voltage[Voltage_Items].Voltage_Multiplier = atoi(Value_Str);
+				free(Value_Str);
+				SC_INFO("Voltage Multiplier: %i\n",
+					(*VCCs)->Voltage[Voltage_Items].Voltage_Multiplier);
+			} else if (strcmp(Value_Str, "SMBALERT_Line") == 0) {
+				free(Value_Str);
+				(*Index)++;
+				Value_Str = strndup(Json_File + Tokens[*Index].start,
+						    Tokens[*Index].end - Tokens[*Index].start);
+				Validate_Str_Size(Value_Str, "VOLTAGE", "SMBALERT_Line",
+						  STRLEN_MAX);
+				(*VCCs)->Voltage[Voltage_Items].SMBALERT_Line = Value_Str;
+				SC_INFO("SMBALERT_Line: %s\n", Value_Str);
+			} else if (strcmp(Value_Str, "Phases") == 0) {
+				free(Value_Str);
+				(*Index)++;
+				Value_Str = strndup(Json_File + Tokens[*Index].start,
+						    Tokens[*Index].end - Tokens[*Index].start);
+				(*VCCs)->Voltage[Voltage_Items].Phases = atoi(Value_Str);
+				free(Value_Str);
+				Validate_Item_Size((*VCCs)->Voltage[Voltage_Items].Phases,
+						   "VOLTAGE", "Phases", ITEMS_MAX);
+				SC_INFO("Phases: %i\n", (*VCCs)->Voltage[Voltage_Items].Phases);
+			} else {
+				free(Value_Str);
+				(*Index)--;
+				break;
+			}
 		}
 
 		Voltage_Items++;
@@ -1666,3 +1757,249 @@ Parse_BootConfig(const char *Json_File, jsmntok_t *Tokens, int *Index, Default_P
 
 	return 0;
 }
+
+int
+Parse_I2C_Bus(const char *Json_File, jsmntok_t *Tokens, int *Index,
+	      I2C_Buses_t **Buses)
+{
+	char *Value_Str;
+	int Bus_Items = 0;
+
+	SC_INFO("********************* I2C BUSES *********************");
+	*Buses = (I2C_Buses_t *)calloc(1, sizeof(I2C_Buses_t));
+
+	(*Index)++;
+	(*Buses)->Numbers = Tokens[*Index].size;
+	Validate_Item_Size((*Buses)->Numbers, "I2C Buses", "I2C Buses", ITEMS_MAX);
+	SC_INFO("Number of I2C Buses: %i", (*Buses)->Numbers);
+	while (Bus_Items < (*Buses)->Numbers) {
+		*Index += 3;
+		Check_Attribute("I2C_Bus", "I2C Buses");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		Validate_Str_Size(Value_Str, "I2C Buses", "I2C_Bus", STRLEN_MAX);
+		(*Buses)->Bus[Bus_Items].I2C_Bus = Value_Str;
+		SC_INFO("I2C Bus: %s", (*Buses)->Bus[Bus_Items].I2C_Bus);
+
+		(*Index)++;
+		Check_Attribute("Recovery", "I2C Buses");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		if ((strcmp(Value_Str, "GPIO") != 0) &&
+		    (strcmp(Value_Str, "Rebind") != 0)) {
+			SC_ERR("I2C Buses: Recovery: invalid value '%s'", Value_Str);
+			free(Value_Str);
+			return -1;
+		}
+
+		(*Buses)->Bus[Bus_Items].Recovery = Value_Str;
+		SC_INFO("Recovery: %s", (*Buses)->Bus[Bus_Items].Recovery);
+
+		(*Index)++;
+		Check_Attribute("Recovery_Target", "I2C Buses");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		Validate_Str_Size(Value_Str, "I2C Buses", "Recovery_Target", STRLEN_MAX);
+		(*Buses)->Bus[Bus_Items].Recovery_Target = Value_Str;
+		SC_INFO("Recovery Target: %s\n", (*Buses)->Bus[Bus_Items].Recovery_Target);
+
+		Bus_Items++;
+	}
+
+	return 0;
+}
+
+int
+Parse_Derived(const char *Json_File, jsmntok_t *Tokens, int *Index,
+	      Deriveds_t **Deriveds)
+{
+	char *Value_Str;
+	int Derived_Items = 0;
+
+	SC_INFO("****************** DERIVED SENSORS ******************");
+	*Deriveds = (Deriveds_t *)calloc(1, sizeof(Deriveds_t));
+
+	(*Index)++;
+	(*Deriveds)->Numbers = Tokens[*Index].size;
+	Validate_Item_Size((*Deriveds)->Numbers, "Derived Sensors", "Derived Sensors",
+			   ITEMS_MAX);
+	SC_INFO("Number of Derived Sensors: %i", (*Deriveds)->Numbers);
+	while (Derived_Items < (*Deriveds)->Numbers) {
+		*Index += 3;
+		Check_Attribute("Name", "Derived Sensors");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		Validate_Str_Size(Value_Str, "Derived Sensors", "Name", STRLEN_MAX);
+		(*Deriveds)->Derived[Derived_Items].Name = Value_Str;
+		SC_INFO("Name: %s", (*Deriveds)->Derived[Derived_Items].Name);
+
+		(*Index)++;
+		Check_Attribute("Expression", "Derived Sensors");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		Validate_Str_Size(Value_Str, "Derived Sensors", "Expression",
+				  LSTRLEN_MAX);
+		(*Deriveds)->Derived[Derived_Items].Expression = Value_Str;
+		SC_INFO("Expression: %s\n", (*Deriveds)->Derived[Derived_Items].Expression);
+
+		Derived_Items++;
+	}
+
+	return 0;
+}
+
+int
+Parse_Profile(const char *Json_File, jsmntok_t *Tokens, int *Index,
+	      Profiles_t **Profiles)
+{
+	char *Value_Str;
+	char *End_p, *Char_p;
+	Profile_t *Profile;
+	int Profile_Items = 0;
+
+	SC_INFO("********************* PROFILES *********************");
+	*Profiles = (Profiles_t *)calloc(1, sizeof(Profiles_t));
+
+	(*Index)++;
+	(*Profiles)->Numbers = Tokens[*Index].size;
+	Validate_Item_Size((*Profiles)->Numbers, "PROFILE", "PROFILE", ITEMS_MAX);
+	SC_INFO("Number of Profiles: %i", (*Profiles)->Numbers);
+	while (Profile_Items < (*Profiles)->Numbers) {
+		Profile = &(*Profiles)->Profile[Profile_Items];
+		*Index += 3;
+		Check_Attribute("Name", "PROFILE");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		Validate_Str_Size(Value_Str, "PROFILE", "Name", STRLEN_MAX);
+		Profile->Name = Value_Str;
+		SC_INFO("\nName: %s", Profile->Name);
+
+		/* Each setting is '<clock or voltage>: <MHz or V>' */
+		(*Index)++;
+		Check_Attribute("Settings", "PROFILE");
+		Profile->Numbers = Tokens[*Index].size;
+		Validate_Item_Size(Profile->Numbers, "PROFILE", "Settings", LITEMS_MAX);
+		for (int i = 0; i < Profile->Numbers; i++) {
+			(*Index)++;
+			Value_Str = strndup(Json_File + Tokens[*Index].start,
+					    Tokens[*Index].end - Tokens[*Index].start);
+			SC_INFO("  %s", Value_Str);
+			End_p = strchr(Value_Str, ':');
+			if (End_p == NULL) {
+				SC_ERR("PROFILE: Settings: invalid setting '%s'", Value_Str);
+				free(Value_Str);
+				return -1;
+			}
+
+			*End_p++ = '\0';
+			Profile->Setting[i].Target = Value_Str;
+			Profile->Setting[i].Value = strtod(End_p, &Char_p);
+			if (Char_p == End_p || *Char_p != '\0') {
+				SC_ERR("PROFILE: Settings: invalid value for '%s'", Value_Str);
+				return -1;
+			}
+		}
+
+		Profile_Items++;
+	}
+
+	return 0;
+}
+
+int
+Parse_Power_Sequence(const char *Json_File, jsmntok_t *Tokens, int *Index,
+		     Power_Sequences_t **Power_Sequences)
+{
+	char *Value_Str;
+	char *Token[4], *End_p;
+	Power_Sequence_t *Sequence;
+	Sequence_Step_t *Step;
+	int Sequence_Items = 0;
+	int Count;
+
+	SC_INFO("****************** POWER SEQUENCES ******************");
+	*Power_Sequences = (Power_Sequences_t *)calloc(1, sizeof(Power_Sequences_t));
+
+	(*Index)++;
+	(*Power_Sequences)->Numbers = Tokens[*Index].size;
+	Validate_Item_Size((*Power_Sequences)->Numbers, "POWER SEQUENCE",
+			   "POWER SEQUENCE", ITEMS_MAX);
+	SC_INFO("Number of Power Sequences: %i", (*Power_Sequences)->Numbers);
+	while (Sequence_Items < (*Power_Sequences)->Numbers) {
+		Sequence = &(*Power_Sequences)->Power_Sequence[Sequence_Items];
+		*Index += 3;
+		Check_Attribute("Name", "POWER SEQUENCE");
+		Value_Str = strndup(Json_File + Tokens[*Index].start,
+				    Tokens[*Index].end - Tokens[*Index].start);
+		Validate_Str_Size(Value_Str, "POWER SEQUENCE", "Name", STRLEN_MAX);
+		Sequence->Name = Value_Str;
+		SC_INFO("\nName: %s", Sequence->Name);
+
+		/*
+		 * Each step is one of:
+		 *   'enable <GPIO line>', 'disable <GPIO line>',
+		 *   'setvoltage <regulator> <V>',
+		 *   'waitgpio <GPIO line> <0|1> <timeout ms>',
+		 *   'waitpgood <regulator> <timeout ms>', or 'delay <ms>'
+		 */
+		(*Index)++;
+		Check_Attribute("Steps", "POWER SEQUENCE");
+		Sequence->Numbers = Tokens[*Index].size;
+		Validate_Item_Size(Sequence->Numbers, "POWER SEQUENCE", "Steps", LITEMS_MAX);
+		for (int i = 0; i < Sequence->Numbers; i++) {
+			(*Index)++;
+			Value_Str = strndup(Json_File + Tokens[*Index].start,
+					    Tokens[*Index].end - Tokens[*Index].start);
+			SC_INFO("  %s", Value_Str);
+			Step = &Sequence->Step[i];
+			Count = 0;
+			for (End_p = strtok(Value_Str, " "); End_p != NULL;
+			     End_p = strtok(NULL, " ")) {
+				if (Count < 4) {
+					Token[Count] = End_p;
+				}
+
+				Count++;
+			}
+
+			Step->Action = SEQUENCE_ACTIONS;
+			Step->Target = (Count > 1) ? Token[1] : NULL;
+			End_p = NULL;
+			if (Count == 2 && strcmp(Token[0], "enable") == 0) {
+				Step->Action = SEQUENCE_ENABLE;
+			} else if (Count == 2 && strcmp(Token[0], "disable") == 0) {
+				Step->Action = SEQUENCE_DISABLE;
+			} else if (Count == 3 && strcmp(Token[0], "setvoltage") == 0) {
+				Step->Action = SEQUENCE_SETVOLTAGE;
+				Step->Value = strtod(Token[2], &End_p);
+			} else if (Count == 4 && strcmp(Token[0], "waitgpio") == 0) {
+				Step->Action = SEQUENCE_WAITGPIO;
+				Step->Value = strtod(Token[2], &End_p);
+				if (*End_p == '\0' && (Step->Value == 0 || Step->Value == 1)) {
+					Step->Timeout = strtol(Token[3], &End_p, 0);
+				} else {
+					End_p = Token[2];
+				}
+			} else if (Count == 3 && strcmp(Token[0], "waitpgood") == 0) {
+				Step->Action = SEQUENCE_WAITPGOOD;
+				Step->Timeout = strtol(Token[2], &End_p, 0);
+			} else if (Count == 2 && strcmp(Token[0], "delay") == 0) {
+				Step->Action = SEQUENCE_DELAY;
+				Step->Target = NULL;
+				Step->Timeout = strtol(Token[1], &End_p, 0);
+			}
+
+			if (Step->Action == SEQUENCE_ACTIONS ||
+			    (End_p != NULL && *End_p != '\0') || Step->Timeout < 0) {
+				SC_ERR("POWER SEQUENCE: Steps: invalid step %d of '%s'",
+				       i, Sequence->Name);
+				free(Value_Str);
+				return -1;
+			}
+		}
+
+		Sequence_Items++;
+	}
+
+	return 0;
+}
@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+
+/*
+ * Operating Profiles
+ *
+ * A profile is a named list of clock frequencies and regulator voltages,
+ * which is either defined in the 'PROFILE' section of the board JSON, or
+ * saved from the current state to PROFILEFILE.  A profile is applied as one
+ * transaction: all its settings are validated and the current values are
+ * recorded first.  The settings are then applied in their declared order,
+ * except that a run of consecutive voltage settings is queued at once, so
+ * that the regulators on different I2C buses are set in parallel.  Every
+ * setting is read back, and if any setting fails, the ones that have been
+ * applied are restored in the reverse order.
+ *
+ * Clocks that are programmed by a vendor utility or by 8A34001 files are
+ * not part of profiles.
+ */
+#define PROFILE_VOLTAGE_TOLERANCE	0.02	// of the voltage, or 10 mV
+#define PROFILE_CLOCK_TOLERANCE		0.001	// MHz
+
+typedef struct {
+	Setting_t	*Setting;
+	Clock_t		*Clock;
+	Voltage_t	*Regulator;
+	double		Saved;
+	double		Current;
+	bool		Applied;
+} Profile_Step_t;
+
+static bool
+Profile_Settable_Clock(Clock_t *Clock)
+{
+	return (Clock->Sysfs_Path != NULL && !Clock->Vendor_Managed &&
+		strcmp(Clock->Part_Name, "8A34001") != 0 &&
+		!(Clock->Upper_Freq == -1 && Clock->Lower_Freq == -1));
+}
+
+/*
+ * Find the clock or regulator of a setting, and check its value.
+ */
+static int
+Profile_Resolve(Setting_t *Setting, Profile_Step_t *Step)
+{
+	Clocks_t *Clocks = Plat_Devs->Clocks;
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+
+	Step->Setting = Setting;
+	Step->Clock = NULL;
+	Step->Regulator = NULL;
+	Step->Applied = false;
+	for (int i = 0; Clocks != NULL && i < Clocks->Numbers; i++) {
+		if (strcmp(Setting->Target, Clocks->Clock[i].Name) == 0) {
+			Step->Clock = &Clocks->Clock[i];
+			break;
+		}
+	}
+
+	for (int i = 0; Step->Clock == NULL && Voltages != NULL &&
+	     i < Voltages->Numbers; i++) {
+		if (strcmp(Setting->Target, Voltages->Voltage[i].Name) == 0) {
+			Step->Regulator = &Voltages->Voltage[i];
+			break;
+		}
+	}
+
+	if (Step->Clock != NULL) {
+		if (!Profile_Settable_Clock(Step->Clock)) {
+			SC_ERR("frequency of clock %s cannot be set by a profile",
+			       Setting->Target);
+			return -1;
+		}
+
+		if (Setting->Value > Step->Clock->Upper_Freq ||
+		    Setting->Value < Step->Clock->Lower_Freq) {
+			SC_ERR("valid frequency range of %s is %.3f MHz - %.3f MHz",
+			       Setting->Target, Step->Clock->Lower_Freq,
+			       Step->Clock->Upper_Freq);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	if (Step->Regulator == NULL) {
+		SC_ERR("invalid profile target %s", Setting->Target);
+		return -1;
+	}
+
+	if (Step->Regulator->Minimum_Volt != -1 && Step->Regulator->Maximum_Volt != -1 &&
+	    (Setting->Value < Step->Regulator->Minimum_Volt ||
+	     Setting->Value > Step->Regulator->Maximum_Volt)) {
+		SC_ERR("valid voltage range of %s is %.2f V - %.2f V", Setting->Target,
+		       Step->Regulator->Minimum_Volt, Step->Regulator->Maximum_Volt);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+Profile_Read(Profile_Step_t *Step, double *Value)
+{
+	Sysfs_Attr_t Attr = { 0 };
+	char Output[STRLEN_MAX];
+	float Voltage;
+
+	if (Step->Clock != NULL) {
+		Attr.Path = Step->Clock->Sysfs_Path;
+		Attr.Buffer = Output;
+		Attr.Length = sizeof(Output);
+		if (Sysfs_Read(&Attr, 1) != 0) {
+			SC_ERR("failed to get frequency of %s", Step->Clock->Name);
+			return -1;
+		}
+
+		*Value = strtod(Output, NULL) / 1000000.0;	// In MHz
+		return 0;
+	}
+
+	if (Access_Regulator(Step->Regulator, &Voltage, 0) != 0) {
+		SC_ERR("failed to get voltage of %s", Step->Regulator->Name);
+		return -1;
+	}
+
+	*Value = Voltage;
+	return 0;
+}
+
+static int
+Profile_Write_Clock(Clock_t *Clock, double Frequency)
+{
+	char Value[STRLEN_MAX];
+	int FD;
+	int Ret = 0;
+
+	FD = open(Clock->Sysfs_Path, O_WRONLY);
+	if (FD < 0) {
+		SC_ERR("failed to open %s: %m", Clock->Sysfs_Path);
+		return -1;
+	}
+
+	(void) sprintf(Value, "%u\n", (unsigned int)(Frequency * 1000000));
+	if (write(FD, Value, strlen(Value)) != strlen(Value)) {
+		SC_ERR("failed to set frequency of %s: %m", Clock->Name);
+		Ret = -1;
+	}
+
+	(void) close(FD);
+	return Ret;
+}
+
+/*
+ * Apply the settings in order.  A run of voltage settings is queued on the
+ * workers of their buses before any of them is waited for.
+ */
+static int
+Profile_Run(Profile_Step_t *Steps, int Numbers)
+{
+	I2C_Sequence_t *Sequences[LITEMS_MAX];
+	int Ret = 0;
+	int End;
+
+	for (int i = 0; i < Numbers && Ret == 0; i = End) {
+		if (Steps[i].Clock != NULL) {
+			Steps[i].Applied = true;
+			Ret = Profile_Write_Clock(Steps[i].Clock, Steps[i].Setting->Value);
+			End = i + 1;
+			continue;
+		}
+
+		for (End = i; End < Numbers && Steps[End].Regulator != NULL; End++) {
+			Sequences[End] = Regulator_Set_Submit(Steps[End].Regulator,
+							      Steps[End].Setting->Value);
+			Steps[End].Applied = true;
+			if (Sequences[End] == NULL) {
+				Ret = -1;
+			}
+		}
+
+		for (int j = i; j < End; j++) {
+			if (Sequences[j] == NULL) {
+				continue;
+			}
+
+			if (I2C_Wait(Sequences[j]) != 0) {
+				SC_ERR("failed to set voltage of %s", Steps[j].Regulator->Name);
+				Ret = -1;
+			}
+
+			free(Sequences[j]);
+		}
+	}
+
+	return Ret;
+}
+
+/*
+ * Restore the applied settings to their recorded values, in reverse order.
+ */
+static void
+Profile_Rollback(Profile_Step_t *Steps, int Numbers)
+{
+	float Voltage;
+
+	for (int i = Numbers - 1; i >= 0; i--) {
+		if (!Steps[i].Applied) {
+			continue;
+		}
+
+		if (Steps[i].Clock != NULL) {
+			(void) Profile_Write_Clock(Steps[i].Clock, Steps[i].Saved);
+			continue;
+		}
+
+		Voltage = Steps[i].Saved;
+		if (Access_Regulator(Steps[i].Regulator, &Voltage, 1) != 0) {
+			SC_ERR("failed to restore voltage of %s", Steps[i].Regulator->Name);
+		}
+	}
+}
+
+/*
+ * Load profile 'Name' from the board JSON, or else from PROFILEFILE.  Returns
+ * 1 if the profile was loaded from the file, in which case its targets are
+ * to be freed.
+ */
+static int
+Profile_Load(char *Name, Profile_t *Profile)
+{
+	Profiles_t *Profiles = Plat_Devs->Profiles;
+	char Buffer[SYSCMD_MAX];
+	char *Target, *Value;
+	FILE *FP;
+
+	for (int i = 0; Profiles != NULL && i < Profiles->Numbers; i++) {
+		if (strcmp(Name, Profiles->Profile[i].Name) == 0) {
+			*Profile = Profiles->Profile[i];
+			return 0;
+		}
+	}
+
+	FP = fopen(PROFILEFILE, "r");
+	if (FP == NULL) {
+		SC_ERR("invalid profile %s", Name);
+		return -1;
+	}
+
+	/* Each line is '<profile>\t<target>:\t<value>' */
+	Profile->Name = Name;
+	Profile->Numbers = 0;
+	while (Profile->Numbers < LITEMS_MAX && fgets(Buffer, SYSCMD_MAX, FP)) {
+		Target = strchr(Buffer, '\t');
+		if (Target == NULL) {
+			continue;
+		}
+
+		*Target++ = '\0';
+		Value = strchr(Target, ':');
+		if (strcmp(Buffer, Name) != 0 || Value == NULL) {
+			continue;
+		}
+
+		*Value++ = '\0';
+		Profile->Setting[Profile->Numbers].Target = strdup(Target);
+		Profile->Setting[Profile->Numbers].Value = strtod(Value, NULL);
+		Profile->Numbers++;
+	}
+
+	(void) fclose(FP);
+	if (Profile->Numbers == 0) {
+		SC_ERR("invalid profile %s", Name);
+		return -1;
+	}
+
+	return 1;
+}
+
+/*
+ * Apply profile 'Name' as one transaction.
+ */
+int
+Profile_Apply(char *Name)
+{
+	Profile_t Profile;
+	Profile_Step_t Steps[LITEMS_MAX];
+	double Tolerance;
+	int Loaded;
+	int Ret = -1;
+
+	Loaded = Profile_Load(Name, &Profile);
+	if (Loaded == -1) {
+		return -1;
+	}
+
+	/* Validate all the settings, and record the current values */
+	for (int i = 0; i < Profile.Numbers; i++) {
+		if (Profile_Resolve(&Profile.Setting[i], &Steps[i]) != 0 ||
+		    Profile_Read(&Steps[i], &Steps[i].Saved) != 0) {
+			goto Out;
+		}
+	}
+
+	if (Profile_Run(Steps, Profile.Numbers) != 0) {
+		SC_ERR("failed to apply profile %s, restoring the previous state", Name);
+		Profile_Rollback(Steps, Profile.Numbers);
+		goto Out;
+	}
+
+	/* Verify the readback of every setting */
+	for (int i = 0; i < Profile.Numbers; i++) {
+		Tolerance = ((Steps[i].Clock != NULL) ? PROFILE_CLOCK_TOLERANCE :
+			     fmax(0.01, (Profile.Setting[i].Value *
+					 PROFILE_VOLTAGE_TOLERANCE)));
+		if (Profile_Read(&Steps[i], &Steps[i].Current) != 0 ||
+		    fabs(Steps[i].Current - Profile.Setting[i].Value) > Tolerance) {
+			SC_ERR("failed to verify %s of profile %s, restoring the "
+			       "previous state", Profile.Setting[i].Target, Name);
+			Profile_Rollback(Steps, Profile.Numbers);
+			goto Out;
+		}
+	}
+
+	SC_PRINT("Target\tPrevious\tCurrent");
+	for (int i = 0; i < Profile.Numbers; i++) {
+		SC_PRINT("%s\t%.3f\t%.3f", Profile.Setting[i].Target, Steps[i].Saved,
+			 Steps[i].Current);
+	}
+
+	Ret = 0;
+Out:
+	for (int i = 0; Loaded == 1 && i < Profile.Numbers; i++) {
+		free(Profile.Setting[i].Target);
+	}
+
+	return Ret;
+}
+
+/*
+ * Save the current frequency of the settable clocks, and the voltage of
+ * the regulators, to profile 'Name' in PROFILEFILE.
+ */
+int
+Profile_Save(char *Name)
+{
+	Profiles_t *Profiles = Plat_Devs->Profiles;
+	Clocks_t *Clocks = Plat_Devs->Clocks;
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+	Profile_Step_t Step = { 0 };
+	char Buffer[SYSCMD_MAX];
+	double Value;
+	FILE *FP;
+	int Ret = 0;
+
+	for (int i = 0; Name[i] != '\0'; i++) {
+		if (!isalnum((unsigned char)Name[i]) && Name[i] != '-' && Name[i] != '_') {
+			SC_ERR("invalid profile name %s", Name);
+			return -1;
+		}
+	}
+
+	for (int i = 0; Profiles != NULL && i < Profiles->Numbers; i++) {
+		if (strcmp(Name, Profiles->Profile[i].Name) == 0) {
+			SC_ERR("profile %s is defined by the board", Name);
+			return -1;
+		}
+	}
+
+	/* Remove the old profile, if any */
+	(void) sprintf(Buffer, "sed -i -e \'/^%s\\t/d\' %s 2> /dev/NULL", Name,
+		       PROFILEFILE);
+	(void) Shell_Execute(Buffer);
+	FP = fopen(PROFILEFILE, "a");
+	if (FP == NULL) {
+		SC_ERR("failed to append profile file %s: %m", PROFILEFILE);
+		return -1;
+	}
+
+	for (int i = 0; Clocks != NULL && i < Clocks->Numbers && Ret == 0; i++) {
+		Step.Clock = &Clocks->Clock[i];
+		if (!Profile_Settable_Clock(Step.Clock)) {
+			continue;
+		}
+
+		Ret = Profile_Read(&Step, &Value);
+		(void) fprintf(FP, "%s\t%s:\t%.6f\n", Name, Step.Clock->Name, Value);
+	}
+
+	Step.Clock = NULL;
+	for (int i = 0; Voltages != NULL && i < Voltages->Numbers && Ret == 0; i++) {
+		Step.Regulator = &Voltages->Voltage[i];
+		Ret = Profile_Read(&Step, &Value);
+		(void) fprintf(FP, "%s\t%s:\t%.4f\n", Name, Step.Regulator->Name, Value);
+	}
+
+	(void) fflush(FP);
+	(void) fsync(fileno(FP));
+	(void) fclose(FP);
+	if (Ret != 0) {
+		SC_ERR("failed to save profile %s", Name);
+		(void) sprintf(Buffer, "sed -i -e \'/^%s\\t/d\' %s 2> /dev/NULL", Name,
+			       PROFILEFILE);
+		(void) Shell_Execute(Buffer);
+	}
+
+	return Ret;
+}
+
+/*
+ * List the profiles of the board, followed by the saved ones.
+ */
+int
+Profile_List(void)
+{
+	Profiles_t *Profiles = Plat_Devs->Profiles;
+	char Buffer[SYSCMD_MAX];
+	char Last[SYSCMD_MAX] = "";
+	FILE *FP;
+
+	for (int i = 0; Profiles != NULL && i < Profiles->Numbers; i++) {
+		SC_PRINT("%s", Profiles->Profile[i].Name);
+	}
+
+	FP = fopen(PROFILEFILE, "r");
+	if (FP == NULL) {
+		return 0;
+	}
+
+	/* The lines of a saved profile are consecutive */
+	while (fgets(Buffer, SYSCMD_MAX, FP)) {
+		(void) strtok(Buffer, "\t");
+		if (strcmp(Buffer, Last) != 0) {
+			SC_PRINT("%s - saved", Buffer);
+			(void) strcpy(Last, Buffer);
+		}
+	}
+
+	(void) fclose(FP);
+	return 0;
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+
+/*
+ * Power Sequences
+ *
+ * A power sequence is a named list of steps, defined in the 'Power Sequences'
+ * section of the board JSON: driving rail enable lines, setting and enabling
+ * regulators, waiting for power-good on a GPIO line or in STATUS_WORD of a
+ * regulator, and delays.  The GPIO lines and regulators of all steps, and
+ * the voltages that they set, are checked before the first step is run, so a
+ * sequence with an invalid step runs no step at all.  The steps are then
+ * run back to back, the waits poll every SEQUENCE_POLL_INTERVAL until their
+ * timeout, and the start and duration of each step are reported along with
+ * the total time of the sequence.  A sequence stops at the first step that
+ * fails.
+ */
+#define SEQUENCE_POLL_INTERVAL	100000		// ns
+#define PMBUS_POWER_GOOD_N	0x0800		// of STATUS_WORD
+
+static const char *Sequence_Actions[SEQUENCE_ACTIONS] = {
+	"enable", "disable", "setvoltage", "waitgpio", "waitpgood", "delay",
+};
+
+typedef struct {
+	Sequence_Step_t	*Step;
+	char		*Label;		// of GPIO line
+	Voltage_t	*Regulator;
+	long long	Start;		// ns from the start of the sequence
+	long long	End;
+	int		Status;
+} Sequence_Record_t;
+
+/*
+ * Find the GPIO line or regulator of a step, and check the voltage that it
+ * sets.  GPIO lines are accepted by either their display name or their line
+ * name.
+ */
+static int
+Sequence_Resolve(Sequence_Step_t *Step, Sequence_Record_t *Record)
+{
+	GPIOs_t *GPIOs = Plat_Devs->GPIOs;
+	Voltages_t *Voltages = Plat_Devs->Voltages;
+
+	Record->Step = Step;
+	Record->Label = Step->Target;
+	Record->Regulator = NULL;
+	Record->Status = 0;
+	switch (Step->Action) {
+	case SEQUENCE_ENABLE:
+	case SEQUENCE_DISABLE:
+	case SEQUENCE_WAITGPIO:
+		for (int i = 0; GPIOs != NULL && i < GPIOs->Numbers; i++) {
+			if (strcmp(Step->Target, GPIOs->GPIO[i].Display_Name) == 0) {
+				Record->Label = (char *)GPIOs->GPIO[i].Internal_Name;
+				break;
+			}
+		}
+
+		if (!GPIO_Line_Exists(Record->Label)) {
+			SC_ERR("invalid GPIO line %s", Step->Target);
+			return -1;
+		}
+
+		return 0;
+	case SEQUENCE_SETVOLTAGE:
+	case SEQUENCE_WAITPGOOD:
+		for (int i = 0; Voltages != NULL && i < Voltages->Numbers; i++) {
+			if (strcmp(Step->Target, Voltages->Voltage[i].Name) == 0) {
+				Record->Regulator = &Voltages->Voltage[i];
+				break;
+			}
+		}
+
+		if (Record->Regulator == NULL) {
+			SC_ERR("invalid regulator %s", Step->Target);
+			return -1;
+		}
+
+		if (Step->Action == SEQUENCE_SETVOLTAGE &&
+		    Record->Regulator->Minimum_Volt != -1 &&
+		    Record->Regulator->Maximum_Volt != -1 &&
+		    (Step->Value < Record->Regulator->Minimum_Volt ||
+		     Step->Value > Record->Regulator->Maximum_Volt)) {
+			SC_ERR("voltage %.3f V of %s is out of its range %.2f V - %.2f V",
+			       Step->Value, Step->Target, Record->Regulator->Minimum_Volt,
+			       Record->Regulator->Maximum_Volt);
+			return -1;
+		}
+
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+static int
+Sequence_Wait_GPIO(Sequence_Record_t *Record, long long Deadline)
+{
+	int State;
+
+	for (;;) {
+#if !defined (LIBGPIOD_V1)
+		if (Get_GPIO(Record->Label, &State, GPIOD_LINE_DIRECTION_AS_IS) != 0) {
+#else
+		if (Get_GPIO(Record->Label, &State) != 0) {
+#endif
+			SC_ERR("failed to get GPIO line %s", Record->Label);
+			return -1;
+		}
+
+		if (State == (int)Record->Step->Value) {
+			return 0;
+		}
+
+		if (Monotonic_Nanoseconds() >= Deadline) {
+			SC_ERR("timed out waiting for GPIO line %s", Record->Step->Target);
+			return -1;
+		}
+
+		Monotonic_Sleep(SEQUENCE_POLL_INTERVAL);
+	}
+}
+
+/*
+ * Poll POWER_GOOD# of STATUS_WORD, by a sequence on the worker of the I2C bus
+ * that selects the page and reads STATUS_WORD.  The regulator may not answer
+ * until its input is up, so failed reads are retried quietly until the
+ * timeout.
+ */
+static int
+Sequence_Wait_PGood(Sequence_Record_t *Record, long long Deadline)
+{
+	Voltage_t *Regulator = Record->Regulator;
+	I2C_Sequence_t *Sequence;
+	unsigned char Buffer[2];
+	unsigned char *In;
+	int Status_Op;
+	int Ret = -1;
+
+	Sequence = (I2C_Sequence_t *)calloc(1, sizeof(I2C_Sequence_t));
+	if (Sequence == NULL) {
+		SC_ERR("failed to allocate power-good sequence: %m");
+		return -1;
+	}
+
+	Sequence->I2C_Bus = Regulator->I2C_Bus;
+	Sequence->Quiet = true;
+	if (Regulator->Page_Select != -1) {
+		Buffer[0] = PMBUS_PAGE;
+		Buffer[1] = Regulator->Page_Select;
+		(void) I2C_Sequence_Add(Sequence, I2C_OP_WRITE, Regulator->I2C_Address,
+					2, Buffer, 0);
+	}
+
+	Buffer[0] = PMBUS_STATUS_WORD;
+	Status_Op = I2C_Sequence_Add(Sequence, I2C_OP_READ, Regulator->I2C_Address,
+				     1, Buffer, 2);
+	In = Sequence->Op[Status_Op].In;
+	for (;;) {
+		if (I2C_Run(Sequence) == 0 &&
+		    !(((In[1] << 8) | In[0]) & PMBUS_POWER_GOOD_N)) {
+			Ret = 0;
+			break;
+		}
+
+		if (Monotonic_Nanoseconds() >= Deadline) {
+			SC_ERR("timed out waiting for power-good of %s", Regulator->Name);
+			break;
+		}
+
+		Monotonic_Sleep(SEQUENCE_POLL_INTERVAL);
+	}
+
+	free(Sequence);
+	return Ret;
+}
+
+static int
+Sequence_Run_Step(Sequence_Record_t *Record, long long Start)
+{
+	Sequence_Step_t *Step = Record->Step;
+	long long Deadline = Start + (Step->Timeout * 1000000LL);
+	float Voltage;
+
+	switch (Step->Action) {
+	case SEQUENCE_ENABLE:
+	case SEQUENCE_DISABLE:
+		if (Set_GPIO(Record->Label, (Step->Action == SEQUENCE_ENABLE)) != 0) {
+			SC_ERR("failed to set GPIO line %s", Step->Target);
+			return -1;
+		}
+
+		return 0;
+	case SEQUENCE_SETVOLTAGE:
+		Voltage = Step->Value;
+		if (Access_Regulator(Record->Regulator, &Voltage, 1) != 0) {
+			SC_ERR("failed to set the voltage of %s", Step->Target);
+			return -1;
+		}
+
+		return 0;
+	case SEQUENCE_WAITGPIO:
+		return Sequence_Wait_GPIO(Record, Deadline);
+	case SEQUENCE_WAITPGOOD:
+		return Sequence_Wait_PGood(Record, Deadline);
+	case SEQUENCE_DELAY:
+		Monotonic_Sleep(Deadline - Monotonic_Nanoseconds());
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+/*
+ * Run a power sequence, and report the timing of its steps.
+ */
+int
+Power_Sequence_Run(const char *Name)
+{
+	Power_Sequences_t *Power_Sequences = Plat_Devs->Power_Sequences;
+	Power_Sequence_t *Sequence = NULL;
+	Sequence_Record_t Records[LITEMS_MAX];
+	Sequence_Record_t *Record;
+	char Value[STRLEN_MAX];
+	long long Start;
+	int Numbers = 0;
+	int Ret = 0;
+
+	for (int i = 0; Power_Sequences != NULL && i < Power_Sequences->Numbers; i++) {
+		if (strcmp(Name, Power_Sequences->Power_Sequence[i].Name) == 0) {
+			Sequence = &Power_Sequences->Power_Sequence[i];
+			break;
+		}
+	}
+
+	if (Sequence == NULL) {
+		SC_ERR("invalid power sequence %s", Name);
+		return -1;
+	}
+
+	for (int i = 0; i < Sequence->Numbers; i++) {
+		if (Sequence_Resolve(&Sequence->Step[i], &Records[i]) != 0) {
+			return -1;
+		}
+	}
+
+	Start = Monotonic_Nanoseconds();
+	for (int i = 0; i < Sequence->Numbers; i++) {
+		Record = &Records[i];
+		Record->Start = Monotonic_Nanoseconds();
+		Record->Status = Sequence_Run_Step(Record, Record->Start);
+		Record->End = Monotonic_Nanoseconds();
+		Numbers++;
+		if (Record->Status != 0) {
+			Ret = -1;
+			break;
+		}
+	}
+
+	SC_PRINT("Step\tAction\tTarget\tValue\tStart(ms)\tDuration(ms)\tResult");
+	for (int i = 0; i < Numbers; i++) {
+		Record = &Records[i];
+		switch (Record->Step->Action) {
+		case SEQUENCE_SETVOLTAGE:
+			(void) snprintf(Value, sizeof(Value), "%.3f", Record->Step->Value);
+			break;
+		case SEQUENCE_WAITGPIO:
+			(void) snprintf(Value, sizeof(Value), "%d", (int)Record->Step->Value);
+			break;
+		case SEQUENCE_DELAY:
+			(void) snprintf(Value, sizeof(Value), "%d", Record->Step->Timeout);
+			break;
+		default:
+			(void) strcpy(Value, "-");
+			break;
+		}
+
+		SC_PRINT("%d\t%s\t%s\t%s\t%.3f\t%.3f\t%s", i,
+			 Sequence_Actions[Record->Step->Action],
+			 ((Record->Step->Target != NULL) ? Record->Step->Target : "-"),
+			 Value, (float)(Record->Start - Start) / 1000000,
+			 (float)(Record->End - Record->Start) / 1000000,
+			 ((Record->Status == 0) ? "OK" : "FAILED"));
+	}
+
+	SC_PRINT("Total(ms):\t%.3f", (float)(Monotonic_Nanoseconds() - Start) / 1000000);
+	return Ret;
+}
+
+/*
+ * List the power sequences of the board.
+ */
+int
+Power_Sequence_List(void)
+{
+	Power_Sequences_t *Power_Sequences = Plat_Devs->Power_Sequences;
+
+	for (int i = 0; Power_Sequences != NULL && i < Power_Sequences->Numbers; i++) {
+		SC_PRINT("%s", Power_Sequences->Power_Sequence[i].Name);
+	}
+
+	return 0;
+}
@@ -0,0 +1,676 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <glob.h>
+#include <libgen.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "sc_app.h"
+
+extern Plat_Devs_t *Plat_Devs;
+extern char Board_Name[];
+
+/*
+ * SiT95211 and SiT95314 Clocks
+ *
+ * The clocks are programmed with designs generated by the SiTime tools: a
+ * runtime file of register writes, with the delays between them, and an
+ * image of the NVM, which is a separate EEPROM device behind the clock.
+ * Both are looked up in the clock files of the chip under BIT_PATH, and
+ * then under CUSTOM_CFS_PATH.  The design that is programmed at runtime is
+ * recorded in VENDORCLOCKDIR, which is removed at boot time.  Otherwise, the
+ * design in effect is found by comparing the NVM with the images of all
+ * designs; each NVM page is read at most once.  A programmed NVM is read
+ * back and verified.
+ */
+#define SITIME_CFS_PATH		BIT_PATH"clock_files/"
+#define SITIME_EEPROM_PATH	"/sys/bus/i2c/devices/*/eeprom_sit95*"
+#define SITIME_RUNTIME_EXT	".csv"
+#define SITIME_EEPROM_EXT	".eeprom.py"
+#define SITIME_WRITES_MAX	2048
+#define SITIME_NVM_SIZE		8192
+#define SITIME_PAGE		32
+#define SITIME_BLANK_SIZE	256		// of an NVM that is never programmed
+#define SITIME_WRITE_TIMEOUT	20		// ms, of an NVM page write
+
+/* First four bytes of a valid NVM image: size, device ID, config, page ID */
+static const unsigned char SiTime_NVM_ID[] = { 0x00, 0x69, 0x01, 0x00 };
+
+/* Board revisions with their own default design */
+static const char *SiTime_Revisions[] = { "A01" };
+
+typedef struct {
+	int		Numbers;
+	struct {
+		unsigned char	Offset;
+		unsigned char	Data;
+		long		Delay;		// us, before the write
+	} Write[SITIME_WRITES_MAX];
+	long		Delay;			// us, after the last write
+} SiTime_Runtime_t;
+
+typedef struct {
+	int		Length;
+	unsigned char	Data[SITIME_NVM_SIZE];
+} SiTime_Image_t;
+
+typedef struct {
+	int		FD;
+	int		Address;
+	int		Length;		// read so far
+	unsigned char	Data[SITIME_NVM_SIZE];
+} SiTime_NVM_t;
+
+/*
+ * Find the 'Extension' file of 'Design' of the clock.
+ */
+static int
+SiTime_Find_File(Clock_t *Clock, const char *Design, const char *Extension,
+		 char *File)
+{
+	(void) snprintf(File, SYSCMD_MAX, "%s%s/%s%s", SITIME_CFS_PATH,
+			Clock->Part_Name, Design, Extension);
+	if (access(File, F_OK) == 0) {
+		return 0;
+	}
+
+	(void) snprintf(File, SYSCMD_MAX, "%s%s%s", CUSTOM_CFS_PATH, Design,
+			Extension);
+	if (access(File, F_OK) == 0) {
+		return 0;
+	}
+
+	SC_ERR("failed to find %s file of design '%s'", Extension, Design);
+	return -1;
+}
+
+/*
+ * Read a runtime file: 'sleep(<seconds>)' lines and '<offset>, <data>' lines
+ * of hex values.
+ */
+static int
+SiTime_Read_Runtime(const char *File, SiTime_Runtime_t *Runtime)
+{
+	FILE *FP;
+	char Line[STRLEN_MAX];
+	unsigned int Offset, Data;
+	long Delay = 0;
+
+	FP = fopen(File, "r");
+	if (FP == NULL) {
+		SC_ERR("failed to open file %s: %m", File);
+		return -1;
+	}
+
+	Runtime->Numbers = 0;
+	while (fgets(Line, sizeof(Line), FP) != NULL) {
+		if (strncmp(Line, "sleep(", 6) == 0) {
+			Delay += (long)(strtod(&Line[6], NULL) * 1000000);
+			continue;
+		}
+
+		if (sscanf(Line, "%x , %x", &Offset, &Data) != 2 || Offset > 0xFF ||
+		    Data > 0xFF) {
+			if (strspn(Line, " \t\r\n") == strlen(Line)) {
+				continue;
+			}
+
+			SC_ERR("invalid line '%s' in %s", strtok(Line, "\r\n"), File);
+			(void) fclose(FP);
+			return -1;
+		}
+
+		if (Runtime->Numbers == SITIME_WRITES_MAX) {
+			SC_ERR("%s has more than %d writes", File, SITIME_WRITES_MAX);
+			(void) fclose(FP);
+			return -1;
+		}
+
+		Runtime->Write[Runtime->Numbers].Offset = Offset;
+		Runtime->Write[Runtime->Numbers].Data = Data;
+		Runtime->Write[Runtime->Numbers].Delay = Delay;
+		Runtime->Numbers++;
+		Delay = 0;
+	}
+
+	Runtime->Delay = Delay;
+	(void) fclose(FP);
+	return 0;
+}
+
+/*
+ * Read an NVM image file: one line of '0x' followed by four bytes in hex
+ * for each word.
+ */
+static int
+SiTime_Read_Image(const char *File, SiTime_Image_t *Image)
+{
+	FILE *FP;
+	char Line[STRLEN_MAX];
+	char *Walk;
+	unsigned int Byte;
+
+	FP = fopen(File, "r");
+	if (FP == NULL) {
+		SC_ERR("failed to open file %s: %m", File);
+		return -1;
+	}
+
+	Image->Length = 0;
+	while (fgets(Line, sizeof(Line), FP) != NULL) {
+		Walk = strtok(Line, " \t\r\n");
+		if (Walk == NULL) {
+			continue;
+		}
+
+		if (strncmp(Walk, "0x", 2) != 0 || (strlen(Walk) % 2) != 0) {
+			SC_ERR("invalid hex value '%s' in %s", Walk, File);
+			(void) fclose(FP);
+			return -1;
+		}
+
+		for (Walk += 2; *Walk != '\0'; Walk += 2) {
+			if (!isxdigit(Walk[0]) || !isxdigit(Walk[1]) ||
+			    sscanf(Walk, "%2x", &Byte) != 1) {
+				SC_ERR("invalid hex value in %s", File);
+				(void) fclose(FP);
+				return -1;
+			}
+
+			if (Image->Length == SITIME_NVM_SIZE) {
+				SC_ERR("%s is larger than %d bytes", File, SITIME_NVM_SIZE);
+				(void) fclose(FP);
+				return -1;
+			}
+
+			Image->Data[Image->Length++] = Byte;
+		}
+	}
+
+	(void) fclose(FP);
+	return 0;
+}
+
+/*
+ * Open the NVM of the clock.  Its address is that of the 'eeprom_sit95'
+ * device on the bus of the clock, or of the first one if there is none.
+ */
+static int
+SiTime_NVM_Open(Clock_t *Clock, SiTime_NVM_t *NVM)
+{
+	glob_t Glob_Buffer;
+	char Device[SYSCMD_MAX];
+	char *Name;
+	int Bus;
+
+	if (glob(SITIME_EEPROM_PATH, 0, NULL, &Glob_Buffer) != 0 ||
+	    Glob_Buffer.gl_pathc == 0) {
+		SC_ERR("failed to find the NVM of %s", Clock->Name);
+		return -1;
+	}
+
+	NVM->Address = -1;
+	for (int i = (int)Glob_Buffer.gl_pathc - 1; i >= 0; i--) {
+		/* .../devices/<bus>-<address>/eeprom_sit95... */
+		(void) snprintf(Device, sizeof(Device), "%s", Glob_Buffer.gl_pathv[i]);
+		Name = basename(dirname(Device));
+		if (sscanf(Name, "%d-%x", &Bus, &NVM->Address) != 2) {
+			continue;
+		}
+
+		if (Bus == I2C_Bus_Number(Clock->I2C_Bus)) {
+			break;
+		}
+	}
+
+	globfree(&Glob_Buffer);
+	if (NVM->Address == -1) {
+		SC_ERR("failed to find the NVM of %s", Clock->Name);
+		return -1;
+	}
+
+	NVM->FD = I2C_Open(Clock->I2C_Bus);
+	if (NVM->FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", Clock->I2C_Bus);
+		return -1;
+	}
+
+	NVM->Length = 0;
+	return 0;
+}
+
+/*
+ * Read the NVM up to 'Length' bytes, a page at a time, from where it was
+ * read last.
+ */
+static int
+SiTime_NVM_Read(SiTime_NVM_t *NVM, int Length)
+{
+	struct i2c_msg Msgs[2];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 2 };
+	unsigned char Offset[2];
+
+	Msgs[0].addr = Msgs[1].addr = NVM->Address;
+	Msgs[0].flags = 0;
+	Msgs[0].len = 2;
+	Msgs[0].buf = Offset;
+	Msgs[1].flags = I2C_M_RD;
+	Msgs[1].len = SITIME_PAGE;
+	Length = MIN(Length, SITIME_NVM_SIZE);
+	while (NVM->Length < Length) {
+		Offset[0] = (NVM->Length >> 8) & 0xFF;
+		Offset[1] = NVM->Length & 0xFF;
+		Msgs[1].buf = &NVM->Data[NVM->Length];
+		if (I2C_Transfer(NVM->FD, &Msgset) < 0) {
+			SC_ERR("unable to read NVM %#x: %m", NVM->Address);
+			return -1;
+		}
+
+		NVM->Length += SITIME_PAGE;
+	}
+
+	return 0;
+}
+
+/*
+ * Return 1 if the NVM holds 'Data', 0 if not, or -1 on failure.  The last
+ * page is not compared, as it was not by the SiTime utilities.
+ */
+static int
+SiTime_NVM_Compare(SiTime_NVM_t *NVM, const unsigned char *Data, int Length)
+{
+	Length = ((Length - 1) / SITIME_PAGE) * SITIME_PAGE;
+	if (Length <= 0) {
+		return 0;
+	}
+
+	for (int i = 0; i < Length; i += SITIME_PAGE) {
+		if (SiTime_NVM_Read(NVM, (i + SITIME_PAGE)) != 0) {
+			return -1;
+		}
+
+		if (memcmp(&NVM->Data[i], &Data[i], SITIME_PAGE) != 0) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Program an image to the NVM, and verify it.  The end of each page write
+ * is polled for, by setting the offset of the next one.
+ */
+static int
+SiTime_NVM_Program(Clock_t *Clock, const char *Design)
+{
+	SiTime_Image_t *Image;
+	SiTime_NVM_t *NVM;
+	struct i2c_msg Msgs[1];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 1 };
+	unsigned char Out[SITIME_PAGE + 2];
+	char File[SYSCMD_MAX];
+	int Length;
+	int Wait;
+	int Ret = -1;
+
+	if (SiTime_Find_File(Clock, Design, SITIME_EEPROM_EXT, File) != 0) {
+		return -1;
+	}
+
+	Image = (SiTime_Image_t *)malloc(sizeof(SiTime_Image_t));
+	NVM = (SiTime_NVM_t *)malloc(sizeof(SiTime_NVM_t));
+	if (Image == NULL || NVM == NULL) {
+		SC_ERR("failed to allocate NVM image: %m");
+		free(Image);
+		free(NVM);
+		return -1;
+	}
+
+	if (SiTime_Read_Image(File, Image) != 0) {
+		goto Out;
+	}
+
+	if (Image->Length < (int)sizeof(SiTime_NVM_ID) ||
+	    memcmp(Image->Data, SiTime_NVM_ID, sizeof(SiTime_NVM_ID)) != 0) {
+		SC_ERR("file '%s' is not generated correctly", File);
+		goto Out;
+	}
+
+	if (SiTime_NVM_Open(Clock, NVM) != 0) {
+		goto Out;
+	}
+
+	Msgs[0].addr = NVM->Address;
+	Msgs[0].flags = 0;
+	Msgs[0].buf = Out;
+	for (int i = 0; i < Image->Length; i += SITIME_PAGE) {
+		Length = MIN(SITIME_PAGE, (Image->Length - i));
+		Out[0] = (i >> 8) & 0xFF;
+		Out[1] = i & 0xFF;
+		(void) memcpy(&Out[2], &Image->Data[i], Length);
+		Msgs[0].len = Length + 2;
+		for (Wait = 0; I2C_Transfer(NVM->FD, &Msgset) < 0; Wait++) {
+			if (Wait == SITIME_WRITE_TIMEOUT) {
+				SC_ERR("unable to write NVM %#x: %m", NVM->Address);
+				(void) close(NVM->FD);
+				goto Out;
+			}
+
+			Monotonic_Sleep(1000000);
+		}
+	}
+
+	/* Wait for the last page write */
+	Out[0] = Out[1] = 0;
+	Msgs[0].len = 2;
+	for (Wait = 0; I2C_Transfer(NVM->FD, &Msgset) < 0; Wait++) {
+		if (Wait == SITIME_WRITE_TIMEOUT) {
+			SC_ERR("NVM %#x is not ready: %m", NVM->Address);
+			(void) close(NVM->FD);
+			goto Out;
+		}
+
+		Monotonic_Sleep(1000000);
+	}
+
+	Ret = SiTime_NVM_Compare(NVM, Image->Data, Image->Length);
+	(void) close(NVM->FD);
+	if (Ret != 1) {
+		SC_ERR("failed to verify NVM of %s with design '%s'", Clock->Name, Design);
+		Ret = -1;
+		goto Out;
+	}
+
+	SC_INFO("Programmed and verified NVM of %s with design '%s'", Clock->Name,
+		Design);
+	Ret = 0;
+Out:
+	free(Image);
+	free(NVM);
+	return Ret;
+}
+
+/*
+ * Program the runtime design over one open file descriptor, and record it.
+ */
+static int
+SiTime_Program(Clock_t *Clock, const char *Design)
+{
+	SiTime_Runtime_t *Runtime;
+	struct i2c_msg Msgs[1];
+	struct i2c_rdwr_ioctl_data Msgset = { Msgs, 1 };
+	unsigned char Out[2];
+	char File[SYSCMD_MAX];
+	FILE *FP;
+	int FD;
+	int Ret = 0;
+
+	if (SiTime_Find_File(Clock, Design, SITIME_RUNTIME_EXT, File) != 0) {
+		return -1;
+	}
+
+	Runtime = (SiTime_Runtime_t *)malloc(sizeof(SiTime_Runtime_t));
+	if (Runtime == NULL) {
+		SC_ERR("failed to allocate clock design: %m");
+		return -1;
+	}
+
+	if (SiTime_Read_Runtime(File, Runtime) != 0) {
+		free(Runtime);
+		return -1;
+	}
+
+	FD = I2C_Open(Clock->I2C_Bus);
+	if (FD < 0) {
+		SC_ERR("unable to access I2C bus %s: %m", Clock->I2C_Bus);
+		free(Runtime);
+		return -1;
+	}
+
+	Msgs[0].addr = Clock->I2C_Address;
+	Msgs[0].flags = 0;
+	Msgs[0].len = 2;
+	Msgs[0].buf = Out;
+	for (int i = 0; i < Runtime->Numbers; i++) {
+		if (Runtime->Write[i].Delay > 0) {
+			Monotonic_Sleep((long long)Runtime->Write[i].Delay * 1000);
+		}
+
+		Out[0] = Runtime->Write[i].Offset;
+		Out[1] = Runtime->Write[i].Data;
+		if (I2C_Transfer(FD, &Msgset) < 0) {
+			SC_ERR("unable to write to I2C device %#x: %m", Clock->I2C_Address);
+			Ret = -1;
+			break;
+		}
+	}
+
+	if (Ret == 0 && Runtime->Delay > 0) {
+		Monotonic_Sleep((long long)Runtime->Delay * 1000);
+	}
+
+	(void) close(FD);
+	free(Runtime);
+	if (Ret != 0) {
+		return Ret;
+	}
+
+	(void) snprintf(File, sizeof(File), "%s", VENDORCLOCKDIR);
+	if (mkdir(File, 0755) != 0 && errno != EEXIST) {
+		SC_ERR("failed to create directory %s: %m", File);
+		return -1;
+	}
+
+	(void) strcat(File, "/");
+	(void) strcat(File, Clock->Name);
+	FP = fopen(File, "w");
+	if (FP == NULL) {
+		SC_ERR("failed to create file %s: %m", File);
+		return -1;
+	}
+
+	(void) fprintf(FP, "%s\n", Design);
+	(void) fclose(FP);
+	return 0;
+}
+
+/*
+ * Return the default design of the clock.  Board revisions that have their
+ * own default design, by the custom info fields of the board area of the
+ * onboard EEPROM, have the revision added to the board name in it.
+ */
+static void
+SiTime_Default_Design(Clock_t *Clock, char *Design)
+{
+	OnBoard_EEPROM_t *OnBoard = Plat_Devs->OnBoard_EEPROM;
+	unsigned char Data[256];
+	char Field[STRLEN_MAX];
+	char Pattern[SYSCMD_MAX];
+	const char *Revision = NULL;
+	glob_t Glob_Buffer = { 0 };
+	char *Board;
+	int Offset, End, Length;
+	int FD;
+
+	(void) strcpy(Design, Clock->Default_Design);
+	if (OnBoard == NULL || (FD = open(OnBoard->Path, O_RDONLY)) < 0) {
+		return;
+	}
+
+	Length = read(FD, Data, sizeof(Data));
+	(void) close(FD);
+	if (Length != sizeof(Data)) {
+		return;
+	}
+
+	/* Board area: version, length, language, date, then type/length fields */
+	Offset = Data[3] * 8;
+	if (Offset == 0 || (Offset + 6) >= (int)sizeof(Data)) {
+		return;
+	}
+
+	End = MIN((Offset + (Data[Offset + 1] * 8)), (int)sizeof(Data));
+	Offset += 6;
+	for (int i = 0; Revision == NULL && Offset < End && Data[Offset] != 0xC1; i++) {
+		Length = Data[Offset] & 0x3F;
+		if (Offset + 1 + Length > End) {
+			break;
+		}
+
+		/* Manufacturer, name, serial, part number, file ID, custom fields */
+		(void) snprintf(Field, sizeof(Field), "%.*s", Length, &Data[Offset + 1]);
+		for (int j = 0; i >= 5 && j < (int)(sizeof(SiTime_Revisions) /
+						    sizeof(SiTime_Revisions[0])); j++) {
+			if (strcmp(Field, SiTime_Revisions[j]) == 0) {
+				Revision = SiTime_Revisions[j];
+			}
+		}
+
+		Offset += 1 + Length;
+	}
+
+	Board = strstr(Clock->Default_Design, Board_Name);
+	if (Revision == NULL || Board == NULL) {
+		return;
+	}
+
+	(void) snprintf(Pattern, sizeof(Pattern), "%s%s/%s-%s*", SITIME_CFS_PATH,
+			Clock->Part_Name, Board_Name, Revision);
+	if (glob(Pattern, 0, NULL, &Glob_Buffer) == 0 && Glob_Buffer.gl_pathc != 0) {
+		Length = (Board - Clock->Default_Design) + strlen(Board_Name);
+		(void) sprintf(Design, "%.*s-%s%s", Length, Clock->Default_Design,
+			       Revision, &Clock->Default_Design[Length]);
+	}
+
+	globfree(&Glob_Buffer);
+}
+
+/*
+ * Report the design in effect of a SiTime clock.
+ */
+int
+Get_SiTime_Clock(Clock_t *Clock)
+{
+	SiTime_Image_t *Image;
+	SiTime_NVM_t *NVM;
+	char Buffer[SYSCMD_MAX];
+	char Design[SYSCMD_MAX];
+	unsigned char Blank[SITIME_BLANK_SIZE];
+	glob_t Glob_Buffer = { 0 };
+	FILE *FP;
+	int Ret = 0;
+
+	(void) snprintf(Buffer, sizeof(Buffer), "%s/%s", VENDORCLOCKDIR, Clock->Name);
+	FP = fopen(Buffer, "r");
+	if (FP != NULL) {
+		if (fgets(Design, sizeof(Design), FP) != NULL) {
+			(void) fclose(FP);
+			SC_PRINT("%s", strtok(Design, "\n"));
+			return 0;
+		}
+
+		(void) fclose(FP);
+	}
+
+	Image = (SiTime_Image_t *)malloc(sizeof(SiTime_Image_t));
+	NVM = (SiTime_NVM_t *)malloc(sizeof(SiTime_NVM_t));
+	if (Image == NULL || NVM == NULL) {
+		SC_ERR("failed to allocate NVM image: %m");
+		free(Image);
+		free(NVM);
+		return -1;
+	}
+
+	if (SiTime_NVM_Open(Clock, NVM) != 0) {
+		free(Image);
+		free(NVM);
+		return -1;
+	}
+
+	/* An NVM that is never programmed is blank */
+	(void) memset(Blank, 0xFF, sizeof(Blank));
+	Ret = SiTime_NVM_Compare(NVM, Blank, sizeof(Blank));
+	if (Ret == 1) {
+		SiTime_Default_Design(Clock, Design);
+		SC_PRINT("%s", Design);
+		Ret = 0;
+		goto Out;
+	}
+
+	(void) snprintf(Buffer, sizeof(Buffer), "%s%s/*%s", SITIME_CFS_PATH,
+			Clock->Part_Name, SITIME_EEPROM_EXT);
+	(void) glob(Buffer, 0, NULL, &Glob_Buffer);
+	(void) snprintf(Buffer, sizeof(Buffer), "%s*%s", CUSTOM_CFS_PATH,
+			SITIME_EEPROM_EXT);
+	(void) glob(Buffer, GLOB_APPEND, NULL, &Glob_Buffer);
+	for (int i = 0; Ret == 0 && i < (int)Glob_Buffer.gl_pathc; i++) {
+		if (SiTime_Read_Image(Glob_Buffer.gl_pathv[i], Image) != 0) {
+			continue;
+		}
+
+		Ret = SiTime_NVM_Compare(NVM, Image->Data, Image->Length);
+		if (Ret == 1) {
+			(void) snprintf(Design, sizeof(Design), "%s",
+					basename(Glob_Buffer.gl_pathv[i]));
+			Design[strlen(Design) - strlen(SITIME_EEPROM_EXT)] = '\0';
+			SC_PRINT("%s", Design);
+		}
+	}
+
+	globfree(&Glob_Buffer);
+	if (Ret == 0) {
+		SC_ERR("could not identify the design for clock '%s'", Clock->Name);
+	}
+
+	Ret = ((Ret == 1) ? 0 : -1);
+Out:
+	(void) close(NVM->FD);
+	free(Image);
+	free(NVM);
+	return Ret;
+}
+
+/*
+ * Program 'Design' on a SiTime clock, and for 'Mode' 1, also to its NVM so
+ * that it is in effect at boot time.
+ */
+int
+Set_SiTime_Clock(Clock_t *Clock, char *Design, int Mode)
+{
+	char File[SYSCMD_MAX];
+
+	/* Make sure that the runtime file is there before the NVM is changed */
+	if (SiTime_Find_File(Clock, Design, SITIME_RUNTIME_EXT, File) != 0) {
+		return -1;
+	}
+
+	if (Mode == 1 && SiTime_NVM_Program(Clock, Design) != 0) {
+		return -1;
+	}
+
+	return SiTime_Program(Clock, Design);
+}
+
+/*
+ * Program the default design on a SiTime clock and to its NVM.
+ */
+int
+Restore_SiTime_Clock(Clock_t *Clock)
+{
+	char Design[SYSCMD_MAX];
+
+	SiTime_Default_Design(Clock, Design);
+	return Set_SiTime_Clock(Clock, Design, 1);
+}
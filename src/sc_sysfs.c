@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026 Advanced Micro Devices, Inc.  All rights reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include "sc_app.h"
+
+#ifdef __NR_io_uring_setup
+#include <linux/io_uring.h>
+#endif
+
+/*
+ * Batched Attribute Reader
+ *
+ * Attributes under sysfs, such as clock frequencies, hwmon inputs, and nvmem
+ * EEPROMs, are kept open once they are first read.  A set of attributes is
+ * read in a single io_uring submission when the kernel supports it, or with
+ * one pread(2) per attribute otherwise.
+ */
+#define SYSFS_FDS_MAX		LITEMS_MAX
+#define SYSFS_RING_ENTRIES	64
+
+static struct {
+	char	*Path;
+	int	FD;
+} Sysfs_FDs[SYSFS_FDS_MAX];
+
+static int Sysfs_FD_Numbers;
+static pthread_mutex_t Sysfs_Lock = PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef __NR_io_uring_setup
+static struct {
+	int			FD;
+	unsigned int		Entries;
+	unsigned int		*SQ_Tail;
+	unsigned int		*SQ_Mask;
+	unsigned int		*SQ_Array;
+	struct io_uring_sqe	*SQEs;
+	unsigned int		*CQ_Head;
+	unsigned int		*CQ_Tail;
+	unsigned int		*CQ_Mask;
+	struct io_uring_cqe	*CQEs;
+} Ring = { .FD = -1 };
+
+static int Ring_Initialized;
+
+static int
+Sysfs_Ring_Init(void)
+{
+	struct io_uring_params Params;
+	size_t SQ_Size, CQ_Size;
+	void *SQ, *CQ, *SQEs;
+	int FD;
+
+	(void) memset(&Params, 0, sizeof(Params));
+	FD = syscall(__NR_io_uring_setup, SYSFS_RING_ENTRIES, &Params);
+	if (FD < 0) {
+		SC_INFO("io_uring is not available, using pread: %m");
+		return -1;
+	}
+
+	SQ_Size = Params.sq_off.array + (Params.sq_entries * sizeof(unsigned int));
+	CQ_Size = Params.cq_off.cqes +
+		  (Params.cq_entries * sizeof(struct io_uring_cqe));
+	if (Params.features & IORING_FEAT_SINGLE_MMAP) {
+		SQ_Size = CQ_Size = ((SQ_Size > CQ_Size) ? SQ_Size : CQ_Size);
+	}
+
+	SQ = mmap(NULL, SQ_Size, (PROT_READ | PROT_WRITE),
+		  (MAP_SHARED | MAP_POPULATE), FD, IORING_OFF_SQ_RING);
+	CQ = ((Params.features & IORING_FEAT_SINGLE_MMAP) ? SQ :
+	      mmap(NULL, CQ_Size, (PROT_READ | PROT_WRITE),
+		   (MAP_SHARED | MAP_POPULATE), FD, IORING_OFF_CQ_RING));
+	SQEs = mmap(NULL, (Params.sq_entries * sizeof(struct io_uring_sqe)),
+		    (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_POPULATE), FD,
+		    IORING_OFF_SQES);
+	if (SQ == MAP_FAILED || CQ == MAP_FAILED || SQEs == MAP_FAILED) {
+		SC_INFO("failed to map io_uring, using pread: %m");
+		(void) close(FD);
+		return -1;
+	}
+
+	Ring.Entries = Params.sq_entries;
+	Ring.SQ_Tail = (unsigned int *)((char *)SQ + Params.sq_off.tail);
+	Ring.SQ_Mask = (unsigned int *)((char *)SQ + Params.sq_off.ring_mask);
+	Ring.SQ_Array = (unsigned int *)((char *)SQ + Params.sq_off.array);
+	Ring.SQEs = (struct io_uring_sqe *)SQEs;
+	Ring.CQ_Head = (unsigned int *)((char *)CQ + Params.cq_off.head);
+	Ring.CQ_Tail = (unsigned int *)((char *)CQ + Params.cq_off.tail);
+	Ring.CQ_Mask = (unsigned int *)((char *)CQ + Params.cq_off.ring_mask);
+	Ring.CQEs = (struct io_uring_cqe *)((char *)CQ + Params.cq_off.cqes);
+	Ring.FD = FD;
+	return 0;
+}
+
+/*
+ * Read up to Ring.Entries attributes with one submission.  Attributes whose
+ * read is rejected by io_uring are left with Count of -EINVAL for pread.
+ */
+static int
+Sysfs_Ring_Read(Sysfs_Attr_t *Attrs, struct iovec *IOVs, int Numbers)
+{
+	struct io_uring_sqe *SQE;
+	struct io_uring_cqe *CQE;
+	unsigned int Tail, Head;
+	int Submitted = 0, Done = 0;
+
+	Tail = *Ring.SQ_Tail;
+	for (int i = 0; i < Numbers; i++) {
+		if (Attrs[i].FD < 0) {
+			continue;
+		}
+
+		IOVs[i].iov_base = Attrs[i].Buffer;
+		IOVs[i].iov_len = Attrs[i].Length - 1;
+		SQE = &Ring.SQEs[Tail & *Ring.SQ_Mask];
+		(void) memset(SQE, 0, sizeof(*SQE));
+		SQE->opcode = IORING_OP_READV;
+		SQE->fd = Attrs[i].FD;
+		SQE->addr = (unsigned long)&IOVs[i];
+		SQE->len = 1;
+		SQE->off = 0;
+		SQE->user_data = i;
+		Ring.SQ_Array[Tail & *Ring.SQ_Mask] = (Tail & *Ring.SQ_Mask);
+		Tail++;
+		Submitted++;
+	}
+
+	if (Submitted == 0) {
+		return 0;
+	}
+
+	__atomic_store_n(Ring.SQ_Tail, Tail, __ATOMIC_RELEASE);
+	if (syscall(__NR_io_uring_enter, Ring.FD, Submitted, Submitted,
+		    IORING_ENTER_GETEVENTS, NULL, 0) < 0) {
+		SC_INFO("failed to submit to io_uring: %m");
+		return -1;
+	}
+
+	while (Done < Submitted) {
+		Head = *Ring.CQ_Head;
+		if (Head == __atomic_load_n(Ring.CQ_Tail, __ATOMIC_ACQUIRE)) {
+			if (syscall(__NR_io_uring_enter, Ring.FD, 0, 1,
+				    IORING_ENTER_GETEVENTS, NULL, 0) < 0) {
+				return -1;
+			}
+
+			continue;
+		}
+
+		CQE = &Ring.CQEs[Head & *Ring.CQ_Mask];
+		Attrs[CQE->user_data].Count = CQE->res;
+		__atomic_store_n(Ring.CQ_Head, Head + 1, __ATOMIC_RELEASE);
+		Done++;
+	}
+
+	return 0;
+}
+#endif
+
+/*
+ * Return the persistent FD of 'Path'.
+ */
+static int
+Sysfs_Open(const char *Path)
+{
+	int FD;
+
+	for (int i = 0; i < Sysfs_FD_Numbers; i++) {
+		if (strcmp(Sysfs_FDs[i].Path, Path) == 0) {
+			return Sysfs_FDs[i].FD;
+		}
+	}
+
+	if (Sysfs_FD_Numbers == SYSFS_FDS_MAX) {
+		SC_INFO("too many sysfs attributes to keep open for %s", Path);
+		return -1;
+	}
+
+	FD = open(Path, (O_RDONLY | O_CLOEXEC));
+	if (FD < 0) {
+		return FD;
+	}
+
+	Sysfs_FDs[Sysfs_FD_Numbers].Path = strdup(Path);
+	if (Sysfs_FDs[Sysfs_FD_Numbers].Path == NULL) {
+		(void) close(FD);
+		return -1;
+	}
+
+	Sysfs_FDs[Sysfs_FD_Numbers++].FD = FD;
+	return FD;
+}
+
+/*
+ * Read 'Numbers' attributes.  Each attribute is given by its 'Path', or by
+ * an already open 'FD' if 'Path' is NULL.  Up to 'Length' - 1 bytes are read
+ * into 'Buffer', which is always NUL terminated.  'Count' is set to the
+ * number of bytes read, or to -errno.  Returns 0 if all reads succeed.
+ */
+int
+Sysfs_Read(Sysfs_Attr_t *Attrs, int Numbers)
+{
+	struct iovec IOVs[SYSFS_RING_ENTRIES];
+	int Ret = 0;
+
+	(void) pthread_mutex_lock(&Sysfs_Lock);
+	for (int i = 0; i < Numbers; i++) {
+		if (Attrs[i].Path != NULL) {
+			Attrs[i].FD = Sysfs_Open(Attrs[i].Path);
+		}
+
+		Attrs[i].Count = ((Attrs[i].FD < 0) ? -ENOENT : -EINVAL);
+	}
+
+#ifdef __NR_io_uring_setup
+	if (!Ring_Initialized) {
+		Ring_Initialized = 1;
+		(void) Sysfs_Ring_Init();
+	}
+
+	for (int i = 0; Ring.FD >= 0 && Numbers > 1 && i < Numbers;
+	     i += Ring.Entries) {
+		if (Sysfs_Ring_Read(&Attrs[i], IOVs, (((Numbers - i) < (int)Ring.Entries) ?
+				    (Numbers - i) : (int)Ring.Entries)) != 0) {
+			(void) close(Ring.FD);
+			Ring.FD = -1;
+		}
+	}
+#else
+	(void) IOVs;
+#endif
+
+	for (int i = 0; i < Numbers; i++) {
+		/* Serve what io_uring did not, e.g. files without read_iter */
+		if (Attrs[i].FD >= 0 && Attrs[i].Count == -EINVAL) {
+			Attrs[i].Count = pread(Attrs[i].FD, Attrs[i].Buffer,
+					       Attrs[i].Length - 1, 0);
+			if (Attrs[i].Count < 0) {
+				Attrs[i].Count = -errno;
+			}
+		}
+
+		if (Attrs[i].Count < 0) {
+			errno = -Attrs[i].Count;
+			SC_INFO("failed to read %s: %m", ((Attrs[i].Path != NULL) ?
+				Attrs[i].Path : "attribute"));
+			Attrs[i].Buffer[0] = '\0';
+			Ret = -1;
+			continue;
+		}
+
+		Attrs[i].Buffer[Attrs[i].Count] = '\0';
+	}
+
+	(void) pthread_mutex_unlock(&Sysfs_Lock);
+	return Ret;
+}